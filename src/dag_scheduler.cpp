@@ -0,0 +1,206 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "dag_scheduler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::he {
+
+DAGScheduler::DAGScheduler(size_t task_count)
+    : m_dependents(task_count),
+      m_dependency_counts(task_count, 0),
+      m_exclusive(task_count, false) {}
+
+void DAGScheduler::add_dependency(size_t task_idx, size_t dependency_idx) {
+  NGRAPH_CHECK(task_idx < task_count() && dependency_idx < task_count(),
+               "Task index out of range");
+  // Tasks only depend on earlier tasks, so the graph is acyclic
+  NGRAPH_CHECK(dependency_idx < task_idx, "Task ", task_idx,
+               " cannot depend on later task ", dependency_idx);
+  m_dependents[dependency_idx].emplace_back(task_idx);
+  ++m_dependency_counts[task_idx];
+}
+
+void DAGScheduler::set_exclusive(size_t task_idx) {
+  NGRAPH_CHECK(task_idx < task_count(), "Task index out of range");
+  m_exclusive[task_idx] = true;
+}
+
+namespace {
+using ReadyQueue =
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<>>;
+}  // namespace
+
+/// \brief State of a run, shared with the helpers posted to the task runtime.
+/// Helpers may start after the run has returned, in which case they find no
+/// ready task, and return without touching the scheduler or the task function
+struct DAGScheduler::Run : std::enable_shared_from_this<Run> {
+  Run(const DAGScheduler& run_scheduler, std::function<void(size_t)> run_task,
+      size_t run_thread_count, TaskRuntime& run_runtime)
+      : scheduler(run_scheduler),
+        task(std::move(run_task)),
+        thread_count(std::max<size_t>(run_thread_count, 1)),
+        thread_budget(TaskRuntime::thread_budget()),
+        runtime(run_runtime),
+        dependency_counts(run_scheduler.m_dependency_counts) {
+    for (size_t task_idx = 0; task_idx < dependency_counts.size();
+         ++task_idx) {
+      if (dependency_counts[task_idx] == 0) {
+        ready_tasks.push(task_idx);
+      }
+    }
+  }
+
+  bool done() const {
+    return finished_count == dependency_counts.size() ||
+           (error && running_count == 0);
+  }
+
+  /// \brief Takes the lowest ready task which may run. Requires the mutex
+  bool take_task(size_t& task_idx, bool& exclusive) {
+    while (!error && running_count < thread_count) {
+      if (!exclusive_running && !ready_exclusive_tasks.empty() &&
+          (ready_tasks.empty() ||
+           ready_exclusive_tasks.top() < ready_tasks.top())) {
+        task_idx = ready_exclusive_tasks.top();
+        ready_exclusive_tasks.pop();
+        exclusive = true;
+        return true;
+      }
+      if (ready_tasks.empty()) {
+        return false;
+      }
+      task_idx = ready_tasks.top();
+      ready_tasks.pop();
+      exclusive = scheduler.m_exclusive[task_idx];
+      if (!exclusive || !exclusive_running) {
+        return true;
+      }
+      // Exclusive tasks wait here while another exclusive task runs
+      ready_exclusive_tasks.push(task_idx);
+    }
+    return false;
+  }
+
+  /// \brief Runs ready tasks until none may run. Requires the mutex, which
+  /// is released while tasks run
+  void run_ready_tasks(std::unique_lock<std::mutex>& lock) {
+    size_t task_idx;
+    bool exclusive;
+    while (take_task(task_idx, exclusive)) {
+      exclusive_running = exclusive_running || exclusive;
+      ++running_count;
+      lock.unlock();
+
+      std::exception_ptr task_error;
+      try {
+        task(task_idx);
+      } catch (...) {
+        task_error = std::current_exception();
+      }
+
+      lock.lock();
+      --running_count;
+      if (exclusive) {
+        exclusive_running = false;
+      }
+      if (task_error) {
+        if (!error) {
+          error = task_error;
+        }
+      } else {
+        ++finished_count;
+        for (size_t dependent_idx : scheduler.m_dependents[task_idx]) {
+          if (--dependency_counts[dependent_idx] == 0) {
+            ready_tasks.push(dependent_idx);
+          }
+        }
+      }
+      post_helpers();
+      finished_cond.notify_all();
+    }
+  }
+
+  /// \brief Posts helpers to run the ready tasks the running threads cannot
+  /// take. Requires the mutex
+  void post_helpers() {
+    if (error) {
+      return;
+    }
+    size_t ready_count = ready_tasks.size() + ready_exclusive_tasks.size();
+    while (helper_count + 1 < thread_count && helper_count < ready_count) {
+      ++helper_count;
+      runtime.post([run = shared_from_this()]() { run->help(); });
+    }
+  }
+
+  /// \brief Runs ready tasks on a worker of the task runtime
+  void help() {
+    TaskRuntime::ThreadBudgetScope budget_scope(thread_budget);
+    std::unique_lock<std::mutex> lock(mutex);
+    run_ready_tasks(lock);
+    --helper_count;
+  }
+
+  const DAGScheduler& scheduler;
+  const std::function<void(size_t)> task;
+  const size_t thread_count;
+  const size_t thread_budget;
+  TaskRuntime& runtime;
+
+  std::mutex mutex;
+  std::condition_variable finished_cond;
+  std::vector<size_t> dependency_counts;
+  ReadyQueue ready_tasks;
+  ReadyQueue ready_exclusive_tasks;
+  size_t finished_count{0};
+  size_t running_count{0};
+  // Number of helpers posted and not yet returned
+  size_t helper_count{0};
+  bool exclusive_running{false};
+  std::exception_ptr error;
+};
+
+void DAGScheduler::run(const std::function<void(size_t)>& task,
+                       size_t thread_count, TaskRuntime& runtime) const {
+  auto run = std::make_shared<Run>(*this, task, thread_count, runtime);
+  std::unique_lock<std::mutex> lock(run->mutex);
+  run->post_helpers();
+  // Helpers only run tasks while workers are idle, so the calling thread runs
+  // tasks until all have finished
+  while (true) {
+    run->run_ready_tasks(lock);
+    if (run->done()) {
+      break;
+    }
+    run->finished_cond.wait(lock);
+  }
+  if (run->error) {
+    std::rethrow_exception(run->error);
+  }
+}
+
+}  // namespace ngraph::he
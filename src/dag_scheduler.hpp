@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "task_runtime.hpp"
+
+namespace ngraph::he {
+/// \brief Runs tasks with dependencies between them on the workers of a task
+/// runtime.
+///
+/// A task is started once all its dependencies have finished. Of the ready
+/// tasks, the one with the lowest index is started first, so tasks added in
+/// topological order run close to that order, and in exactly that order on a
+/// single thread. Exclusive tasks never run concurrently with each other, but
+/// may run concurrently with other tasks. Ready tasks are posted to the
+/// runtime, whose workers take them once they have no loop to join, so tasks
+/// and the loops they run share the runtime's threads.
+class DAGScheduler {
+ public:
+  /// \brief Constructs a scheduler for tasks without dependencies
+  /// \param[in] task_count Number of tasks
+  explicit DAGScheduler(size_t task_count);
+
+  /// \brief Returns the number of tasks
+  size_t task_count() const { return m_dependents.size(); }
+
+  /// \brief Adds a dependency between two tasks
+  /// \param[in] task_idx Index of the dependent task
+  /// \param[in] dependency_idx Index of the task which must finish first
+  /// \throws ngraph_error if the dependency would form a cycle
+  void add_dependency(size_t task_idx, size_t dependency_idx);
+
+  /// \brief Marks a task as exclusive
+  /// \param[in] task_idx Index of the task
+  void set_exclusive(size_t task_idx);
+
+  /// \brief Runs every task once. The calling thread runs tasks until all
+  /// have finished, helped by idle workers of the runtime. If a task throws,
+  /// no further tasks are started, and the first exception is rethrown once
+  /// running tasks finish
+  /// \param[in] task Function called with the index of each task
+  /// \param[in] thread_count Maximum number of tasks to run concurrently
+  /// \param[in] runtime Task runtime whose workers help run tasks
+  void run(const std::function<void(size_t)>& task, size_t thread_count,
+           TaskRuntime& runtime = TaskRuntime::global()) const;
+
+ private:
+  struct Run;
+
+  std::vector<std::vector<size_t>> m_dependents;
+  std::vector<size_t> m_dependency_counts;
+  std::vector<bool> m_exclusive;
+};
+
+}  // namespace ngraph::he
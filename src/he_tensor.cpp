@@ -16,7 +16,9 @@
 
 #include "he_tensor.hpp"
 
+#include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/descriptor/tensor.hpp"
@@ -25,11 +27,22 @@
 #include "seal/seal_util.hpp"
 
 namespace ngraph::he {
+namespace {
+void check_chunk_index(const pb::HETensor& proto_tensor) {
+  // Tensors written without chunking have no chunk index or count
+  size_t chunk_count = std::max<size_t>(proto_tensor.chunk_count(), 1);
+  NGRAPH_CHECK(proto_tensor.chunk_index() < chunk_count,
+               "Invalid chunk index ", proto_tensor.chunk_index(), " of ",
+               chunk_count, " chunks");
+}
+}  // namespace
+
 HETensor::HETensor(
     const element::Type& element_type, const Shape& shape,
     bool plaintext_packing, bool complex_packing, bool encrypted,
     seal::CKKSEncoder& ckks_encoder, std::shared_ptr<seal::SEALContext> context,
-    const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+    std::shared_ptr<const seal::Encryptor> encryptor,
+    std::shared_ptr<seal::Decryptor> decryptor,
     const ngraph::he::HESealEncryptionParameters& encryption_params,
     const std::string& name)
     : ngraph::runtime::Tensor(std::make_shared<ngraph::descriptor::Tensor>(
@@ -37,8 +50,8 @@ HETensor::HETensor(
       m_packed(plaintext_packing),
       m_ckks_encoder(ckks_encoder),
       m_context(std::move(context)),
-      m_encryptor(encryptor),
-      m_decryptor(decryptor),
+      m_encryptor(std::move(encryptor)),
+      m_decryptor(std::move(decryptor)),
       m_encryption_params(encryption_params) {
   m_descriptor->set_tensor_layout(
       std::make_shared<ngraph::descriptor::layout::DenseTensorLayout>(
@@ -72,10 +85,107 @@ HETensor::HETensor(const element::Type& element_type, const Shape& shape,
                    const std::string& name)
     : HETensor(element_type, shape, plaintext_packing, complex_packing,
                encrypted, *he_seal_backend.get_ckks_encoder(),
-               he_seal_backend.get_context(), *he_seal_backend.get_encryptor(),
-               *he_seal_backend.get_decryptor(),
+               he_seal_backend.get_context(), he_seal_backend.get_encryptor(),
+               he_seal_backend.get_decryptor(),
                he_seal_backend.get_encryption_parameters(), name) {}
 
+HETensor::HETensor(const std::vector<std::shared_ptr<HETensor>>& sources,
+                   const std::shared_ptr<const IndexPlan>& plan,
+                   const element::Type& element_type, const Shape& shape,
+                   const std::string& name)
+    : ngraph::runtime::Tensor(std::make_shared<ngraph::descriptor::Tensor>(
+          element_type, shape, name)),
+      m_packed(sources.at(0)->is_packed()),
+      m_ckks_encoder(sources[0]->m_ckks_encoder),
+      m_context(sources[0]->m_context),
+      m_encryptor(sources[0]->m_encryptor),
+      m_decryptor(sources[0]->m_decryptor),
+      m_encryption_params(sources[0]->m_encryption_params) {
+  m_descriptor->set_tensor_layout(
+      std::make_shared<ngraph::descriptor::layout::DenseTensorLayout>(
+          *m_descriptor));
+  m_packed_shape = m_packed ? pack_shape(shape, 0) : shape;
+  NGRAPH_CHECK(plan != nullptr, "View has no index plan");
+  NGRAPH_CHECK(plan->output_count() == get_batched_element_count(),
+               "View index plan has ", plan->output_count(),
+               " outputs, expected ", get_batched_element_count());
+
+  // Sources which are views themselves are replaced by the tensors they view
+  struct ViewedSource {
+    size_t first_source;
+    std::shared_ptr<const IndexPlan> plan;
+  };
+  std::vector<ViewedSource> viewed_sources;
+  bool nested_views = false;
+  for (const auto& source : sources) {
+    NGRAPH_CHECK(source->is_packed() == m_packed,
+                 "View sources must have the same packing as the view");
+    std::vector<std::shared_ptr<HETensor>> source_sources;
+    std::shared_ptr<const IndexPlan> source_plan;
+    {
+      std::lock_guard<std::mutex> guard(source->m_view_mutex);
+      source_sources = source->m_view_sources;
+      source_plan = source->m_view_plan;
+    }
+    viewed_sources.push_back({m_view_sources.size(), source_plan});
+    if (source_plan == nullptr) {
+      m_view_sources.emplace_back(source);
+    } else {
+      nested_views = true;
+      m_view_sources.insert(m_view_sources.end(), source_sources.begin(),
+                            source_sources.end());
+    }
+  }
+
+  if (!nested_views) {
+    m_view_plan = plan;
+  } else {
+    std::vector<Shape> source_shapes;
+    for (const auto& source : m_view_sources) {
+      source_shapes.emplace_back(source->get_packed_shape());
+    }
+    auto composed_plan =
+        std::make_shared<IndexPlan>(std::move(source_shapes), m_packed_shape);
+    for (size_t out_idx = 0; out_idx < plan->output_count(); ++out_idx) {
+      const ViewedSource& viewed = viewed_sources[plan->gather_arg(out_idx)];
+      size_t source_idx = viewed.first_source;
+      size_t element_idx = plan->gather_index(out_idx);
+      if (viewed.plan != nullptr) {
+        source_idx += viewed.plan->gather_arg(element_idx);
+        element_idx = viewed.plan->gather_index(element_idx);
+      }
+      if (m_view_sources.size() == 1) {
+        composed_plan->add_entry(element_idx);
+      } else {
+        composed_plan->add_gather_entry(element_idx, source_idx);
+      }
+      composed_plan->end_output();
+    }
+    m_view_plan = std::move(composed_plan);
+  }
+  m_is_view.store(true, std::memory_order_release);
+}
+
+void HETensor::materialize_view() const {
+  std::lock_guard<std::mutex> guard(m_view_mutex);
+  if (!m_is_view.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::vector<const std::vector<HEType>*> source_data;
+  for (const auto& source : m_view_sources) {
+    source_data.emplace_back(&source->data());
+  }
+  m_data.clear();
+  m_data.reserve(m_view_plan->output_count());
+  for (size_t out_idx = 0; out_idx < m_view_plan->output_count(); ++out_idx) {
+    m_data.emplace_back((*source_data[m_view_plan->gather_arg(
+        out_idx)])[m_view_plan->gather_index(out_idx)]);
+  }
+  m_view_sources.clear();
+  m_view_plan = nullptr;
+  m_is_view.store(false, std::memory_order_release);
+}
+
 ngraph::Shape HETensor::pack_shape(const ngraph::Shape& shape,
                                    size_t pack_axis) {
   if (pack_axis != 0) {
@@ -153,11 +263,74 @@ uint64_t HETensor::batch_size(const Shape& shape, bool packed) {
 }
 
 bool HETensor::any_encrypted_data() const {
+  materialize();
   return std::any_of(m_data.begin(), m_data.end(), [](const HEType& he_type) {
     return he_type.is_ciphertext();
   });
 }
 
+void HETensor::use_slab_storage(seal::parms_id_type parms_id) {
+  materialize();
+  auto context_data = m_context->get_context_data(parms_id);
+  NGRAPH_CHECK(context_data != nullptr,
+               "Slab parms_id is not valid for context");
+  const auto& parms = context_data->parms();
+  size_t cipher_byte_count = 2 * parms.poly_modulus_degree() *
+                             parms.coeff_modulus().size() * sizeof(uint64_t);
+  size_t cipher_count = std::count_if(
+      m_data.begin(), m_data.end(),
+      [](const HEType& he_type) { return he_type.is_ciphertext(); });
+  if (cipher_count == 0) {
+    return;
+  }
+
+  m_slab = std::make_shared<SealCiphertextSlab>(cipher_byte_count,
+                                                cipher_count);
+  seal::MemoryPoolHandle slab_pool(m_slab);
+  for (auto& he_type : m_data) {
+    if (he_type.is_ciphertext()) {
+      // Storage is taken from the slab when the ciphertext is first written
+      he_type.set_ciphertext(
+          std::make_shared<SealCiphertextWrapper>(seal::Ciphertext(slab_pool)));
+    }
+  }
+}
+
+void HETensor::use_image_packing(size_t row_stride) {
+  materialize();
+  const Shape& shape = get_shape();
+  NGRAPH_CHECK(shape.size() == 4 && shape[0] == 1,
+               "Image packing requires shape (1, C, rows, columns), got ",
+               shape);
+  NGRAPH_CHECK(row_stride >= shape[3], "Row stride ", row_stride,
+               " is smaller than the image width ", shape[3]);
+  if (m_image_row_stride == row_stride) {
+    return;
+  }
+
+  bool encrypted = any_encrypted_data();
+  NGRAPH_CHECK(m_data.empty() || !m_data[0].complex_packing(),
+               "Image packing does not support complex packing");
+  size_t channel_slots = shape[2] * row_stride;
+  std::vector<HEType> new_data;
+  new_data.reserve(shape[1]);
+  for (size_t channel = 0; channel < shape[1]; ++channel) {
+    if (encrypted) {
+      new_data.emplace_back(HESealBackend::create_empty_ciphertext(), false,
+                            channel_slots);
+    } else {
+      new_data.emplace_back(HEPlaintext(channel_slots), false);
+    }
+  }
+  m_data = std::move(new_data);
+  // The image has batch size 1, so batch-axis packing is dropped
+  m_packed = false;
+  m_packed_shape = Shape{1, shape[1], 1, 1};
+  m_image_row_stride = row_stride;
+  m_write_count = 0;
+  m_slab = nullptr;
+}
+
 void HETensor::check_io_bounds(size_t n) const {
   const element::Type& element_type = get_tensor_layout()->get_element_type();
   size_t type_byte_size = element_type.size();
@@ -173,22 +346,17 @@ void HETensor::check_io_bounds(size_t n) const {
 }
 
 void HETensor::write(const void* p, size_t n) {
+  materialize();
   check_io_bounds(n / get_batch_size());
   const element::Type& element_type = get_tensor_layout()->get_element_type();
   size_t type_byte_size = element_type.size();
   size_t num_elements_to_write = n / (element_type.size() * get_batch_size());
+  NGRAPH_CHECK(m_encryptor != nullptr || !any_encrypted_data(),
+               "Cannot write to encrypted tensor without an encryptor");
+  std::shared_ptr<seal::SEALContext> seeded_context =
+      m_seeded_encryption ? m_context : nullptr;
 
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_write; ++i) {
-    HEPlaintext plain(get_batch_size());
-    for (size_t j = 0; j < get_batch_size(); ++j) {
-      const auto* src = static_cast<const void*>(
-          static_cast<const char*>(p) +
-          type_byte_size * (i + j * num_elements_to_write));
-      plain[j] = type_to_double(src, element_type);
-    }
-
+  auto write_element = [&](size_t i, const HEPlaintext& plain) {
     if (m_data[i].is_plaintext()) {
       m_data[i].set_plaintext(plain);
     } else if (m_data[i].is_ciphertext()) {
@@ -196,17 +364,51 @@ void HETensor::write(const void* p, size_t n) {
 
       ngraph::he::encrypt(cipher, plain, m_context->first_parms_id(),
                           element_type, m_encryption_params.scale(),
-                          m_ckks_encoder, m_encryptor,
-                          m_data[i].complex_packing());
+                          m_ckks_encoder, *m_encryptor,
+                          m_data[i].complex_packing(), seeded_context);
       m_data[i].set_ciphertext(cipher);
     } else {
       NGRAPH_CHECK(false, "Cannot write into tensor of unspecified type");
     }
+  };
+
+  if (is_image_packed()) {
+    NGRAPH_CHECK(n == get_element_count() * type_byte_size,
+                 "Image packed tensors must be written whole");
+    size_t channel_size = get_element_count() / m_data.size();
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t channel = 0; channel < m_data.size(); ++channel) {
+      HEPlaintext plain(get_shape()[2] * m_image_row_stride);
+      for (size_t channel_idx = 0; channel_idx < channel_size; ++channel_idx) {
+        const auto* src = static_cast<const void*>(
+            static_cast<const char*>(p) +
+            type_byte_size * (channel * channel_size + channel_idx));
+        plain[image_slot(channel_idx)] = type_to_double(src, element_type);
+      }
+      write_element(channel, plain);
+    }
+    m_write_count += m_data.size();
+    return;
+  }
+
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t i = 0; i < num_elements_to_write; ++i) {
+    HEPlaintext plain(get_batch_size());
+    for (size_t j = 0; j < get_batch_size(); ++j) {
+      const auto* src = static_cast<const void*>(
+          static_cast<const char*>(p) +
+          type_byte_size * (i + j * num_elements_to_write));
+      plain[j] = type_to_double(src, element_type);
+    }
+    write_element(i, plain);
   }
   m_write_count += num_elements_to_write;
 }
 
 void HETensor::read(void* p, size_t n) const {
+  materialize();
   check_io_bounds(n / get_batch_size());
   const element::Type& element_type = get_tensor_layout()->get_element_type();
   size_t type_byte_size = element_type.size();
@@ -224,18 +426,45 @@ void HETensor::read(void* p, size_t n) const {
       src += type_byte_size;
     }
   };
+  NGRAPH_CHECK(m_decryptor != nullptr || !any_encrypted_data(),
+               "Cannot read encrypted tensor without a decryptor");
 
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_read; ++i) {
-    HEPlaintext plain;
+  auto read_element = [&](size_t i, HEPlaintext& plain) {
     if (m_data[i].is_ciphertext()) {
       ngraph::he::decrypt(plain, *m_data[i].get_ciphertext(),
-                          m_data[i].complex_packing(), m_decryptor,
+                          m_data[i].complex_packing(), *m_decryptor,
                           m_ckks_encoder);
     } else {
       plain = m_data[i].get_plaintext();
     }
+  };
+
+  if (is_image_packed()) {
+    NGRAPH_CHECK(n == get_element_count() * type_byte_size,
+                 "Image packed tensors must be read whole");
+    size_t channel_size = get_element_count() / m_data.size();
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t channel = 0; channel < m_data.size(); ++channel) {
+      HEPlaintext plain;
+      read_element(channel, plain);
+      HEPlaintext image_values(channel_size);
+      for (size_t channel_idx = 0; channel_idx < channel_size; ++channel_idx) {
+        size_t slot = image_slot(channel_idx);
+        image_values[channel_idx] = plain.size() == 1 ? plain[0] : plain[slot];
+      }
+      image_values.write(static_cast<char*>(p) +
+                             type_byte_size * channel * channel_size,
+                         element_type);
+    }
+    return;
+  }
+
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t i = 0; i < num_elements_to_read; ++i) {
+    HEPlaintext plain;
+    read_element(i, plain);
 
     void* dst = ngraph::ngraph_malloc(type_byte_size * get_batch_size());
     plain.resize(get_batch_size());
@@ -247,98 +476,151 @@ void HETensor::read(void* p, size_t n) const {
   }
 }
 
-void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors) const {
-  // Populate attributes of tensor to estimate byte size
-  proto_tensors.resize(1);
-  proto_tensors[0].set_name(get_name());
-  proto_tensors[0].set_packed(m_packed);
-  proto_tensors[0].set_offset(0);
+void HETensor::write_to_proto_chunks(const ProtoChunkWriter& write_chunk,
+                                     bool attach_ciphertexts,
+                                     size_t max_chunk_bytes) const {
+  materialize();
+  NGRAPH_HE_LOG(5) << "Writing tensor shape " << get_shape();
+
   std::vector<uint64_t> int_shape{get_shape()};
-  *proto_tensors[0].mutable_shape() = {int_shape.begin(), int_shape.end()};
+  auto create_chunk = [&](size_t offset, size_t chunk_index,
+                          size_t chunk_count) {
+    pb::HETensor proto_tensor;
+    proto_tensor.set_name(get_name());
+    proto_tensor.set_packed(m_packed);
+    proto_tensor.set_offset(offset);
+    proto_tensor.set_chunk_index(chunk_index);
+    proto_tensor.set_chunk_count(chunk_count);
+    proto_tensor.set_image_row_stride(m_image_row_stride);
+    *proto_tensor.mutable_shape() = {int_shape.begin(), int_shape.end()};
+    return proto_tensor;
+  };
 
-  NGRAPH_HE_LOG(5) << "Writing tensor shape " << get_shape();
+  if (attach_ciphertexts) {
+    // Only ciphertext metadata is serialized, so one chunk suffices
+    auto proto_tensor = create_chunk(0, 0, 1);
+    std::vector<std::shared_ptr<SealCiphertextWrapper>> ciphertexts;
+    std::vector<size_t> attachment_indices(m_data.size(), 0);
+    std::vector<bool> attached(m_data.size(), false);
+    for (size_t data_idx = 0; data_idx < m_data.size(); ++data_idx) {
+      if (m_data[data_idx].is_ciphertext() &&
+          !m_data[data_idx].get_ciphertext()->is_seeded()) {
+        attachment_indices[data_idx] = ciphertexts.size();
+        attached[data_idx] = true;
+        ciphertexts.emplace_back(m_data[data_idx].get_ciphertext());
+      }
+    }
+    auto* mutable_data = proto_tensor.mutable_data();
+    for (size_t data_idx = 0; data_idx < m_data.size(); ++data_idx) {
+      mutable_data->Add();
+    }
+
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t data_idx = 0; data_idx < m_data.size(); ++data_idx) {
+      if (attached[data_idx]) {
+        m_data[data_idx].save_attached(*mutable_data->Mutable(data_idx),
+                                       attachment_indices[data_idx]);
+      } else {
+        m_data[data_idx].save(*mutable_data->Mutable(data_idx),
+                              m_ciphertext_codec);
+      }
+    }
+    write_chunk(std::move(proto_tensor), std::move(ciphertexts));
+    return;
+  }
 
-  if (!m_data.empty()) {
-    pb::HEType tmp_type;
-    m_data[0].save(tmp_type);
+  if (m_data.empty()) {
+    write_chunk(create_chunk(0, 0, 1), {});
+    return;
+  }
 
-    size_t he_type_size = tmp_type.ByteSize();
-    size_t max_num_data_per_tensor =
-        std::floor(std::numeric_limits<int32_t>::max() /
-                   static_cast<float>(he_type_size)) -
-        2;
+  pb::HEType tmp_type;
+  m_data[0].save(tmp_type, m_ciphertext_codec);
 
-    size_t num_tensors = m_data.size() / max_num_data_per_tensor;
-    if (m_data.size() % max_num_data_per_tensor != 0) {
-      num_tensors++;
+  // Protobufs are limited to 2GB
+  size_t max_bytes = std::min(
+      max_chunk_bytes,
+      static_cast<size_t>(std::numeric_limits<int32_t>::max() / 2));
+  size_t he_type_size = tmp_type.ByteSize();
+  size_t max_num_data_per_chunk = std::max<size_t>(max_bytes / he_type_size, 1);
+
+  size_t num_chunks = m_data.size() / max_num_data_per_chunk;
+  if (m_data.size() % max_num_data_per_chunk != 0) {
+    num_chunks++;
+  }
+  NGRAPH_HE_LOG(5) << "Writing tensor in " << num_chunks << " chunks of "
+                   << max_num_data_per_chunk << " elements";
+
+  size_t offset = 0;
+  for (size_t chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
+    auto proto_tensor = create_chunk(offset, chunk_idx, num_chunks);
+
+    auto* mutable_data = proto_tensor.mutable_data();
+    size_t num_data_in_chunk =
+        std::min(max_num_data_per_chunk, m_data.size() - offset);
+    for (size_t data_idx = 0; data_idx < num_data_in_chunk; ++data_idx) {
+      mutable_data->Add();
     }
-    proto_tensors.resize(num_tensors);
-
-    size_t offset = 0;
-
-    for (size_t tensor_idx = 0; tensor_idx < num_tensors; ++tensor_idx) {
-      proto_tensors[tensor_idx].set_name(get_name());
-      proto_tensors[tensor_idx].set_packed(m_packed);
-      proto_tensors[tensor_idx].set_offset(offset);
-      *proto_tensors[tensor_idx].mutable_shape() = {int_shape.begin(),
-                                                    int_shape.end()};
-
-      auto* mutable_data = proto_tensors[tensor_idx].mutable_data();
-      size_t num_data_in_tensor = max_num_data_per_tensor;
-      if (tensor_idx == num_tensors - 1) {
-        num_data_in_tensor =
-            m_data.size() - tensor_idx * max_num_data_per_tensor;
-      }
-      for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
-        mutable_data->Add();
-      }
 
 #pragma omp parallel for
-      // NOLINTNEXTLINE
-      for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
-        size_t data_offset = offset + data_idx;
-        m_data[data_offset].save(*mutable_data->Mutable(data_idx));
-      }
-      offset += num_data_in_tensor;
+    // NOLINTNEXTLINE
+    for (size_t data_idx = 0; data_idx < num_data_in_chunk; ++data_idx) {
+      size_t data_offset = offset + data_idx;
+      m_data[data_offset].save(*mutable_data->Mutable(data_idx),
+                               m_ciphertext_codec);
     }
+    offset += num_data_in_chunk;
+
+    write_chunk(std::move(proto_tensor), {});
   }
 }
 
+void HETensor::write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                               size_t max_chunk_bytes) const {
+  proto_tensors.clear();
+  write_to_proto_chunks(
+      [&](pb::HETensor&& proto_tensor,
+          std::vector<std::shared_ptr<SealCiphertextWrapper>>&&) {
+        proto_tensors.emplace_back(std::move(proto_tensor));
+      },
+      false, max_chunk_bytes);
+}
+
 std::shared_ptr<HETensor> HETensor::load_from_proto_tensors(
     const std::vector<pb::HETensor>& proto_tensors,
     seal::CKKSEncoder& ckks_encoder,
     const std::shared_ptr<seal::SEALContext>& context,
-    const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-    const ngraph::he::HESealEncryptionParameters& encryption_params) {
-  NGRAPH_CHECK(proto_tensors.size() == 1,
-               "Load from protos only supports 1 proto");
+    const std::shared_ptr<const seal::Encryptor>& encryptor,
+    const std::shared_ptr<seal::Decryptor>& decryptor,
+    const ngraph::he::HESealEncryptionParameters& encryption_params,
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts) {
+  NGRAPH_CHECK(!proto_tensors.empty(), "No proto tensors to load from");
 
   const auto& proto_tensor = proto_tensors[0];
   const auto& proto_name = proto_tensor.name();
   const auto& proto_packed = proto_tensor.packed();
   const auto& proto_shape = proto_tensor.shape();
-  size_t result_count = proto_tensor.data_size();
   ngraph::Shape shape{proto_shape.begin(), proto_shape.end()};
 
   auto he_tensor = std::make_shared<HETensor>(
       element::f64, shape, proto_packed, encryption_params.complex_packing(),
       false, ckks_encoder, context, encryptor, decryptor, encryption_params,
       proto_name);
-
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    const auto& loaded = HEType::load(proto_tensor.data(result_idx), context);
-    he_tensor->data(result_idx) = loaded;
+  if (proto_tensor.image_row_stride() != 0) {
+    he_tensor->use_image_packing(proto_tensor.image_row_stride());
   }
-  he_tensor->m_write_count += result_count;
 
+  for (const auto& chunk : proto_tensors) {
+    load_from_proto_tensor(he_tensor, chunk, context, ciphertexts);
+  }
   return he_tensor;
 }
 
 void HETensor::load_from_proto_tensor(
     std::shared_ptr<HETensor>& he_tensor, const pb::HETensor& proto_tensor,
-    const std::shared_ptr<seal::SEALContext>& context) {
+    const std::shared_ptr<seal::SEALContext>& context,
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts) {
   const auto& proto_name = proto_tensor.name();
   const auto& proto_packed = proto_tensor.packed();
   const auto& proto_shape = proto_tensor.shape();
@@ -354,14 +636,41 @@ void HETensor::load_from_proto_tensor(
   NGRAPH_CHECK(he_tensor->is_packed() == proto_packed,
                "HETensor has wrong packing ", he_tensor->is_packed(),
                ", expected ", proto_packed);
+  NGRAPH_CHECK(he_tensor->image_row_stride() ==
+                   proto_tensor.image_row_stride(),
+               "HETensor has wrong image row stride ",
+               he_tensor->image_row_stride(), ", expected ",
+               proto_tensor.image_row_stride());
+  check_chunk_index(proto_tensor);
+  NGRAPH_CHECK(proto_offset + result_count <= he_tensor->data().size(),
+               "Chunk with offset ", proto_offset, " and ", result_count,
+               " elements exceeds tensor size ", he_tensor->data().size());
 
 #pragma omp parallel for
   // NOLINTNEXTLINE
   for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    const auto& loaded = HEType::load(proto_tensor.data(result_idx), context);
+    const auto& loaded =
+        HEType::load(proto_tensor.data(result_idx), context, ciphertexts);
     he_tensor->data(proto_offset + result_idx) = loaded;
   }
   he_tensor->m_write_count += result_count;
 }
 
+std::vector<HEType> HETensor::load_proto_chunk(
+    const pb::HETensor& proto_tensor,
+    const std::shared_ptr<seal::SEALContext>& context,
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts) {
+  check_chunk_index(proto_tensor);
+  size_t result_count = proto_tensor.data_size();
+  std::vector<HEType> chunk(result_count, HEType(HEPlaintext(), false));
+
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+    chunk[result_idx] =
+        HEType::load(proto_tensor.data(result_idx), context, ciphertexts);
+  }
+  return chunk;
+}
+
 }  // namespace ngraph::he
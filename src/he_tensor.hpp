@@ -16,14 +16,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "he_plaintext.hpp"
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/runtime/tensor.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/seal_ciphertext_codec.hpp"
+#include "seal/seal_ciphertext_slab.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 
 namespace ngraph::he {
@@ -42,8 +49,10 @@ class HETensor : public runtime::Tensor {
   /// \param[in] encrypted Whether or not tensor is initialized with ciphertexts
   /// \param[in] ckks_encoder CKKS encoder to associate with loaded tensor
   /// \param[in] context SEAL context to associate with loaded tensor
-  /// \param[in] encryptor SEAL encryptor to associate with loaded tensor
-  /// \param[in] decryptor SEAL decryptor to associate with loaded tensor
+  /// \param[in] encryptor SEAL encryptor to associate with loaded tensor. May
+  /// be nullptr if the tensor is never written
+  /// \param[in] decryptor SEAL decryptor to associate with loaded tensor. May
+  /// be nullptr if the tensor is never read
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
   /// \param[in] name Name of the tensor
@@ -51,7 +60,8 @@ class HETensor : public runtime::Tensor {
            bool plaintext_packing, bool complex_packing, bool encrypted,
            seal::CKKSEncoder& ckks_encoder,
            std::shared_ptr<seal::SEALContext> context,
-           const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+           std::shared_ptr<const seal::Encryptor> encryptor,
+           std::shared_ptr<seal::Decryptor> decryptor,
            const ngraph::he::HESealEncryptionParameters& encryption_params,
            const std::string& name = "external");
 
@@ -70,6 +80,23 @@ class HETensor : public runtime::Tensor {
            const HESealBackend& he_seal_backend,
            const std::string& name = "external");
 
+  /// \brief Constructs a view of the elements of other tensors. Element i of
+  /// the view is element plan->gather_index(i) of source
+  /// plan->gather_arg(i). Elements are gathered only once the view's data is
+  /// first accessed, and views of views gather from the underlying tensors
+  /// directly, so chains of data-movement ops copy each element at most once
+  /// \param[in] sources Tensors viewed. Must not be written to while the view
+  /// is unmaterialized
+  /// \param[in] plan Index plan over the packed shapes of the sources, with
+  /// one entry per output
+  /// \param[in] element_type Datatype of data stored in the tensor
+  /// \param[in] shape Shape of tensor
+  /// \param[in] name Name of the tensor
+  HETensor(const std::vector<std::shared_ptr<HETensor>>& sources,
+           const std::shared_ptr<const IndexPlan>& plan,
+           const element::Type& element_type, const Shape& shape,
+           const std::string& name);
+
   /// \brief Write bytes directly into the tensor
   /// \param[in] p Pointer to source of data
   /// \param[in] n Number of bytes to write, must be integral number of elements
@@ -102,20 +129,69 @@ class HETensor : public runtime::Tensor {
   /// \throws ngraph_error if tensor contains any encrypted data
   void unpack();
 
-  const std::vector<HEType>& data() const { return m_data; }
+  const std::vector<HEType>& data() const {
+    materialize();
+    return m_data;
+  }
+
+  std::vector<HEType>& data() {
+    materialize();
+    return m_data;
+  }
+
+  HEType& data(size_t i) {
+    materialize();
+    return m_data[i];
+  }
 
-  std::vector<HEType>& data() { return m_data; }
+  /// \brief Returns whether or not the tensor is a view whose elements have
+  /// not been gathered yet
+  bool is_view() const { return m_is_view.load(std::memory_order_acquire); }
 
-  HEType& data(size_t i) { return m_data[i]; }
+  /// \brief Gathers the elements of a view into the tensor, and releases the
+  /// viewed tensors. Does nothing if the tensor is not a view
+  void materialize() const {
+    if (is_view()) {
+      materialize_view();
+    }
+  }
 
   bool any_encrypted_data() const;
 
+  /// \brief Replaces the ciphertexts of the tensor with empty ciphertexts
+  /// stored in one contiguous slab, with room for one two-polynomial
+  /// ciphertext per element at the given level. Two-polynomial ciphertexts
+  /// written at lower levels are smaller, so are also stored in the slab
+  /// \param[in] parms_id Parameter id of the ciphertexts to be written
+  void use_slab_storage(seal::parms_id_type parms_id);
+
+  /// \brief Returns the slab storing the ciphertexts, or nullptr if the
+  /// ciphertexts are allocated separately
+  const SealCiphertextSlab* slab() const { return m_slab.get(); }
+
+  /// \brief Switches the tensor to image packing, which stores each channel
+  /// of a batch-1 image in a single ciphertext or plaintext, with image
+  /// element (i, j) of the channel in slot i * row_stride + j. The tensor
+  /// must have shape (1, C, rows, columns). Its elements are replaced by C
+  /// empty elements, encrypted if the tensor had encrypted data
+  /// \param[in] row_stride Number of slots between consecutive image rows.
+  /// Must be at least the number of columns
+  void use_image_packing(size_t row_stride);
+
+  /// \brief Returns whether or not the tensor uses image packing
+  bool is_image_packed() const { return m_image_row_stride != 0; }
+
+  /// \brief Returns the number of slots between consecutive image rows, or 0
+  /// if the tensor does not use image packing
+  size_t image_row_stride() const { return m_image_row_stride; }
+
   /// \brief Returns the batch size of a given shape
   /// \param[in] shape Shape of the tensor
   /// \param[in] packed Whether or not batch-axis packing is used
   static uint64_t batch_size(const Shape& shape, bool packed);
 
-  /// \brief Returns the shape of the un-expanded (i.e. packed) tensor.
+  /// \brief Returns the shape of the un-expanded (i.e. packed) tensor. Image
+  /// packed tensors have shape (1, C, 1, 1)
   const Shape& get_packed_shape() const { return m_packed_shape; }
 
   /// \brief Returns the shape of the expanded tensor.
@@ -126,35 +202,77 @@ class HETensor : public runtime::Tensor {
 
   /// \brief Returns number of ciphertext / plaintext objects in the tensor
   size_t get_batched_element_count() const {
-    return get_element_count() / get_batch_size();
+    return shape_size(m_packed_shape);
   }
 
   /// \brief Returns whether or not the tensor is packed
   bool is_packed() const { return m_packed; }
 
-  /// \brief Writes the tensor to a vector of proto tensors.
-  /// Due to the 2GB limit on protobufs, large ciphertext tensors may not be
-  /// able to store the entire tensor in one SealCipherTensor message.
+  /// \brief Sets whether write encrypts with the encryptor's secret key into
+  /// seeded ciphertexts, which serialize to about half the size
+  /// \param[in] seeded_encryption Whether or not to use seeded encryption
+  void set_seeded_encryption(bool seeded_encryption) {
+    m_seeded_encryption = seeded_encryption;
+  }
+
+  /// \brief Sets the codec with which ciphertexts are serialized to proto
+  /// tensors. Attached and seeded ciphertexts are not affected
+  /// \param[in] codec Ciphertext codec
+  void set_ciphertext_codec(CiphertextCodec codec) {
+    m_ciphertext_codec = codec;
+  }
+
+  /// \brief Default bound on the serialized size of a proto tensor chunk
+  static constexpr size_t default_max_chunk_bytes = 16 * (1 << 20);
+
+  /// \brief Handles a proto tensor chunk, along with the ciphertexts attached
+  /// to it
+  using ProtoChunkWriter = std::function<void(
+      pb::HETensor&&, std::vector<std::shared_ptr<SealCiphertextWrapper>>&&)>;
+
+  /// \brief Writes the tensor to a sequence of proto tensor chunks, each
+  /// storing a contiguous range of the tensor elements. Each chunk is passed
+  /// to write_chunk as soon as it is serialized, so the whole serialized
+  /// tensor is never stored at once.
+  /// \param[in] write_chunk Function to handle each chunk
+  /// \param[in] attach_ciphertexts If true, ciphertexts are not serialized,
+  /// but passed to write_chunk along with the chunk referencing them. In this
+  /// case, a single chunk is written. Seeded ciphertexts are always
+  /// serialized, since attaching them would send the expanded ciphertext
+  /// \param[in] max_chunk_bytes Bound on the serialized size of a chunk
+  void write_to_proto_chunks(
+      const ProtoChunkWriter& write_chunk, bool attach_ciphertexts = false,
+      size_t max_chunk_bytes = default_max_chunk_bytes) const;
+
+  /// \brief Writes the tensor to a vector of proto tensor chunks
   /// \param[out] proto_tensors
-  void write_to_protos(std::vector<pb::HETensor>& proto_tensors) const;
+  /// \param[in] max_chunk_bytes Bound on the serialized size of a chunk
+  void write_to_protos(std::vector<pb::HETensor>& proto_tensors,
+                       size_t max_chunk_bytes = default_max_chunk_bytes) const;
 
-  /// \brief Loads a tensor from protobuf tensors
-  /// \param[in] proto_tensors vector of protobuf tensors to load from
+  /// \brief Loads a tensor from protobuf tensor chunks
+  /// \param[in] proto_tensors vector of protobuf tensor chunks to load from
   /// \param[in] ckks_encoder CKKS encoder to associate with loaded tensor
   /// \param[in] context SEAL context to associate with loaded tensor
   /// \param[in] encryptor SEAL encryptor to associate with loaded tensor
   /// \param[in] decryptor SEAL decryptor to associate with loaded tensor
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
+  /// \param[in] ciphertexts Ciphertexts attached to the message storing the
+  /// proto tensors
   /// \returns Pointer to loaded tensor
   static std::shared_ptr<HETensor> load_from_proto_tensors(
       const std::vector<pb::HETensor>& proto_tensors,
       seal::CKKSEncoder& ckks_encoder,
       const std::shared_ptr<seal::SEALContext>& context,
-      const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-      const ngraph::he::HESealEncryptionParameters& encryption_params);
+      const std::shared_ptr<const seal::Encryptor>& encryptor,
+      const std::shared_ptr<seal::Decryptor>& decryptor,
+      const ngraph::he::HESealEncryptionParameters& encryption_params,
+      const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts =
+          {});
 
-  /// \brief Loads a tensor from protobuf tensor
+  /// \brief Loads a tensor from a protobuf tensor chunk. Elements not stored
+  /// in the chunk are left empty
   /// \param[in] proto_tensor protobuf tensor to load from
   /// \param[in] ckks_encoder CKKS encoder to associate with loaded tensor
   /// \param[in] context SEAL context to associate with loaded tensor
@@ -162,40 +280,84 @@ class HETensor : public runtime::Tensor {
   /// \param[in] decryptor SEAL decryptor to associate with loaded tensor
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
+  /// \param[in] ciphertexts Ciphertexts attached to the message storing the
+  /// proto tensor
   /// \returns Pointer to loaded tensor
   static std::shared_ptr<HETensor> load_from_proto_tensor(
       const pb::HETensor& proto_tensor, seal::CKKSEncoder& ckks_encoder,
       const std::shared_ptr<seal::SEALContext>& context,
-      const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-      const ngraph::he::HESealEncryptionParameters& encryption_params) {
+      const std::shared_ptr<const seal::Encryptor>& encryptor,
+      const std::shared_ptr<seal::Decryptor>& decryptor,
+      const ngraph::he::HESealEncryptionParameters& encryption_params,
+      const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts =
+          {}) {
     return load_from_proto_tensors({proto_tensor}, ckks_encoder, context,
-                                   encryptor, decryptor, encryption_params);
+                                   encryptor, decryptor, encryption_params,
+                                   ciphertexts);
   }
 
-  /// \brief Loads a tensor from protobuf tensor to an he_tensor
+  /// \brief Loads a protobuf tensor chunk to an he_tensor. Chunks may be
+  /// loaded incrementally, as they arrive
   /// \param[in] he_tensor Tensor to load to
   /// \param[in] proto_tensor protobuf tensor to load from
   /// \param[in] context SEAL context to associate with loaded tensor
+  /// \param[in] ciphertexts Ciphertexts attached to the message storing the
+  /// proto tensor
   static void load_from_proto_tensor(
       std::shared_ptr<HETensor>& he_tensor, const pb::HETensor& proto_tensor,
-      const std::shared_ptr<seal::SEALContext>& context);
+      const std::shared_ptr<seal::SEALContext>& context,
+      const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts =
+          {});
+
+  /// \brief Loads only the elements of a protobuf tensor chunk, for
+  /// receivers which handle each chunk independently of the whole tensor
+  /// \param[in] proto_tensor protobuf tensor chunk to load from
+  /// \param[in] context SEAL context to associate with loaded elements
+  /// \param[in] ciphertexts Ciphertexts attached to the message storing the
+  /// proto tensor
+  /// \returns Elements of the chunk, starting at the chunk's offset
+  static std::vector<HEType> load_proto_chunk(
+      const pb::HETensor& proto_tensor,
+      const std::shared_ptr<seal::SEALContext>& context,
+      const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts =
+          {});
 
   bool done_loading() const { return m_write_count == m_data.size(); }
 
  private:
   bool m_packed;
   Shape m_packed_shape;
-  std::vector<HEType> m_data;
+  size_t m_image_row_stride{0};  // 0 unless image packing is used
+  // Empty until a view is materialized
+  mutable std::vector<HEType> m_data;
+
+  mutable std::atomic<bool> m_is_view{false};
+  mutable std::mutex m_view_mutex;
+  mutable std::vector<std::shared_ptr<HETensor>> m_view_sources;
+  mutable std::shared_ptr<const IndexPlan> m_view_plan;
 
   size_t m_write_count{0};  // Number of elements written to the tensor
+  bool m_seeded_encryption{false};
+  CiphertextCodec m_ciphertext_codec{pb::HEType::NONE};
+  std::shared_ptr<SealCiphertextSlab> m_slab;
 
   seal::CKKSEncoder& m_ckks_encoder;
   std::shared_ptr<seal::SEALContext> m_context;
-  const seal::Encryptor& m_encryptor;
-  seal::Decryptor& m_decryptor;
+  std::shared_ptr<const seal::Encryptor> m_encryptor;
+  std::shared_ptr<seal::Decryptor> m_decryptor;
   const ngraph::he::HESealEncryptionParameters& m_encryption_params;
 
   void check_io_bounds(size_t n) const;
+
+  /// \brief Returns the slot storing an image element of an image packed
+  /// tensor
+  /// \param[in] channel_idx Index of the element within its channel
+  size_t image_slot(size_t channel_idx) const {
+    return (channel_idx / get_shape()[3]) * m_image_row_stride +
+           channel_idx % get_shape()[3];
+  }
+
+  void materialize_view() const;
 };
 
 }  // namespace ngraph::he
@@ -17,24 +17,38 @@
 #include "he_type.hpp"
 
 #include <memory>
+#include <vector>
 
 #include "he_plaintext.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "util.hpp"
 
 namespace ngraph::he {
 
-HEType HEType::load(const pb::HEType& proto_he_type,
-                    std::shared_ptr<seal::SEALContext> context) {
+HEType HEType::load(
+    const pb::HEType& proto_he_type, std::shared_ptr<seal::SEALContext> context,
+    const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts) {
   if (proto_he_type.is_plaintext()) {
-    // TODO(fboemer): HEPlaintext::load function
+    // Plaintexts from older senders are stored as floats
     HEPlaintext vals{proto_he_type.plain().begin(),
                      proto_he_type.plain().end()};
+    if (!proto_he_type.packed_plain().empty()) {
+      unpack_doubles(vals, proto_he_type.packed_plain());
+    }
 
     return HEType(vals, proto_he_type.complex_packing());
   }
+  if (proto_he_type.is_attached()) {
+    size_t attachment_index = proto_he_type.attachment_index();
+    NGRAPH_CHECK(attachment_index < ciphertexts.size(), "Attachment index ",
+                 attachment_index, " out of range for ", ciphertexts.size(),
+                 " attached ciphertexts");
+    return HEType(ciphertexts[attachment_index],
+                  proto_he_type.complex_packing(), proto_he_type.batch_size());
+  }
   auto cipher = HESealBackend::create_empty_ciphertext();
   SealCiphertextWrapper::load(*cipher, proto_he_type, std::move(context));
 
@@ -17,12 +17,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "he_plaintext.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_codec.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "util.hpp"
 
 namespace ngraph::he {
 class HESealBackend;
@@ -45,23 +48,52 @@ class HEType {
     m_cipher = cipher;
   }
 
-  void save(pb::HEType& proto_he_type) const {
+  /// \brief Writes the HEType to a protobuf object. Plaintexts are stored as
+  /// packed little-endian doubles
+  /// \param[out] proto_he_type Protobuf object to write to
+  /// \param[in] codec Codec to serialize ciphertexts with
+  void save(pb::HEType& proto_he_type,
+            CiphertextCodec codec = pb::HEType::NONE) const {
     proto_he_type.set_is_plaintext(is_plaintext());
     proto_he_type.set_complex_packing(complex_packing());
     proto_he_type.set_batch_size(batch_size());
 
     if (is_plaintext()) {
-      // TODO(fboemer): more efficient
-      for (auto& elem : get_plaintext()) {
-        proto_he_type.add_plain(static_cast<float>(elem));
-      }
+      proto_he_type.set_packed_plain(pack_doubles(get_plaintext()));
     } else {
-      get_ciphertext()->save(proto_he_type);
+      get_ciphertext()->save(proto_he_type, codec);
     }
   }
 
-  static HEType load(const pb::HEType& proto_he_type,
-                     std::shared_ptr<seal::SEALContext> context);
+  /// \brief Writes the HEType to a protobuf object. Ciphertexts are not
+  /// serialized, but appended to a list of ciphertexts to attach to the
+  /// message
+  /// \param[out] proto_he_type Protobuf object to write to
+  /// \param[in] attachment_index Index of the ciphertext in the attached
+  /// ciphertexts. Unused for plaintexts
+  void save_attached(pb::HEType& proto_he_type,
+                     size_t attachment_index) const {
+    if (is_plaintext()) {
+      save(proto_he_type);
+      return;
+    }
+    proto_he_type.set_is_plaintext(false);
+    proto_he_type.set_complex_packing(complex_packing());
+    proto_he_type.set_batch_size(batch_size());
+    proto_he_type.set_is_attached(true);
+    proto_he_type.set_attachment_index(attachment_index);
+  }
+
+  /// \brief Loads an HEType from a protobuf object
+  /// \param[in] proto_he_type Protobuf object to load from
+  /// \param[in] context SEAL context to validate ciphertexts against
+  /// \param[in] ciphertexts Ciphertexts attached to the message storing the
+  /// protobuf object. Attached ciphertexts are shared, not copied
+  static HEType load(
+      const pb::HEType& proto_he_type,
+      std::shared_ptr<seal::SEALContext> context,
+      const std::vector<std::shared_ptr<SealCiphertextWrapper>>& ciphertexts =
+          {});
 
   bool is_plaintext() const { return m_is_plain; }
   bool is_ciphertext() const { return !is_plaintext(); }
@@ -81,6 +113,7 @@ class HEType {
     m_plain = std::move(plain);
     m_is_plain = true;
     if (m_cipher != nullptr) {
+      m_cipher->clear_seeded();
       m_cipher->ciphertext().release();
     }
   }
@@ -0,0 +1,66 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "index_plan.hpp"
+
+#include <utility>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::he {
+
+namespace {
+uint32_t to_index(size_t index) {
+  NGRAPH_CHECK(index < IndexPlan::padding_index, "Index ", index,
+               " is too large for an index plan");
+  return static_cast<uint32_t>(index);
+}
+}  // namespace
+
+IndexPlan::IndexPlan(std::vector<Shape> arg_shapes, Shape out_shape)
+    : m_arg_shapes(std::move(arg_shapes)), m_out_shape(std::move(out_shape)) {}
+
+void IndexPlan::add_entry(size_t arg_index) {
+  m_arg_indices.emplace_back(
+      arg_index == padding_index ? padding_index : to_index(arg_index));
+}
+
+void IndexPlan::add_entry(size_t arg_index, size_t filter_index) {
+  m_arg_indices.emplace_back(to_index(arg_index));
+  m_filter_indices.emplace_back(to_index(filter_index));
+}
+
+void IndexPlan::add_gather_entry(size_t arg_index, size_t gather_arg) {
+  m_arg_indices.emplace_back(to_index(arg_index));
+  m_gather_args.emplace_back(to_index(gather_arg));
+}
+
+void IndexPlan::end_output() {
+  m_offsets.emplace_back(to_index(m_arg_indices.size()));
+}
+
+void IndexPlan::end_output(size_t element_count) {
+  end_output();
+  m_element_counts.emplace_back(to_index(element_count));
+}
+
+size_t IndexPlan::byte_count() const {
+  return sizeof(uint32_t) *
+         (m_offsets.size() + m_arg_indices.size() + m_filter_indices.size() +
+          m_gather_args.size() + m_element_counts.size());
+}
+
+}  // namespace ngraph::he
@@ -0,0 +1,124 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ngraph/shape.hpp"
+
+namespace ngraph::he {
+/// \brief Flat gather tables of a data-movement or windowed op.
+///
+/// Output i reads the entries [entry_begin(i), entry_end(i)). Each entry
+/// holds the index of an argument element, and for Convolution, the index of
+/// the filter element it is multiplied with. Data-movement ops have exactly
+/// one entry per output, which for Concat also holds the index of the
+/// argument it reads. Plans depend only on the op's attributes and packed
+/// shapes, so they are built once per op and reused by every call.
+class IndexPlan {
+ public:
+  /// \brief Argument index of an entry reading the padding value
+  static constexpr uint32_t padding_index =
+      std::numeric_limits<uint32_t>::max();
+
+  /// \brief Constructs an empty plan
+  /// \param[in] arg_shapes Packed shapes of the arguments the plan indexes
+  /// \param[in] out_shape Packed shape of the output
+  IndexPlan(std::vector<Shape> arg_shapes, Shape out_shape);
+
+  /// \brief Returns whether the plan was built for the given shapes
+  /// \param[in] arg_shapes Packed shapes of the arguments
+  /// \param[in] out_shape Packed shape of the output
+  bool matches(const std::vector<Shape>& arg_shapes,
+               const Shape& out_shape) const {
+    return arg_shapes == m_arg_shapes && out_shape == m_out_shape;
+  }
+
+  /// \brief Returns the number of outputs with finished entries
+  size_t output_count() const { return m_offsets.size() - 1; }
+
+  /// \brief Returns the first entry of an output
+  size_t entry_begin(size_t out_idx) const { return m_offsets[out_idx]; }
+
+  /// \brief Returns one past the last entry of an output
+  size_t entry_end(size_t out_idx) const { return m_offsets[out_idx + 1]; }
+
+  /// \brief Returns the argument index of an entry
+  uint32_t arg_index(size_t entry_idx) const {
+    return m_arg_indices[entry_idx];
+  }
+
+  /// \brief Returns the filter index of an entry
+  uint32_t filter_index(size_t entry_idx) const {
+    return m_filter_indices[entry_idx];
+  }
+
+  /// \brief Returns the argument index of the only entry of an output
+  uint32_t gather_index(size_t out_idx) const {
+    return m_arg_indices[m_offsets[out_idx]];
+  }
+
+  /// \brief Returns the argument read by the only entry of an output, for
+  /// plans gathering from several arguments
+  uint32_t gather_arg(size_t out_idx) const {
+    return m_gather_args.empty() ? 0 : m_gather_args[m_offsets[out_idx]];
+  }
+
+  /// \brief Returns the number of elements averaged into an output, including
+  /// padding elements if these are counted
+  uint32_t element_count(size_t out_idx) const {
+    return m_element_counts[out_idx];
+  }
+
+  /// \brief Appends an entry to the current output
+  /// \param[in] arg_index Index of the argument element, or padding_index
+  void add_entry(size_t arg_index);
+
+  /// \brief Appends an entry to the current output
+  /// \param[in] arg_index Index of the argument element
+  /// \param[in] filter_index Index of the filter element
+  void add_entry(size_t arg_index, size_t filter_index);
+
+  /// \brief Appends an entry to the current output, for plans gathering from
+  /// several arguments
+  /// \param[in] arg_index Index of the element in the argument
+  /// \param[in] gather_arg Index of the argument
+  void add_gather_entry(size_t arg_index, size_t gather_arg);
+
+  /// \brief Finishes the current output, and starts the next one
+  void end_output();
+
+  /// \brief Finishes the current output, and starts the next one
+  /// \param[in] element_count Number of elements averaged into the output
+  void end_output(size_t element_count);
+
+  /// \brief Returns the number of bytes used by the tables
+  size_t byte_count() const;
+
+ private:
+  std::vector<Shape> m_arg_shapes;
+  Shape m_out_shape;
+
+  std::vector<uint32_t> m_offsets{0};
+  std::vector<uint32_t> m_arg_indices;
+  std::vector<uint32_t> m_filter_indices;
+  std::vector<uint32_t> m_gather_args;
+  std::vector<uint32_t> m_element_counts;
+};
+}  // namespace ngraph::he
@@ -18,7 +18,9 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 
+#include "index_plan.hpp"
 #include "ngraph/node.hpp"
 #include "ngraph/op/op.hpp"
 
@@ -49,8 +51,20 @@ class NodeWrapper {
 
   std::shared_ptr<const ngraph::op::Op> get_op() const;
 
+  /// \brief Returns the index plan of the op, or nullptr if it has none
+  std::shared_ptr<const IndexPlan> get_index_plan() const {
+    return m_index_plan;
+  }
+
+  /// \brief Sets the index plan of the op
+  /// \param[in] index_plan Index plan, built for the op's packed shapes
+  void set_index_plan(std::shared_ptr<const IndexPlan> index_plan) {
+    m_index_plan = std::move(index_plan);
+  }
+
  private:
   std::shared_ptr<const ngraph::Node> m_node;
   OP_TYPEID m_typeid;
+  std::shared_ptr<const IndexPlan> m_index_plan;
 };
 }  // namespace ngraph::he
@@ -28,6 +28,7 @@
 #include "nlohmann/json.hpp"
 #include "seal/he_seal_executable.hpp"
 #include "seal/seal.h"
+#include "seal/seal_key_store.hpp"
 #include "seal/seal_util.hpp"
 
 using json = nlohmann::json;
@@ -68,13 +69,43 @@ void HESealBackend::generate_context() {
 
   auto context_data = m_context->key_context_data();
 
-  m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
-  m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
-  m_galois_keys = std::make_shared<seal::GaloisKeys>(m_keygen->galois_keys());
-  m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
-  m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
-  m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
-  m_decryptor = std::make_shared<seal::Decryptor>(m_context, *m_secret_key);
+  // Galois keys are generated once the required rotations are known
+  m_galois_keys = std::make_shared<seal::GaloisKeys>();
+  m_galois_steps.clear();
+  if (m_client_keys_only) {
+    // Keys are set once a client session provides them
+    NGRAPH_HE_LOG(3) << "Skipping key generation; client provides keys";
+    m_keygen = nullptr;
+    m_relin_keys = nullptr;
+    m_public_key = nullptr;
+    m_secret_key = nullptr;
+    m_encryptor = nullptr;
+    m_decryptor = nullptr;
+  } else {
+    SealKeys keys;
+    if (!m_key_cache_path.empty() &&
+        load_key_store(m_key_cache_path, m_encryption_params, m_context,
+                       keys)) {
+      m_secret_key = keys.secret_key;
+      m_public_key = keys.public_key;
+      m_relin_keys = keys.relin_keys;
+      if (keys.galois_keys != nullptr) {
+        m_galois_keys = keys.galois_keys;
+        m_galois_steps.insert(keys.galois_steps.begin(),
+                              keys.galois_steps.end());
+      }
+      m_keygen = std::make_shared<seal::KeyGenerator>(m_context, *m_secret_key,
+                                                      *m_public_key);
+    } else {
+      m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
+      m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+      m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
+      m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+      save_key_cache();
+    }
+    m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+    m_decryptor = std::make_shared<seal::Decryptor>(m_context, *m_secret_key);
+  }
   m_evaluator = std::make_shared<seal::Evaluator>(m_context);
   m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(m_context);
 
@@ -98,6 +129,38 @@ void HESealBackend::generate_context() {
   }
 }
 
+void HESealBackend::generate_galois_keys(const std::vector<int>& steps) {
+  std::set<int> all_steps(m_galois_steps);
+  all_steps.insert(steps.begin(), steps.end());
+  if (all_steps.size() == m_galois_steps.size()) {
+    return;
+  }
+  NGRAPH_CHECK(m_keygen != nullptr,
+               "Cannot generate Galois keys without a secret key");
+  NGRAPH_HE_LOG(3) << "Generating Galois keys for " << all_steps.size()
+                   << " rotation steps";
+  m_galois_keys = std::make_shared<seal::GaloisKeys>(
+      m_keygen->galois_keys(std::vector<int>(all_steps.begin(),
+                                             all_steps.end())));
+  m_galois_steps = std::move(all_steps);
+  save_key_cache();
+}
+
+void HESealBackend::save_key_cache() const {
+  if (m_key_cache_path.empty()) {
+    return;
+  }
+  SealKeys keys;
+  keys.secret_key = m_secret_key;
+  keys.public_key = m_public_key;
+  keys.relin_keys = m_relin_keys;
+  if (!m_galois_steps.empty()) {
+    keys.galois_keys = m_galois_keys;
+    keys.galois_steps.assign(m_galois_steps.begin(), m_galois_steps.end());
+  }
+  save_key_store(m_key_cache_path, m_encryption_params, keys);
+}
+
 bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
                                std::string& error) {
   (void)error;  // Avoid unused parameter warning
@@ -201,6 +264,9 @@ HESealBackend::create_packed_plain_tensor(const element::Type& type,
 // NOLINTNEXTLINE
 std::shared_ptr<ngraph::runtime::Executable> HESealBackend::compile(
     std::shared_ptr<Function> function, bool enable_performance_data) {
+  NGRAPH_CHECK(m_enable_client || !m_client_keys_only,
+               "Backend without keys requires the client to be enabled");
+
   auto from_client_annotation =
       std::make_shared<HEOpAnnotations>(true, false, false);
 
@@ -298,9 +364,14 @@ std::shared_ptr<ngraph::runtime::Executable> HESealBackend::compile(
     }
   }
 
-  return std::dynamic_pointer_cast<runtime::Executable>(
-      std::make_shared<HESealExecutable>(function, enable_performance_data,
-                                         *this, m_enable_client));
+  auto executable = std::make_shared<HESealExecutable>(
+      function, enable_performance_data, *this, m_enable_client);
+
+  // Clients provide the Galois keys for their own secret key
+  if (!m_enable_client) {
+    generate_galois_keys(executable->galois_steps());
+  }
+  return std::dynamic_pointer_cast<runtime::Executable>(executable);
 }
 
 bool HESealBackend::is_supported(const ngraph::Node& node) const {
@@ -313,6 +384,7 @@ void HESealBackend::encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
                             const HEPlaintext& input, const element::Type& type,
                             bool complex_packing) const {
   NGRAPH_CHECK(!input.empty(), "Input has no values in encrypt");
+  NGRAPH_CHECK(m_encryptor != nullptr, "No public key to encrypt with");
   ngraph::he::encrypt(output, input, m_context->first_parms_id(), type,
                       get_scale(), *m_ckks_encoder, *m_encryptor,
                       complex_packing);
@@ -321,6 +393,7 @@ void HESealBackend::encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
 void HESealBackend::decrypt(HEPlaintext& output,
                             const SealCiphertextWrapper& input,
                             const bool complex_packing) const {
+  NGRAPH_CHECK(m_decryptor != nullptr, "No secret key to decrypt with");
   ngraph::he::decrypt(output, input, complex_packing, *m_decryptor,
                       *m_ckks_encoder);
 }
@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -43,6 +46,7 @@
 #include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_client_key_cache.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
 #include "util.hpp"
 
@@ -63,8 +67,20 @@ class HESealBackend : public ngraph::runtime::Backend {
   /// \param[in] parms Encryption parameters
   explicit HESealBackend(HESealEncryptionParameters parms);
 
+  /// \brief Returns a copy of the backend for serving a single client
+  /// session. The copy shares the encryption context, encoder, and evaluator,
+  /// but keys set on the copy do not affect this backend
+  std::shared_ptr<HESealBackend> clone_for_session() const {
+    return std::make_shared<HESealBackend>(*this);
+  }
+
   /// \brief Prepares the backend with the encryption context, including
-  /// generating encryption keys, encryptor, decryptor, evaluator, and encoder
+  /// generating encryption keys, encryptor, decryptor, evaluator, and encoder.
+  /// If the CLIENT_KEYS_ONLY environment variable is set, only the context,
+  /// evaluator, and encoder are prepared; the key-dependent members are
+  /// nullptr until a client provides its keys. If the NGRAPH_HE_KEY_CACHE
+  /// environment variable names a key store saved with the same encryption
+  /// parameters, the keys are loaded from it instead of generated
   void generate_context();
 
   /// \brief Constructs an unpacked plaintext tensor
@@ -260,17 +276,69 @@ class HESealBackend : public ngraph::runtime::Backend {
   /// with the other SEAL keys
   /// \param[in] keys relinearization keys
   void set_relin_keys(const seal::RelinKeys& keys) {
-    m_relin_keys = std::make_shared<seal::RelinKeys>(keys);
+    set_relin_keys(std::make_shared<seal::RelinKeys>(keys));
+  }
+
+  /// \brief Sets the relinearization keys without copying them. Note, they
+  /// may not be compatible with the other SEAL keys
+  /// \param[in] keys relinearization keys, which must not be modified
+  void set_relin_keys(std::shared_ptr<seal::RelinKeys> keys) {
+    m_relin_keys = std::move(keys);
+  }
+
+  /// \brief Generates Galois keys for the given rotation steps, keeping the
+  /// steps whose keys were generated before. Keys are only regenerated if a
+  /// step is new
+  /// \param[in] steps Rotation steps. Step 0 denotes complex conjugation
+  void generate_galois_keys(const std::vector<int>& steps);
+
+  /// \brief Sets the Galois keys. Note, they may not be compatible with the
+  /// other SEAL keys
+  /// \param[in] keys Galois keys
+  /// \param[in] steps Rotation steps for which the keys were generated
+  void set_galois_keys(const seal::GaloisKeys& keys,
+                       const std::vector<int>& steps) {
+    set_galois_keys(std::make_shared<seal::GaloisKeys>(keys), steps);
+  }
+
+  /// \brief Sets the Galois keys without copying them. Note, they may not be
+  /// compatible with the other SEAL keys
+  /// \param[in] keys Galois keys, which must not be modified
+  /// \param[in] steps Rotation steps for which the keys were generated
+  void set_galois_keys(std::shared_ptr<seal::GaloisKeys> keys,
+                       const std::vector<int>& steps) {
+    m_galois_keys = std::move(keys);
+    m_galois_steps = std::set<int>(steps.begin(), steps.end());
+  }
+
+  /// \brief Returns whether or not Galois keys are available for each of the
+  /// given rotation steps
+  /// \param[in] steps Rotation steps. Step 0 denotes complex conjugation
+  bool has_galois_keys(const std::vector<int>& steps) const {
+    return std::all_of(steps.begin(), steps.end(), [this](int step) {
+      return m_galois_steps.find(step) != m_galois_steps.end();
+    });
   }
 
   /// \brief Sets the public keys. Note, they may not be compatible
   /// with the other SEAL keys
   /// \param[in] key public key
   void set_public_key(const seal::PublicKey& key) {
-    m_public_key = std::make_shared<seal::PublicKey>(key);
+    set_public_key(std::make_shared<seal::PublicKey>(key));
+  }
+
+  /// \brief Sets the public key without copying it. Note, it may not be
+  /// compatible with the other SEAL keys
+  /// \param[in] key public key, which must not be modified
+  void set_public_key(std::shared_ptr<seal::PublicKey> key) {
+    m_public_key = std::move(key);
     m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
   }
 
+  /// \brief Returns the cache of keys uploaded by clients. Backends cloned for
+  /// client sessions share the cache
+  SealClientKeyCache& client_key_cache() { return *m_client_key_cache; }
+
   /// \brief TODO(fboemer)
   const std::unordered_map<std::uint64_t, std::uint64_t>& barrett64_ratio_map()
       const {
@@ -332,7 +400,16 @@ class HESealBackend : public ngraph::runtime::Backend {
   }
 
  private:
+  /// \brief Saves the keys to the key cache, if one is set
+  void save_key_cache() const;
+
   bool m_naive_rescaling{flag_to_bool(std::getenv("NAIVE_RESCALING"))};
+  // If set, no keys are generated; a client provides them instead
+  bool m_client_keys_only{flag_to_bool(std::getenv("CLIENT_KEYS_ONLY"))};
+  // Key store to load keys from and save generated keys to, if not empty
+  std::string m_key_cache_path{env_string("NGRAPH_HE_KEY_CACHE")};
+  std::shared_ptr<SealClientKeyCache> m_client_key_cache{
+      std::make_shared<SealClientKeyCache>()};
   bool m_enable_client{false};
 
   std::shared_ptr<seal::SecretKey> m_secret_key;
@@ -344,6 +421,8 @@ class HESealBackend : public ngraph::runtime::Backend {
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
   std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+  // Rotation steps for which m_galois_keys has keys
+  std::set<int> m_galois_steps;
   HESealEncryptionParameters m_encryption_params;
   std::shared_ptr<seal::CKKSEncoder> m_ckks_encoder;
 
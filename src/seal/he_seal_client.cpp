@@ -29,10 +29,12 @@
 #include "ngraph/log.hpp"
 #include "nlohmann/json.hpp"
 #include "seal/kernel/bounded_relu_seal.hpp"
-#include "seal/kernel/max_pool_seal.hpp"
+#include "seal/kernel/max_seal.hpp"
 #include "seal/kernel/relu_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_client_key_cache.hpp"
+#include "seal/seal_key_store.hpp"
 #include "seal/seal_util.hpp"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
@@ -86,19 +88,68 @@ void HESealClient::set_seal_context() {
 
   print_encryption_parameters(m_encryption_params, *m_context);
 
-  m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
-  m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
-  m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
-  m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
-  m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key);
+  SealKeys keys;
+  if (!m_key_cache_path.empty() &&
+      load_key_store(m_key_cache_path, m_encryption_params, m_context, keys)) {
+    m_secret_key = keys.secret_key;
+    m_public_key = keys.public_key;
+    m_relin_keys = keys.relin_keys;
+    m_galois_keys = keys.galois_keys;
+    m_galois_key_steps = keys.galois_steps;
+    m_key_fingerprint = keys.key_fingerprint;
+    m_keygen = std::make_shared<seal::KeyGenerator>(m_context, *m_secret_key,
+                                                    *m_public_key);
+  } else {
+    m_keygen = std::make_shared<seal::KeyGenerator>(m_context);
+    m_relin_keys = std::make_shared<seal::RelinKeys>(m_keygen->relin_keys());
+    m_public_key = std::make_shared<seal::PublicKey>(m_keygen->public_key());
+    m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+    m_galois_keys = nullptr;
+    m_galois_key_steps.clear();
+    m_key_fingerprint.clear();
+    save_key_cache();
+  }
+  // The secret key enables seeded symmetric encryption
+  m_encryptor = std::make_shared<seal::Encryptor>(m_context, *m_public_key,
+                                                  *m_secret_key);
   m_decryptor = std::make_shared<seal::Decryptor>(m_context, *m_secret_key);
   m_evaluator = std::make_shared<seal::Evaluator>(m_context);
   m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(m_context);
+
+  // Needed to receive attached ciphertexts
+  m_tcp_client->set_context(m_context);
 }
 
-void HESealClient::send_public_and_relin_keys() {
+void HESealClient::save_key_cache() const {
+  if (m_key_cache_path.empty()) {
+    return;
+  }
+  SealKeys keys;
+  keys.secret_key = m_secret_key;
+  keys.public_key = m_public_key;
+  keys.relin_keys = m_relin_keys;
+  keys.galois_keys = m_galois_keys;
+  keys.galois_steps = m_galois_key_steps;
+  keys.key_fingerprint = m_key_fingerprint;
+  save_key_store(m_key_cache_path, m_encryption_params, keys);
+}
+
+void HESealClient::update_galois_keys() {
+  if (m_galois_steps.empty() ||
+      (m_galois_keys != nullptr && m_galois_key_steps == m_galois_steps)) {
+    return;
+  }
+  m_galois_keys = std::make_shared<seal::GaloisKeys>(
+      m_keygen->galois_keys(m_galois_steps));
+  m_galois_key_steps = m_galois_steps;
+  m_key_fingerprint.clear();
+  save_key_cache();
+}
+
+pb::TCPMessage HESealClient::build_keys_message() {
   pb::TCPMessage message;
   message.set_type(pb::TCPMessage_Type_RESPONSE);
+  add_supported_ciphertext_codecs(message);
 
   // Set public key
   std::stringstream pk_stream;
@@ -112,8 +163,42 @@ void HESealClient::send_public_and_relin_keys() {
   m_relin_keys->save(evk_stream);
   pb::EvaluationKey eval_key;
   eval_key.set_eval_key(evk_stream.str());
+
+  // Galois keys are fingerprinted with the other keys, so are sent whenever
+  // the client has them
+  if (m_galois_keys != nullptr) {
+    std::stringstream galois_stream;
+    m_galois_keys->save(galois_stream);
+    eval_key.set_galois_keys(galois_stream.str());
+  }
   *message.mutable_eval_key() = eval_key;
 
+  // Lets the server cache the keys for later sessions. The fingerprint is
+  // saved with the keys, so resumed sessions need not serialize them
+  if (m_key_fingerprint.empty()) {
+    m_key_fingerprint = client_key_fingerprint(
+        message.public_key().public_key(), message.eval_key().eval_key(),
+        message.eval_key().galois_keys());
+    save_key_cache();
+  }
+  message.mutable_key_fingerprint()->set_fingerprint(m_key_fingerprint);
+  return message;
+}
+
+void HESealClient::send_public_and_relin_keys() {
+  NGRAPH_HE_LOG(3) << "Client sending keys";
+  write_message(TCPMessage(build_keys_message()));
+}
+
+void HESealClient::send_key_fingerprint() {
+  NGRAPH_HE_LOG(3) << "Client sending key fingerprint";
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  if (m_key_fingerprint.empty()) {
+    build_keys_message();
+  }
+  message.mutable_key_fingerprint()->set_fingerprint(m_key_fingerprint);
+  add_supported_ciphertext_codecs(message);
   write_message(TCPMessage(std::move(message)));
 }
 
@@ -129,9 +214,21 @@ void HESealClient::handle_encryption_parameters_response(
   NGRAPH_HE_LOG(3) << "Client loading encryption parameters from stream size "
                    << enc_parms_str.size();
   m_encryption_params = HESealEncryptionParameters::load(param_stream);
+  const auto& galois_steps = message.encryption_parameters().galois_steps();
+  m_galois_steps.assign(galois_steps.begin(), galois_steps.end());
+  // Seeded ciphertexts are only sent if the server accepts them
+  m_seeded_encryption = m_seeded_encryption &&
+                        message.encryption_parameters().seeded_ciphertexts();
+  m_ciphertext_codec = negotiate_ciphertext_codec(m_ciphertext_codec,
+                                                  message.ciphertext_codecs());
 
   set_seal_context();
-  send_public_and_relin_keys();
+  update_galois_keys();
+  if (m_resume_session) {
+    send_key_fingerprint();
+  } else {
+    send_public_and_relin_keys();
+  }
 }
 
 void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
@@ -193,28 +290,52 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   auto he_tensor = HETensor(
       element_type, shape, proto_tensor.packed(),
       m_encryption_params.complex_packing(), encrypt_tensor, *m_ckks_encoder,
-      m_context, *m_encryptor, *m_decryptor, m_encryption_params, proto_name);
+      m_context, m_encryptor, m_decryptor, m_encryption_params, proto_name);
+  he_tensor.set_seeded_encryption(m_seeded_encryption);
+  he_tensor.set_ciphertext_codec(m_ciphertext_codec);
 
   size_t num_bytes = parameter_size * sizeof(double) * m_batch_size;
   NGRAPH_HE_LOG(3) << "Writing to tensor";
   he_tensor.write(input_data.data(), num_bytes);
 
-  std::vector<pb::HETensor> tensor_protos;
+  // Each chunk is sent as soon as it is serialized
   NGRAPH_HE_LOG(3) << "Writing to protos";
-  he_tensor.write_to_protos(tensor_protos);
-  for (const auto& tensor_proto : tensor_protos) {
-    pb::TCPMessage inputs_msg;
-    inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
-    *inputs_msg.add_he_tensors() = tensor_proto;
-
-    auto param_shape = inputs_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Client sending encrypted input with shape "
-                     << Shape{param_shape.begin(), param_shape.end()};
-    write_message(TCPMessage(std::move(inputs_msg)));
-  }
+  he_tensor.write_to_proto_chunks(
+      [this](pb::HETensor&& proto_tensor,
+             TCPMessage::ciphertext_list&& ciphertexts) {
+        pb::TCPMessage inputs_msg;
+        inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
+        *inputs_msg.add_he_tensors() = std::move(proto_tensor);
+
+        auto param_shape = inputs_msg.he_tensors(0).shape();
+        NGRAPH_HE_LOG(3) << "Client sending encrypted input chunk "
+                         << inputs_msg.he_tensors(0).chunk_index()
+                         << " with shape "
+                         << Shape{param_shape.begin(), param_shape.end()};
+        write_message(
+            TCPMessage(std::move(inputs_msg), std::move(ciphertexts)));
+      },
+      attach_ciphertexts());
 }
 
-void HESealClient::handle_result(const pb::TCPMessage& message) {
+void HESealClient::write_response(const pb::TCPMessage& request,
+                                  HETensor& tensor) {
+  tensor.set_ciphertext_codec(m_ciphertext_codec);
+  tensor.write_to_proto_chunks(
+      [&](pb::HETensor&& proto_tensor,
+          TCPMessage::ciphertext_list&& ciphertexts) {
+        pb::TCPMessage response;
+        response.set_type(pb::TCPMessage_Type_RESPONSE);
+        *response.mutable_function() = request.function();
+        *response.add_he_tensors() = std::move(proto_tensor);
+        write_message(TCPMessage(std::move(response), std::move(ciphertexts)));
+      },
+      attach_ciphertexts());
+}
+
+void HESealClient::handle_result(
+    const pb::TCPMessage& message,
+    const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Client handling result";
 
   NGRAPH_CHECK(message.he_tensors_size() > 0,
@@ -226,15 +347,15 @@ void HESealClient::handle_result(const pb::TCPMessage& message) {
 
   if (m_result_tensor == nullptr) {
     m_result_tensor = HETensor::load_from_proto_tensor(
-        proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-        m_encryption_params);
+        proto_tensor, *m_ckks_encoder, m_context, m_encryptor, m_decryptor,
+        m_encryption_params, ciphertexts);
   } else {
-    HETensor::load_from_proto_tensor(m_result_tensor, proto_tensor, m_context);
+    HETensor::load_from_proto_tensor(m_result_tensor, proto_tensor, m_context,
+                                     ciphertexts);
   }
 
   if (m_result_tensor->done_loading()) {
-    size_t data_size = m_result_tensor->data().size();
-    m_results.resize(data_size * m_result_tensor->get_batch_size());
+    m_results.resize(m_result_tensor->get_element_count());
     size_t num_bytes =
         m_results.size() * m_result_tensor->get_element_type().size();
     m_result_tensor->read(m_results.data(), num_bytes);
@@ -242,7 +363,17 @@ void HESealClient::handle_result(const pb::TCPMessage& message) {
   }
 }
 
-void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
+seal::parms_id_type HESealClient::request_parms_id(
+    const pb::Function& function) const {
+  json js = json::parse(function.function());
+  if (js.find("chain_index") == js.end()) {
+    return m_context->first_parms_id();
+  }
+  return parms_id_at_chain_index(*m_context, js.at("chain_index"));
+}
+
+void HESealClient::handle_relu_request(
+    pb::TCPMessage&& message, const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Client handling relu request";
 
   NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function");
@@ -251,32 +382,31 @@ void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
   NGRAPH_CHECK(message.he_tensors_size() == 1,
                "Client supports only relu requests with one tensor");
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
-
-  pb::HETensor* proto_tensor = message.mutable_he_tensors(0);
-  auto he_tensor = HETensor::load_from_proto_tensor(
-      *proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
+  // Each chunk of a relu request is answered independently
+  const pb::HETensor& proto_tensor = message.he_tensors(0);
+  std::vector<HEType> request =
+      HETensor::load_proto_chunk(proto_tensor, m_context, ciphertexts);
+  size_t result_count = request.size();
+  Shape shape{proto_tensor.shape().begin(), proto_tensor.shape().end()};
+  size_t batch_size = HETensor::batch_size(shape, proto_tensor.packed());
+  HETensor relu_result(element::f64, Shape{batch_size, result_count},
+                       proto_tensor.packed(), complex_packing(), true,
+                       *m_ckks_encoder, m_context, m_encryptor, m_decryptor,
+                       m_encryption_params);
+  seal::parms_id_type parms_id = request_parms_id(message.function());
 
 #pragma omp parallel for
-  for (size_t result_idx = 0; result_idx < proto_tensor->data_size();
-       ++result_idx) {
-    scalar_relu_seal(he_tensor->data(result_idx), he_tensor->data(result_idx),
-                     m_context->first_parms_id(), scale(), *m_ckks_encoder,
-                     *m_encryptor, *m_decryptor);
+  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+    scalar_relu_seal(request[result_idx], relu_result.data(result_idx),
+                     parms_id, scale(), *m_ckks_encoder, *m_encryptor,
+                     *m_decryptor, seeded_context());
   }
 
-  std::vector<pb::HETensor> proto_output_tensors;
-  he_tensor->write_to_protos(proto_output_tensors);
-
-  NGRAPH_CHECK(proto_output_tensors.size() == 1,
-               "Only support single-output tensors");
-  *proto_tensor = proto_output_tensors[0];
-
-  write_message(TCPMessage(std::move(message)));
+  write_response(message, relu_result);
 }
 
-void HESealClient::handle_bounded_relu_request(pb::TCPMessage&& message) {
+void HESealClient::handle_bounded_relu_request(
+    pb::TCPMessage&& message, const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Client handling bounded relu request";
 
   NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function");
@@ -289,31 +419,31 @@ void HESealClient::handle_bounded_relu_request(pb::TCPMessage&& message) {
   json js = json::parse(function);
   double bound = js.at("bound");
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
-
-  pb::HETensor* proto_tensor = message.mutable_he_tensors(0);
-  auto he_tensor = HETensor::load_from_proto_tensor(
-      *proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
+  // Each chunk of a bounded relu request is answered independently
+  const pb::HETensor& proto_tensor = message.he_tensors(0);
+  std::vector<HEType> request =
+      HETensor::load_proto_chunk(proto_tensor, m_context, ciphertexts);
+  size_t result_count = request.size();
+  Shape shape{proto_tensor.shape().begin(), proto_tensor.shape().end()};
+  size_t batch_size = HETensor::batch_size(shape, proto_tensor.packed());
+  HETensor relu_result(element::f64, Shape{batch_size, result_count},
+                       proto_tensor.packed(), complex_packing(), true,
+                       *m_ckks_encoder, m_context, m_encryptor, m_decryptor,
+                       m_encryption_params);
+  seal::parms_id_type parms_id = request_parms_id(message.function());
 
 #pragma omp parallel for
-  for (size_t result_idx = 0; result_idx < proto_tensor->data_size();
-       ++result_idx) {
-    scalar_bounded_relu_seal(he_tensor->data(result_idx),
-                             he_tensor->data(result_idx), bound,
-                             m_context->first_parms_id(), scale(),
-                             *m_ckks_encoder, *m_encryptor, *m_decryptor);
+  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+    scalar_bounded_relu_seal(request[result_idx], relu_result.data(result_idx),
+                             bound, parms_id, scale(), *m_ckks_encoder,
+                             *m_encryptor, *m_decryptor, seeded_context());
   }
-  std::vector<pb::HETensor> proto_output_tensors;
-  he_tensor->write_to_protos(proto_output_tensors);
-  NGRAPH_CHECK(proto_output_tensors.size() == 1,
-               "Only support single-output tensors");
-  *proto_tensor = proto_output_tensors[0];
 
-  write_message(TCPMessage(std::move(message)));
+  write_response(message, relu_result);
 }
 
-void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
+void HESealClient::handle_max_pool_request(
+    pb::TCPMessage&& message, const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Client handling maxpool request";
 
   NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function ");
@@ -322,40 +452,60 @@ void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
   NGRAPH_CHECK(message.he_tensors_size() == 1,
                "Client supports only max pool requests with one tensor");
 
-  pb::HETensor* proto_tensor = message.mutable_he_tensors(0);
-  size_t cipher_count = proto_tensor->data_size();
-
-  std::vector<HEType> max_pool_ciphers(
-      cipher_count, HEType(HEPlaintext(m_batch_size), false));
-  std::vector<HEType> post_max_pool_ciphers(
-      {HEType(HEPlaintext(m_batch_size), false)});
-
-  auto he_tensor = HETensor::load_from_proto_tensor(
-      *proto_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
-
-  // We currently just support max_pool with single output
-  auto post_max_he_tensor =
-      HETensor(he_tensor->get_element_type(), Shape{m_batch_size, 1},
-               he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
-               m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+  // The request holds the ciphertexts of consecutive windows
+  const std::string& function = message.function().function();
+  json js = json::parse(function);
+  auto window_sizes = js.at("window_sizes").get<std::vector<size_t>>();
+  size_t window_count = window_sizes.size();
+
+  std::vector<size_t> window_offsets(window_count + 1, 0);
+  std::partial_sum(window_sizes.begin(), window_sizes.end(),
+                   window_offsets.begin() + 1);
+
+  // The request may be split into chunks, which are loaded as they arrive
+  size_t request_id = js.at("request_id");
+  const pb::HETensor& proto_tensor = message.he_tensors(0);
+  auto request = m_max_pool_requests.find(request_id);
+  if (request == m_max_pool_requests.end()) {
+    auto request_tensor = HETensor::load_from_proto_tensor(
+        proto_tensor, *m_ckks_encoder, m_context, m_encryptor, m_decryptor,
+        m_encryption_params, ciphertexts);
+    request = m_max_pool_requests.emplace(request_id, request_tensor).first;
+  } else {
+    HETensor::load_from_proto_tensor(request->second, proto_tensor, m_context,
+                                     ciphertexts);
+  }
+  if (!request->second->done_loading()) {
+    return;
+  }
+  auto he_tensor = request->second;
+  m_max_pool_requests.erase(request);
 
-  max_pool_seal(he_tensor->data(), post_max_he_tensor.data(),
-                Shape{1, 1, cipher_count}, Shape{1, 1, 1}, Shape{cipher_count},
-                Strides{1}, Shape{0}, Shape{0}, m_context->first_parms_id(),
-                scale(), *m_ckks_encoder, *m_encryptor, *m_decryptor);
+  size_t cipher_count = he_tensor->data().size();
+  NGRAPH_CHECK(window_offsets.back() == cipher_count, "Maxpool windows cover ",
+               window_offsets.back(), " ciphertexts, but got ", cipher_count);
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
-  message.clear_he_tensors();
+  auto post_max_he_tensor = HETensor(
+      he_tensor->get_element_type(), Shape{m_batch_size, window_count},
+      he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
+      m_context, m_encryptor, m_decryptor, m_encryption_params);
+  seal::parms_id_type parms_id = request_parms_id(message.function());
 
-  std::vector<pb::HETensor> proto_output_tensors;
-  post_max_he_tensor.write_to_protos(proto_output_tensors);
-  NGRAPH_CHECK(proto_output_tensors.size() == 1,
-               "Only support single-output tensors");
+#pragma omp parallel for
+  for (size_t window_idx = 0; window_idx < window_count; ++window_idx) {
+    auto window_begin = he_tensor->data().begin() + window_offsets[window_idx];
+    std::vector<HEType> window_ciphers(
+        window_begin, window_begin + window_sizes[window_idx]);
+    std::vector<HEType> window_max{post_max_he_tensor.data(window_idx)};
+
+    max_seal(window_ciphers, window_max, Shape{window_sizes[window_idx]},
+             Shape{}, AxisSet{0}, window_max[0].batch_size(),
+             parms_id, scale(), *m_ckks_encoder, *m_encryptor, *m_decryptor,
+             seeded_context());
+    post_max_he_tensor.data(window_idx) = window_max[0];
+  }
 
-  *message.add_he_tensors() = proto_output_tensors[0];
-  TCPMessage max_pool_result_msg(std::move(message));
-  write_message(std::move(max_pool_result_msg));
+  write_response(message, post_max_he_tensor);
 }
 
 void HESealClient::handle_message(const TCPMessage& message) {
@@ -370,7 +520,7 @@ void HESealClient::handle_message(const TCPMessage& message) {
       if (proto_msg->has_encryption_parameters()) {
         handle_encryption_parameters_response(*proto_msg);
       } else if (proto_msg->he_tensors_size() > 0) {
-        handle_result(*proto_msg);
+        handle_result(*proto_msg, message.ciphertexts());
       } else {
         NGRAPH_CHECK(false, "Unknown RESPONSE type");
       }
@@ -385,14 +535,19 @@ void HESealClient::handle_message(const TCPMessage& message) {
         if (name == "Parameter") {
           handle_inference_request(*proto_msg);
         } else if (name == "Relu") {
-          handle_relu_request(std::move(*proto_msg));
+          handle_relu_request(std::move(*proto_msg), message.ciphertexts());
         } else if (name == "BoundedRelu") {
-          handle_bounded_relu_request(std::move(*proto_msg));
+          handle_bounded_relu_request(std::move(*proto_msg),
+                                      message.ciphertexts());
         } else if (name == "MaxPool") {
-          handle_max_pool_request(std::move(*proto_msg));
+          handle_max_pool_request(std::move(*proto_msg),
+                                  message.ciphertexts());
         } else {
           NGRAPH_HE_LOG(5) << "Unknown name " << name;
         }
+      } else if (proto_msg->has_key_fingerprint()) {
+        // The server has not cached the keys
+        send_public_and_relin_keys();
       } else {
         NGRAPH_CHECK(false, "Unknown REQUEST type");
       }
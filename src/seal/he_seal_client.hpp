@@ -17,14 +17,17 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "he_tensor.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/seal_ciphertext_codec.hpp"
 #include "seal/seal.h"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
@@ -83,27 +86,63 @@ class HESealClient {
 
   /// \brief Processes a request to perform ReLU function
   /// \param[in] message Message to process
-  void handle_relu_request(pb::TCPMessage&& message);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_relu_request(
+      pb::TCPMessage&& message,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
-  /// \brief Processes a request to perform MaxPool function
+  /// \brief Processes a request to perform MaxPool function. The request may
+  /// contain several windows, whose maxima are computed in parallel
   /// \param[in] message Message to process
-  void handle_max_pool_request(pb::TCPMessage&& message);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_max_pool_request(
+      pb::TCPMessage&& message,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a request to perform BoundedReLU function
   /// \param[in] message Message to process
-  void handle_bounded_relu_request(pb::TCPMessage&& message);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_bounded_relu_request(
+      pb::TCPMessage&& message,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a message containing the result from the server
   /// \param[in] message Message to process
-  void handle_result(const pb::TCPMessage& message);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_result(const pb::TCPMessage& message,
+                     const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a message containing the inference shape
   /// \param[in] message Message to process
   void handle_inference_request(const pb::TCPMessage& message);
 
-  /// \brief Sends the public key and relinearization keys to the server
+  /// \brief Writes a tensor in response to a request. Each chunk of the
+  /// tensor is written as a separate message
+  /// \param[in] request Request to respond to
+  /// \param[in,out] tensor Tensor to write. Its ciphertext codec is set to
+  /// the negotiated codec
+  void write_response(const pb::TCPMessage& request, HETensor& tensor);
+
+  /// \brief Generates Galois keys for the rotation steps the server uses,
+  /// unless the current Galois keys have them
+  void update_galois_keys();
+
+  /// \brief Returns a message for the server with the serialized public key
+  /// and evaluation keys, and their fingerprint. The fingerprint is computed
+  /// only once per set of keys
+  pb::TCPMessage build_keys_message();
+
+  /// \brief Sends the public key and evaluation keys to the server
   void send_public_and_relin_keys();
 
+  /// \brief Sends only the fingerprint of the keys, so the server may reuse
+  /// the keys cached from an earlier session. The keys are serialized only
+  /// if their fingerprint is unknown
+  void send_key_fingerprint();
+
+  /// \brief Saves the keys to the key cache, if one is set
+  void save_key_cache() const;
+
   /// \brief Writes a mesage to the server
   /// \param[in] message Message to write
   void write_message(ngraph::he::TCPMessage&& message) {
@@ -127,7 +166,34 @@ class HESealClient {
   /// \brief Returns the scale of the encryption parameters
   double scale() const { return m_encryption_params.scale(); }
 
+  /// \brief Returns whether or not ciphertexts sent to the server are
+  /// encrypted as seeded ciphertexts
+  bool seeded_encryption() const { return m_seeded_encryption; }
+
+  /// \brief Returns the codec of ciphertexts sent to the server, once
+  /// negotiated with the server
+  CiphertextCodec ciphertext_codec() const { return m_ciphertext_codec; }
+
  private:
+  /// \brief Returns the context to encrypt seeded ciphertexts for, or nullptr
+  /// if seeded encryption is not used
+  std::shared_ptr<seal::SEALContext> seeded_context() const {
+    return m_seeded_encryption ? m_context : nullptr;
+  }
+
+  /// \brief Returns the parms_id at which to re-encrypt the results of a
+  /// request. This is the chain index the server requested, or the first
+  /// chain index if it did not request one
+  /// \param[in] function Function of the request
+  seal::parms_id_type request_parms_id(const pb::Function& function) const;
+
+  /// \brief Returns whether or not to attach ciphertexts to sent messages.
+  /// Seeded ciphertexts are serialized instead, since attaching sends the
+  /// expanded ciphertext
+  bool attach_ciphertexts() const {
+    return m_zero_copy_tcp && !m_seeded_encryption;
+  }
+
   std::unique_ptr<TCPClient> m_tcp_client;
   ngraph::he::HESealEncryptionParameters m_encryption_params;
   std::shared_ptr<seal::PublicKey> m_public_key;
@@ -139,7 +205,20 @@ class HESealClient {
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
   std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  std::vector<int> m_galois_steps;  // Rotation steps the server requested
+  std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+  std::vector<int> m_galois_key_steps;  // Rotation steps of m_galois_keys
+  // Fingerprint of the serialized keys, or empty if not yet computed
+  std::string m_key_fingerprint;
+  // Key store to load keys from and save generated keys to, if not empty
+  std::string m_key_cache_path{env_string("NGRAPH_HE_CLIENT_KEY_CACHE")};
   size_t m_batch_size;
+  bool m_zero_copy_tcp{flag_to_bool(std::getenv("ZERO_COPY_TCP"))};
+  bool m_resume_session{flag_to_bool(std::getenv("RESUME_SESSION"))};
+  // Encrypt with the secret key, sending only c0 and a seed for c1
+  bool m_seeded_encryption{flag_to_bool(std::getenv("SEEDED_ENCRYPTION"))};
+  // Codec of sent ciphertexts, once negotiated with the server
+  CiphertextCodec m_ciphertext_codec{default_ciphertext_codec()};
 
   bool m_is_done{false};
   std::condition_variable m_is_done_cond;
@@ -147,6 +226,9 @@ class HESealClient {
 
   std::shared_ptr<HETensor> m_loaded_function_tensor;
 
+  // MaxPool requests whose chunks have not all arrived, by request id
+  std::unordered_map<size_t, std::shared_ptr<HETensor>> m_max_pool_requests;
+
   // Function inputs and configuration
   HETensorConfigMap<double> m_input_config;
   std::shared_ptr<HETensor> m_result_tensor;
@@ -16,14 +16,21 @@
 
 #include "seal/he_seal_executable.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <limits>
+#include <map>
+#include <set>
 #include <tuple>
 #include <unordered_set>
+#include <utility>
 
+#include "dag_scheduler.hpp"
 #include "he_op_annotations.hpp"
 #include "he_tensor.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
+#include "ngraph/graph_util.hpp"
 #include "ngraph/op/avg_pool.hpp"
 #include "ngraph/op/batch_norm.hpp"
 #include "ngraph/op/broadcast.hpp"
@@ -70,13 +77,16 @@
 #include "seal/kernel/broadcast_seal.hpp"
 #include "seal/kernel/concat_seal.hpp"
 #include "seal/kernel/constant_seal.hpp"
+#include "seal/kernel/convolution_packed_image_seal.hpp"
 #include "seal/kernel/convolution_seal.hpp"
 #include "seal/kernel/divide_seal.hpp"
+#include "seal/kernel/dot_diagonal_seal.hpp"
 #include "seal/kernel/dot_seal.hpp"
 #include "seal/kernel/exp_seal.hpp"
 #include "seal/kernel/max_pool_seal.hpp"
 #include "seal/kernel/max_seal.hpp"
 #include "seal/kernel/minimum_seal.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/kernel/pad_seal.hpp"
@@ -90,8 +100,11 @@
 #include "seal/kernel/softmax_seal.hpp"
 #include "seal/kernel/subtract_seal.hpp"
 #include "seal/kernel/sum_seal.hpp"
+#include "seal/seal_ciphertext_pool.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_client_key_cache.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 using json = nlohmann::json;
 using ngraph::descriptor::layout::DenseTensorLayout;
@@ -108,7 +121,52 @@ HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
   // TODO(fboemer): Use
   (void)enable_performance_collection;  // Avoid unused parameter warning
 
-  m_context = he_seal_backend.get_context();
+  compile_function(function);
+}
+
+HESealExecutable::HESealExecutable(const HESealExecutable& parent,
+                                   HESealBackend& he_seal_backend)
+    : m_he_seal_backend(he_seal_backend),
+      m_enable_client{true},
+      m_batch_size{1},
+      m_port{parent.m_port},
+      m_op_caches{parent.m_op_caches},
+      m_ciphertext_pool{parent.m_ciphertext_pool} {
+  // Calling a function updates its annotations, so each session calls its own
+  // copy of the function
+  NodeMap node_map;
+  std::shared_ptr<Function> session_function =
+      clone_function(*parent.m_function, node_map);
+  for (const auto& [node, clone] : node_map.get_node_map()) {
+    m_op_cache_keys[clone.get()] = parent.op_cache_key(*node);
+  }
+
+  const ParameterVector& parameters = parent.get_parameters();
+  const ParameterVector& session_parameters =
+      session_function->get_parameters();
+  for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+    const auto& param = parameters[param_idx];
+    const auto& session_param = session_parameters[param_idx];
+    if (HEOpAnnotations::has_he_annotation(*param)) {
+      session_param->set_op_annotations(std::make_shared<HEOpAnnotations>(
+          *HEOpAnnotations::he_op_annotation(*param)));
+    }
+    // Clients refer to parameters by name or by tag
+    if (param->get_provenance_tags().empty()) {
+      session_param->add_provenance_tag(param->get_name());
+    }
+    for (const auto& tag : param->get_provenance_tags()) {
+      session_param->add_provenance_tag(tag);
+    }
+  }
+
+  compile_function(session_function);
+  m_client_sessions = 1;
+}
+
+void HESealExecutable::compile_function(
+    const std::shared_ptr<Function>& function) {
+  m_context = m_he_seal_backend.get_context();
   // TODO(fboemer): use clone_function? (check
   // https://github.com/NervanaSystems/ngraph/pull/3773 is merged)
   m_function = function;
@@ -143,6 +201,40 @@ HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
     }
   }
 
+  if (std::getenv("MAX_POOL_WINDOWS_IN_FLIGHT") != nullptr) {
+    m_max_pool_windows_in_flight =
+        std::stoul(std::getenv("MAX_POOL_WINDOWS_IN_FLIGHT"));
+  }
+
+  if (std::getenv("CONVOLUTION_PLAN_MAX_ENTRIES") != nullptr) {
+    m_max_convolution_plan_entries =
+        std::stoul(std::getenv("CONVOLUTION_PLAN_MAX_ENTRIES"));
+  }
+
+  if (std::getenv("CLIENT_SESSIONS") != nullptr) {
+    m_client_sessions = std::stoul(std::getenv("CLIENT_SESSIONS"));
+    NGRAPH_CHECK(m_client_sessions > 0, "CLIENT_SESSIONS must be positive");
+  }
+  m_client_session_threads = m_client_sessions;
+  if (std::getenv("CLIENT_SESSION_THREADS") != nullptr) {
+    m_client_session_threads =
+        std::max<size_t>(std::stoul(std::getenv("CLIENT_SESSION_THREADS")), 1);
+  }
+  if (std::getenv("CLIENT_SESSION_IDLE_MS") != nullptr) {
+    m_client_session_idle_ms =
+        std::stoul(std::getenv("CLIENT_SESSION_IDLE_MS"));
+  }
+
+  if (std::getenv("INTER_OP_THREADS") != nullptr) {
+    m_inter_op_threads =
+        std::max<size_t>(std::stoul(std::getenv("INTER_OP_THREADS")), 1);
+  }
+  // Concurrent ops run on the workers of the task runtime, which steal the
+  // kernel loops of any op, so ops need no thread budget of their own
+  if (std::getenv("INTRA_OP_THREADS") != nullptr) {
+    m_intra_op_threads = std::stoul(std::getenv("INTRA_OP_THREADS"));
+  }
+
   NGRAPH_HE_LOG(3) << "Running optimization passes";
   ngraph::pass::Manager pass_manager;
   pass_manager.set_pass_visualization(false);
@@ -190,12 +282,68 @@ HESealExecutable::~HESealExecutable() noexcept {
 
     // m_acceptor and m_io_context both free the socket? Avoid double-free
     try {
-      m_acceptor->close();
+      // Session executables are served over an already-accepted connection
+      if (m_acceptor != nullptr) {
+        m_acceptor->close();
+      }
     } catch (std::exception& e) {
       NGRAPH_ERR << "Exception closing m_acceptor " << e.what();
     }
+    end_session();
     m_acceptor = nullptr;
-    m_session = nullptr;
+  }
+}
+
+void HESealExecutable::end_session() {
+  // A session executable's connection outlives it, so messages arriving
+  // later must not reach the executable
+  if (m_acceptor == nullptr && m_session != nullptr) {
+    m_session->stop_reading();
+  }
+  m_session = nullptr;
+  m_server_setup = false;
+}
+
+std::string HESealExecutable::parameter_signature() const {
+  std::stringstream signature;
+  for (const auto& param : get_parameters()) {
+    signature << param->get_element_type() << " {" << param->get_shape()
+              << "} ";
+    if (HEOpAnnotations::has_he_annotation(*param)) {
+      signature << *HEOpAnnotations::he_op_annotation(*param);
+    }
+    signature << ";";
+  }
+  return signature.str();
+}
+
+void HESealExecutable::reset_session(const HESealExecutable& parent) {
+  m_batch_size = 1;
+  m_sent_inference_shape = false;
+  m_client_public_key_set = false;
+  m_client_eval_key_set = false;
+  m_client_inputs.clear();
+  m_client_outputs.clear();
+  m_relu_data.clear();
+  m_max_pool_data.clear();
+  m_relu_done_count = 0;
+  m_unknown_relu_idx.clear();
+  m_max_pool_done_count = 0;
+  m_minimum_done = false;
+  m_session_started = false;
+  m_client_inputs_received = false;
+  m_ciphertext_codec = default_ciphertext_codec();
+
+  // Calls update the parameter annotations from the inputs
+  const ParameterVector& parameters = parent.get_parameters();
+  const ParameterVector& session_parameters = get_parameters();
+  for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+    const auto& param = parameters[param_idx];
+    if (HEOpAnnotations::has_he_annotation(*param)) {
+      session_parameters[param_idx]->set_op_annotations(
+          std::make_shared<HEOpAnnotations>(
+              *HEOpAnnotations::he_op_annotation(*param)));
+    }
   }
 }
 
@@ -211,6 +359,430 @@ void HESealExecutable::update_he_op_annotations() {
     m_wrapped_nodes.emplace_back(node);
   }
   set_parameters_and_results(*m_function);
+  set_client_aided_chain_indices();
+  set_image_row_strides();
+  set_index_plans();
+}
+
+void HESealExecutable::set_client_aided_chain_indices() {
+  m_client_aided_chain_indices.clear();
+  size_t first_chain_index = m_context->first_context_data()->chain_index();
+  const size_t unknown_depth = std::numeric_limits<size_t>::max();
+
+  // Number of rescaling operations along the longest path from the output
+  // of a node to the next client-aided operation or result, as seen by the
+  // node's arguments
+  std::unordered_map<const Node*, size_t> depths;
+  for (auto it = m_wrapped_nodes.rbegin(); it != m_wrapped_nodes.rend();
+       ++it) {
+    const Node& node = *it->get_node();
+    size_t depth = 0;
+    for (const auto& user : node.get_users()) {
+      auto user_depth = depths.find(user.get());
+      if (user_depth == depths.end() || user_depth->second == unknown_depth) {
+        depth = unknown_depth;
+        break;
+      }
+      depth = std::max(depth, user_depth->second);
+    }
+
+    bool client_aided = false;
+    switch (it->get_typeid()) {
+      case OP_TYPEID::BoundedRelu:
+      case OP_TYPEID::MaxPool:
+      case OP_TYPEID::Relu:
+        client_aided = m_enable_client;
+        break;
+      case OP_TYPEID::AvgPool:
+      case OP_TYPEID::Convolution:
+      case OP_TYPEID::Dot:
+      case OP_TYPEID::Multiply:
+        if (depth != unknown_depth) {
+          ++depth;
+        }
+        break;
+      case OP_TYPEID::Add:
+      case OP_TYPEID::Broadcast:
+      case OP_TYPEID::BroadcastLike:
+      case OP_TYPEID::Concat:
+      case OP_TYPEID::Constant:
+      case OP_TYPEID::Negative:
+      case OP_TYPEID::Pad:
+      case OP_TYPEID::Parameter:
+      case OP_TYPEID::Reshape:
+      case OP_TYPEID::Reverse:
+      case OP_TYPEID::Slice:
+      case OP_TYPEID::Subtract:
+      case OP_TYPEID::Sum:
+        break;
+      case OP_TYPEID::Result:
+        depth = 0;
+        break;
+      default:
+        depth = unknown_depth;
+        break;
+    }
+
+    if (client_aided) {
+      // Each rescaling operation needs a level to rescale to
+      size_t chain_index = depth;
+      if (depth == unknown_depth || chain_index > first_chain_index) {
+        chain_index = first_chain_index;
+      }
+      m_client_aided_chain_indices[&node] = chain_index;
+      NGRAPH_HE_LOG(4) << "Client re-encrypts " << node.get_name()
+                       << " at chain index " << chain_index;
+      // The client's re-encryption refreshes the levels
+      depth = 0;
+    }
+    depths[&node] = depth;
+  }
+}
+
+size_t HESealExecutable::client_aided_chain_index(const Node& node) const {
+  auto chain_index = m_client_aided_chain_indices.find(&node);
+  if (chain_index == m_client_aided_chain_indices.end()) {
+    return m_context->first_context_data()->chain_index();
+  }
+  return chain_index->second;
+}
+
+namespace {
+/// \brief Returns whether or not a Convolution can be computed on an image
+/// packed tensor, keeping the tensor's row stride. The output must be no
+/// larger than the image, so the row stride and slot count also fit the
+/// output
+bool packed_image_convolution(const Node& node) {
+  const auto* conv = dynamic_cast<const op::Convolution*>(&node);
+  if (conv == nullptr ||
+      dynamic_cast<const op::Constant*>(
+          node.get_input_node_shared_ptr(1).get()) == nullptr) {
+    return false;
+  }
+  const Shape& in_shape = node.get_input_shape(0);
+  const Shape& out_shape = node.get_output_shape(0);
+  auto is_one = [](size_t value) { return value == 1; };
+  auto non_negative = [](std::ptrdiff_t value) { return value >= 0; };
+  const Strides& strides = conv->get_window_movement_strides();
+  const Strides& dilations = conv->get_window_dilation_strides();
+  const Strides& data_dilations = conv->get_data_dilation_strides();
+  const CoordinateDiff& padding_below = conv->get_padding_below();
+  const CoordinateDiff& padding_above = conv->get_padding_above();
+  return in_shape.size() == 4 && in_shape[0] == 1 &&
+         std::all_of(strides.begin(), strides.end(), is_one) &&
+         std::all_of(dilations.begin(), dilations.end(), is_one) &&
+         std::all_of(data_dilations.begin(), data_dilations.end(), is_one) &&
+         std::all_of(padding_below.begin(), padding_below.end(),
+                     non_negative) &&
+         std::all_of(padding_above.begin(), padding_above.end(),
+                     non_negative) &&
+         out_shape[2] <= in_shape[2] && out_shape[3] <= in_shape[3];
+}
+}  // namespace
+
+void HESealExecutable::set_image_row_strides() {
+  m_image_row_strides.clear();
+  if (!m_packed_image_convolution || complex_packing()) {
+    return;
+  }
+
+  // Ops which may take an image packed tensor as their first argument:
+  // Results, and packed image convolutions whose output may be image packed
+  std::unordered_set<const Node*> image_users;
+  auto image_output_allowed = [&](const Node& node) {
+    const auto users = node.get_users();
+    for (const auto& user : users) {
+      if (image_users.count(user.get()) == 0 ||
+          user->get_input_node_shared_ptr(0).get() != &node ||
+          (user->get_input_size() > 1 &&
+           user->get_input_node_shared_ptr(1).get() == &node)) {
+        return false;
+      }
+    }
+    return !users.empty();
+  };
+  for (auto it = m_wrapped_nodes.rbegin(); it != m_wrapped_nodes.rend();
+       ++it) {
+    const Node& node = *it->get_node();
+    if (it->get_typeid() == OP_TYPEID::Result ||
+        (packed_image_convolution(node) && image_output_allowed(node))) {
+      image_users.insert(&node);
+    }
+  }
+
+  const size_t slot_count = m_he_seal_backend.get_ckks_encoder()->slot_count();
+  for (const NodeWrapper& wrapper : m_wrapped_nodes) {
+    const Node& node = *wrapper.get_node();
+    if (wrapper.get_typeid() == OP_TYPEID::Parameter) {
+      const Shape& shape = node.get_output_shape(0);
+      const auto& param_op = *wrapper.get_op();
+      const auto users = node.get_users();
+      bool any_convolution =
+          std::any_of(users.begin(), users.end(), [](const auto& user) {
+            return dynamic_cast<const op::Convolution*>(user.get()) != nullptr;
+          });
+      if (shape.size() == 4 && shape[0] == 1 &&
+          shape[2] * shape[3] <= slot_count &&
+          HEOpAnnotations::has_he_annotation(param_op) &&
+          HEOpAnnotations::he_op_annotation(param_op)->encrypted() &&
+          !HEOpAnnotations::he_op_annotation(param_op)->packed() &&
+          any_convolution && image_output_allowed(node)) {
+        m_image_row_strides[&node] = shape[3];
+      }
+    } else if (wrapper.get_typeid() == OP_TYPEID::Convolution &&
+               image_users.count(&node) != 0) {
+      size_t row_stride = image_row_stride(*node.get_input_node_shared_ptr(0));
+      if (row_stride != 0) {
+        m_image_row_strides[&node] = row_stride;
+      }
+    }
+  }
+  for (const auto& [image_node, row_stride] : m_image_row_strides) {
+    NGRAPH_HE_LOG(3) << "Image packing " << image_node->get_name()
+                     << " with row stride " << row_stride;
+  }
+}
+
+size_t HESealExecutable::image_row_stride(const Node& node) const {
+  auto row_stride = m_image_row_strides.find(&node);
+  return row_stride == m_image_row_strides.end() ? 0 : row_stride->second;
+}
+
+const Node* HESealExecutable::op_cache_key(const Node& node) const {
+  auto key = m_op_cache_keys.find(&node);
+  return key == m_op_cache_keys.end() ? &node : key->second;
+}
+
+void HESealExecutable::set_index_plans() {
+  // Tensors are packed as annotated by their producing op
+  auto annotated_shape = [](const Node& node, const Shape& shape) {
+    const auto* op = dynamic_cast<const ngraph::op::Op*>(&node);
+    if (op != nullptr && HEOpAnnotations::has_he_annotation(*op) &&
+        HEOpAnnotations::he_op_annotation(*op)->packed()) {
+      return HETensor::pack_shape(shape);
+    }
+    return shape;
+  };
+
+  size_t plan_byte_count = 0;
+  for (NodeWrapper& wrapper : m_wrapped_nodes) {
+    const Node& node = *wrapper.get_node();
+    OP_TYPEID type_id = wrapper.get_typeid();
+    if (type_id == OP_TYPEID::Convolution && image_row_stride(node) != 0) {
+      // Packed image convolutions use rotations instead
+      wrapper.set_index_plan(nullptr);
+      continue;
+    }
+    std::vector<Shape> arg_shapes;
+    Shape out_shape;
+    if (type_id == OP_TYPEID::MaxPool && m_enable_client) {
+      // Matches handle_server_max_pool_op
+      arg_shapes.emplace_back(node.get_input_shape(0));
+      out_shape = HETensor::pack_shape(node.get_output_shape(0));
+    } else {
+      size_t arg_count = 1;
+      if (type_id == OP_TYPEID::Convolution) {
+        arg_count = 2;
+      } else if (type_id == OP_TYPEID::Concat) {
+        arg_count = node.get_input_size();
+      }
+      for (size_t arg_idx = 0;
+           arg_idx < arg_count && arg_idx < node.get_input_size(); ++arg_idx) {
+        arg_shapes.emplace_back(
+            annotated_shape(*node.get_input_node_shared_ptr(arg_idx),
+                            node.get_input_shape(arg_idx)));
+      }
+      out_shape = annotated_shape(node, node.get_output_shape(0));
+    }
+
+    const Node* key = op_cache_key(node);
+    std::shared_ptr<const IndexPlan> plan;
+    {
+      std::lock_guard<std::mutex> guard(m_op_caches->mutex);
+      auto cached_plan = m_op_caches->index_plans.find(key);
+      if (cached_plan != m_op_caches->index_plans.end() &&
+          cached_plan->second->matches(arg_shapes, out_shape)) {
+        plan = cached_plan->second;
+      }
+    }
+    if (plan == nullptr) {
+      // Unsupported attributes are reported when the op is called
+      try {
+        plan = build_index_plan(wrapper, arg_shapes, out_shape,
+                                m_max_convolution_plan_entries);
+      } catch (const std::exception& e) {
+        NGRAPH_HE_LOG(3) << "Not building index plan of " << node.get_name()
+                         << ": " << e.what();
+      }
+      if (plan != nullptr) {
+        ++m_op_caches->index_plan_build_count;
+        std::lock_guard<std::mutex> guard(m_op_caches->mutex);
+        m_op_caches->index_plans[key] = plan;
+      }
+    }
+    if (plan != nullptr) {
+      plan_byte_count += plan->byte_count();
+    }
+    wrapper.set_index_plan(plan);
+  }
+  NGRAPH_HE_LOG(3) << "Index plans use " << plan_byte_count << " bytes";
+}
+
+std::shared_ptr<const IndexPlan> HESealExecutable::get_index_plan(
+    const NodeWrapper& node_wrapper, const std::vector<Shape>& arg_shapes,
+    const Shape& out_shape) const {
+  std::shared_ptr<const IndexPlan> plan = node_wrapper.get_index_plan();
+  if (plan != nullptr && plan->matches(arg_shapes, out_shape)) {
+    return plan;
+  }
+  NGRAPH_HE_LOG(3) << "Building index plan of "
+                   << node_wrapper.get_node()->get_name() << " for output "
+                   << out_shape;
+  plan = build_index_plan(node_wrapper, arg_shapes, out_shape,
+                          std::numeric_limits<size_t>::max());
+  NGRAPH_CHECK(plan != nullptr, "Op ", node_wrapper.get_node()->get_name(),
+               " has no index plan");
+  ++m_op_caches->index_plan_build_count;
+  return plan;
+}
+
+std::shared_ptr<const IndexPlan> HESealExecutable::build_index_plan(
+    const NodeWrapper& node_wrapper, const std::vector<Shape>& arg_shapes,
+    const Shape& out_shape, size_t max_convolution_plan_entries) {
+  const Node& node = *node_wrapper.get_node();
+  switch (node_wrapper.get_typeid()) {
+    case OP_TYPEID::AvgPool: {
+      const auto* avg_pool = static_cast<const op::AvgPool*>(&node);
+      return std::make_shared<IndexPlan>(avg_pool_seal_index_plan(
+          arg_shapes[0], out_shape, avg_pool->get_window_shape(),
+          avg_pool->get_window_movement_strides(),
+          avg_pool->get_padding_below(), avg_pool->get_padding_above(),
+          avg_pool->get_include_padding_in_avg_computation()));
+    }
+    case OP_TYPEID::Broadcast: {
+      const auto* broadcast = static_cast<const op::Broadcast*>(&node);
+      return std::make_shared<IndexPlan>(broadcast_seal_index_plan(
+          arg_shapes[0], out_shape, broadcast->get_broadcast_axes()));
+    }
+    case OP_TYPEID::Concat: {
+      const auto* concat = static_cast<const op::Concat*>(&node);
+      return std::make_shared<IndexPlan>(concat_seal_index_plan(
+          arg_shapes, out_shape, concat->get_concatenation_axis()));
+    }
+    case OP_TYPEID::Convolution: {
+      size_t entry_count =
+          convolution_seal_plan_entry_count(arg_shapes[1], out_shape);
+      if (entry_count > max_convolution_plan_entries) {
+        NGRAPH_HE_LOG(3) << "Not building index plan of " << node.get_name()
+                         << " with up to " << entry_count << " entries";
+        return nullptr;
+      }
+      const auto* c = static_cast<const op::Convolution*>(&node);
+      return std::make_shared<IndexPlan>(convolution_seal_index_plan(
+          arg_shapes[0], arg_shapes[1], out_shape,
+          c->get_window_movement_strides(), c->get_window_dilation_strides(),
+          c->get_padding_below(), c->get_padding_above(),
+          c->get_data_dilation_strides(), 0, 1, 1, 0, 0, 1, false));
+    }
+    case OP_TYPEID::MaxPool: {
+      const auto* max_pool = static_cast<const op::MaxPool*>(&node);
+      return std::make_shared<IndexPlan>(max_pool_seal_index_plan(
+          arg_shapes[0], out_shape, max_pool->get_window_shape(),
+          max_pool->get_window_movement_strides(),
+          max_pool->get_padding_below(), max_pool->get_padding_above()));
+    }
+    case OP_TYPEID::Pad: {
+      const auto* pad = static_cast<const op::Pad*>(&node);
+      return std::make_shared<IndexPlan>(pad_seal_index_plan(
+          arg_shapes[0], out_shape, pad->get_padding_below(),
+          pad->get_padding_above(), pad->get_pad_mode()));
+    }
+    case OP_TYPEID::Reshape: {
+      const auto* reshape = static_cast<const op::Reshape*>(&node);
+      return std::make_shared<IndexPlan>(reshape_seal_index_plan(
+          arg_shapes[0], reshape->get_input_order(), out_shape));
+    }
+    case OP_TYPEID::Reverse: {
+      const auto* reverse = static_cast<const op::Reverse*>(&node);
+      return std::make_shared<IndexPlan>(reverse_seal_index_plan(
+          arg_shapes[0], out_shape, reverse->get_reversed_axes()));
+    }
+    case OP_TYPEID::Slice: {
+      const auto* slice = static_cast<const op::Slice*>(&node);
+      const Shape& in_shape = arg_shapes[0];
+      Coordinate upper_bounds = slice->get_upper_bounds();
+      // Packed tensors hold the whole batch in the first coordinate
+      if (!upper_bounds.empty() && (upper_bounds[0] > in_shape[0])) {
+        NGRAPH_CHECK(upper_bounds[0] == node.get_output_shape(0)[0],
+                     "Slice upper bound shape ", upper_bounds,
+                     " is not compatible with tensor output shape ",
+                     node.get_output_shape(0));
+        upper_bounds[0] = 1;
+      }
+      return std::make_shared<IndexPlan>(
+          slice_seal_index_plan(in_shape, slice->get_lower_bounds(),
+                                upper_bounds, slice->get_strides(), out_shape));
+    }
+    default:
+      return nullptr;
+  }
+}
+
+std::vector<int> HESealExecutable::galois_steps() {
+  std::set<int> steps;
+  for (const NodeWrapper& wrapper : m_wrapped_nodes) {
+    const Node& node = *wrapper.get_node();
+    switch (wrapper.get_typeid()) {
+      case OP_TYPEID::Convolution: {
+        if (complex_packing()) {
+          steps.insert(0);
+        }
+        size_t row_stride = image_row_stride(node);
+        if (row_stride != 0) {
+          const auto* conv = static_cast<const op::Convolution*>(&node);
+          for (int step : convolution_packed_image_rotation_steps(
+                   node.get_input_shape(1), conv->get_padding_below(),
+                   row_stride)) {
+            steps.insert(step);
+          }
+        }
+        break;
+      }
+      case OP_TYPEID::Multiply:
+      case OP_TYPEID::Power: {
+        if (complex_packing()) {
+          steps.insert(0);
+        }
+        break;
+      }
+      case OP_TYPEID::Dot: {
+        if (complex_packing()) {
+          steps.insert(0);
+        }
+        const auto* dot = static_cast<const op::Dot*>(&node);
+        auto vector_op = std::dynamic_pointer_cast<ngraph::op::Op>(
+            node.get_input_node_shared_ptr(0));
+        auto matrix_op = std::dynamic_pointer_cast<ngraph::op::Op>(
+            node.get_input_node_shared_ptr(1));
+        bool packed_vector = vector_op != nullptr &&
+                             plaintext_packed(*vector_op) &&
+                             (matrix_op == nullptr ||
+                              !plaintext_packed(*matrix_op));
+        const Shape& matrix_shape = node.get_input_shape(1);
+        if (packed_vector && dot->get_reduction_axes_count() == 1 &&
+            node.get_input_shape(0).size() == 1 && matrix_shape.size() == 2) {
+          for (int step :
+               dot_diagonal_rotation_steps(matrix_shape[0], matrix_shape[1])) {
+            steps.insert(step);
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return std::vector<int>(steps.begin(), steps.end());
 }
 
 void HESealExecutable::set_batch_size(size_t batch_size) {
@@ -225,6 +797,22 @@ void HESealExecutable::set_batch_size(size_t batch_size) {
   NGRAPH_HE_LOG(5) << "Server set batch size to " << m_batch_size;
 }
 
+SealPlaintextCache* HESealExecutable::get_constant_cache(const Node& node,
+                                                        size_t input_idx) {
+  const Node* input_node = node.input(input_idx).get_source_output().get_node();
+  if (dynamic_cast<const op::Constant*>(input_node) == nullptr) {
+    return nullptr;
+  }
+  // Session executables call clones of the nodes, so are keyed by the
+  // parent's nodes
+  std::lock_guard<std::mutex> guard(m_op_caches->mutex);
+  auto& cache = m_op_caches->constant_caches[op_cache_key(*input_node)];
+  if (cache == nullptr) {
+    cache = std::make_unique<SealPlaintextCache>();
+  }
+  return cache.get();
+}
+
 void HESealExecutable::check_client_supports_function() {
   // Check if single parameter is from client
   size_t from_client_count = 0;
@@ -246,18 +834,27 @@ bool HESealExecutable::server_setup() {
 
     check_client_supports_function();
 
-    NGRAPH_HE_LOG(1) << "Starting server";
-    start_server();
+    if (m_session == nullptr) {
+      NGRAPH_HE_LOG(1) << "Starting server";
+      start_server();
+    }
 
     std::stringstream param_stream;
     m_he_seal_backend.get_encryption_parameters().save(param_stream);
 
     pb::EncryptionParameters proto_parms;
     *proto_parms.mutable_encryption_parameters() = param_stream.str();
+    // The client only generates the Galois keys the function uses
+    for (int step : galois_steps()) {
+      proto_parms.add_galois_steps(step);
+    }
+    // Seeded ciphertexts are expanded when loaded
+    proto_parms.set_seeded_ciphertexts(true);
 
     pb::TCPMessage proto_msg;
     *proto_msg.mutable_encryption_parameters() = proto_parms;
     proto_msg.set_type(pb::TCPMessage_Type_RESPONSE);
+    add_supported_ciphertext_codecs(proto_msg);
 
     TCPMessage parms_message(std::move(proto_msg));
     NGRAPH_HE_LOG(3) << "Server waiting until session started";
@@ -290,7 +887,8 @@ void HESealExecutable::accept_connection() {
         if (!ec) {
           NGRAPH_HE_LOG(1) << "Connection accepted";
           m_session =
-              std::make_shared<TCPSession>(std::move(socket), server_callback);
+              std::make_shared<TCPSession>(std::move(socket), server_callback,
+                                           m_he_seal_backend.get_context());
           m_session->start();
           NGRAPH_HE_LOG(1) << "Session started";
 
@@ -304,7 +902,7 @@ void HESealExecutable::accept_connection() {
       });
 }
 
-void HESealExecutable::start_server() {
+void HESealExecutable::open_acceptor() {
   boost::asio::ip::tcp::resolver resolver(m_io_context);
   boost::asio::ip::tcp::endpoint server_endpoints(boost::asio::ip::tcp::v4(),
                                                   m_port);
@@ -312,15 +910,268 @@ void HESealExecutable::start_server() {
       m_io_context, server_endpoints);
   boost::asio::socket_base::reuse_address option(true);
   m_acceptor->set_option(option);
+}
 
+void HESealExecutable::start_server() {
+  open_acceptor();
   accept_connection();
   m_message_handling_thread = std::thread([this]() {
     try {
       m_io_context.run();
     } catch (std::exception& e) {
-      NGRAPH_CHECK(false, "Server error hanndling thread: ", e.what());
+      NGRAPH_CHECK(false, "Server error handling thread: ", e.what());
+    }
+  });
+}
+
+void HESealExecutable::start_session(boost::asio::ip::tcp::socket socket) {
+  auto server_callback =
+      std::bind(&HESealExecutable::handle_message, this, std::placeholders::_1);
+  m_session = std::make_shared<TCPSession>(std::move(socket), server_callback,
+                                           m_he_seal_backend.get_context());
+  m_session->start();
+  NGRAPH_HE_LOG(1) << "Session started";
+
+  std::lock_guard<std::mutex> guard(m_session_mutex);
+  m_session_started = true;
+  m_session_cond.notify_one();
+}
+
+bool HESealExecutable::call_client_sessions(
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
+  check_client_supports_function();
+
+  // Sessions of a previous call must release the I/O thread before it is
+  // restarted
+  if (m_message_handling_thread.joinable()) {
+    m_message_handling_thread.join();
+    m_io_context.restart();
+  }
+  if (m_acceptor == nullptr) {
+    open_acceptor();
+  }
+  m_server_setup = true;
+
+  // State shared with the helpers posted to the task runtime and with the
+  // handlers on the I/O thread, either of which may run after the call has
+  // returned. Both only touch the locals of the call while accepting, or while
+  // a socket is queued
+  struct SessionQueue {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<boost::asio::ip::tcp::socket> sockets;
+    size_t max_running{1};
+    size_t accepted_count{0};
+    size_t running_count{0};
+    size_t helper_count{0};
+    size_t failed_count{0};
+    bool accepting{true};
+  };
+  auto queue = std::make_shared<SessionQueue>();
+  queue->max_running = std::min(m_client_session_threads, m_client_sessions);
+  boost::asio::steady_timer idle_timer(m_io_context);
+
+  // Runs on the I/O thread
+  auto stop_accepting = [this, queue]() {
+    {
+      std::lock_guard<std::mutex> guard(queue->mutex);
+      if (!queue->accepting) {
+        return;
+      }
+      queue->accepting = false;
+    }
+    m_acceptor->cancel();
+    queue->cond.notify_all();
+    NGRAPH_HE_LOG(1) << "Server stopped accepting client sessions";
+  };
+
+  // Runs on the I/O thread once no session is queued or running
+  size_t idle_ms = m_client_session_idle_ms;
+  auto arm_idle_timer = [queue, &idle_timer, idle_ms, stop_accepting]() {
+    {
+      std::lock_guard<std::mutex> guard(queue->mutex);
+      if (!queue->accepting || !queue->sockets.empty() ||
+          queue->running_count > 0) {
+        return;
+      }
+    }
+    idle_timer.expires_after(std::chrono::milliseconds(idle_ms));
+    idle_timer.async_wait(
+        [stop_accepting](const boost::system::error_code& ec) {
+          if (!ec) {
+            stop_accepting();
+          }
+        });
+  };
+
+  // Runs accepted sessions until none is queued, or, if wait is set, until
+  // accepting has stopped and every session has finished
+  auto serve_sessions = [this, queue, arm_idle_timer, &outputs,
+                         &server_inputs](bool wait) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    while (true) {
+      if (!queue->sockets.empty() &&
+          queue->running_count < queue->max_running) {
+        boost::asio::ip::tcp::socket socket(std::move(queue->sockets.front()));
+        queue->sockets.pop_front();
+        ++queue->running_count;
+        lock.unlock();
+
+        bool failed = false;
+        try {
+          run_client_session(std::move(socket), outputs, server_inputs);
+        } catch (const std::exception& e) {
+          NGRAPH_ERR << "Error serving client session: " << e.what();
+          failed = true;
+        }
+
+        lock.lock();
+        if (failed) {
+          ++queue->failed_count;
+        }
+        if (--queue->running_count == 0 && queue->sockets.empty() &&
+            queue->accepting) {
+          boost::asio::post(m_io_context, arm_idle_timer);
+        }
+        queue->cond.notify_all();
+        continue;
+      }
+      if (!wait || (!queue->accepting && queue->sockets.empty() &&
+                    queue->running_count == 0)) {
+        return;
+      }
+      queue->cond.wait(lock);
+    }
+  };
+
+  std::function<void()> accept_session = [&]() {
+    m_acceptor->async_accept([this, queue, &idle_timer, stop_accepting,
+                              serve_sessions, &accept_session](
+                                 boost::system::error_code ec,
+                                 boost::asio::ip::tcp::socket socket) {
+      if (ec == boost::asio::error::operation_aborted) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> guard(queue->mutex);
+        if (!queue->accepting) {
+          NGRAPH_HE_LOG(1) << "Dropping client connected after accepting "
+                              "stopped";
+          return;
+        }
+      }
+      if (ec) {
+        NGRAPH_ERR << "error accepting connection " << ec.message();
+        accept_session();
+        return;
+      }
+      idle_timer.cancel();
+      size_t accepted_count;
+      {
+        std::lock_guard<std::mutex> guard(queue->mutex);
+        queue->sockets.emplace_back(std::move(socket));
+        accepted_count = ++queue->accepted_count;
+        // The calling thread serves sessions too, so helpers only add the
+        // remaining concurrency
+        if (queue->helper_count + 1 < queue->max_running) {
+          ++queue->helper_count;
+          TaskRuntime::global().post([queue, serve_sessions]() {
+            serve_sessions(false);
+            std::lock_guard<std::mutex> guard(queue->mutex);
+            --queue->helper_count;
+          });
+        }
+      }
+      queue->cond.notify_all();
+      NGRAPH_HE_LOG(1) << "Accepted client session " << accepted_count
+                       << " of at most " << m_client_sessions;
+      if (accepted_count < m_client_sessions) {
+        accept_session();
+      } else {
+        stop_accepting();
+      }
+    });
+  };
+  NGRAPH_HE_LOG(1) << "Server accepting up to " << m_client_sessions
+                   << " client sessions";
+  accept_session();
+  m_message_handling_thread = std::thread([this]() {
+    try {
+      m_io_context.run();
+    } catch (std::exception& e) {
+      NGRAPH_CHECK(false, "Server error handling thread: ", e.what());
     }
   });
+
+  serve_sessions(true);
+
+  std::lock_guard<std::mutex> guard(queue->mutex);
+  NGRAPH_HE_LOG(1) << "Served " << queue->accepted_count
+                   << " client sessions (" << queue->failed_count
+                   << " failed)";
+  return queue->failed_count == 0;
+}
+
+void HESealExecutable::run_client_session(
+    boost::asio::ip::tcp::socket socket,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
+  // Session executables are compiled once per parameter signature, and
+  // reused by later sessions
+  std::string signature = parameter_signature();
+  SessionExecutable session;
+  {
+    std::lock_guard<std::mutex> guard(m_session_executables_mutex);
+    auto cached = m_session_executables.find(signature);
+    if (cached != m_session_executables.end()) {
+      session = std::move(cached->second);
+      m_session_executables.erase(cached);
+    }
+  }
+  if (session.executable == nullptr) {
+    NGRAPH_HE_LOG(3) << "Compiling session executable";
+    // Keys provided by the client are only set on the session's backend
+    session.backend = m_he_seal_backend.clone_for_session();
+    session.executable = std::unique_ptr<HESealExecutable>(
+        new HESealExecutable(*this, *session.backend));
+  } else {
+    NGRAPH_HE_LOG(3) << "Reusing session executable";
+    // Drop the keys of the previous client
+    *session.backend = m_he_seal_backend;
+    session.executable->reset_session(*this);
+  }
+  std::shared_ptr<HESealBackend> session_backend = session.backend;
+  HESealExecutable& session_executable = *session.executable;
+  session_executable.start_session(std::move(socket));
+
+  // Server inputs are packed and encrypted in-place, so each session uses its
+  // own copy
+  std::vector<std::shared_ptr<runtime::Tensor>> session_inputs;
+  session_inputs.reserve(server_inputs.size());
+  for (const auto& input : server_inputs) {
+    auto he_input = std::static_pointer_cast<HETensor>(input);
+    auto session_input =
+        std::static_pointer_cast<HETensor>(session_backend->create_plain_tensor(
+            he_input->get_element_type(), he_input->get_shape(),
+            he_input->is_packed()));
+    session_input->data() = he_input->data();
+    session_inputs.emplace_back(session_input);
+  }
+  // The result is encrypted with the client's keys and sent to the client, so
+  // the session writes its own outputs rather than the caller's
+  std::vector<std::shared_ptr<runtime::Tensor>> session_outputs;
+  session_outputs.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    session_outputs.emplace_back(session_backend->create_cipher_tensor(
+        output->get_element_type(), output->get_shape()));
+  }
+
+  session_executable.call(session_outputs, session_inputs);
+  session_executable.end_session();
+
+  std::lock_guard<std::mutex> guard(m_session_executables_mutex);
+  m_session_executables.emplace(std::move(signature), std::move(session));
 }
 
 void HESealExecutable::load_public_key(const pb::TCPMessage& proto_msg) {
@@ -344,9 +1195,64 @@ void HESealExecutable::load_eval_key(const pb::TCPMessage& proto_msg) {
   keys.load(m_context, key_stream);
   m_he_seal_backend.set_relin_keys(keys);
 
+  const std::string& galois_str = proto_msg.eval_key().galois_keys();
+  if (!galois_str.empty()) {
+    seal::GaloisKeys galois_keys;
+    std::stringstream galois_stream(galois_str);
+    galois_keys.load(m_context, galois_stream);
+    m_he_seal_backend.set_galois_keys(galois_keys, galois_steps());
+  }
+
+  m_client_eval_key_set = true;
+}
+
+void HESealExecutable::resume_client_keys(const pb::TCPMessage& proto_msg) {
+  const std::string& fingerprint = proto_msg.key_fingerprint().fingerprint();
+  auto keys = m_he_seal_backend.client_key_cache().find(fingerprint);
+  std::vector<int> steps = galois_steps();
+  bool has_steps =
+      keys != nullptr &&
+      std::includes(keys->galois_steps.begin(), keys->galois_steps.end(),
+                    steps.begin(), steps.end());
+  if (!has_steps) {
+    NGRAPH_HE_LOG(3) << "Client keys not cached; requesting keys";
+    pb::TCPMessage request;
+    request.set_type(pb::TCPMessage_Type_REQUEST);
+    *request.mutable_key_fingerprint() = proto_msg.key_fingerprint();
+    m_session->write_message(TCPMessage(std::move(request)));
+    return;
+  }
+
+  NGRAPH_HE_LOG(3) << "Using cached client keys";
+  m_he_seal_backend.set_public_key(keys->public_key);
+  m_he_seal_backend.set_relin_keys(keys->relin_keys);
+  if (keys->galois_keys != nullptr) {
+    m_he_seal_backend.set_galois_keys(keys->galois_keys, keys->galois_steps);
+  }
+  m_client_public_key_set = true;
   m_client_eval_key_set = true;
 }
 
+void HESealExecutable::cache_client_keys(const pb::TCPMessage& proto_msg) {
+  const std::string& fingerprint = proto_msg.key_fingerprint().fingerprint();
+  const std::string& galois_str = proto_msg.eval_key().galois_keys();
+  if (client_key_fingerprint(proto_msg.public_key().public_key(),
+                             proto_msg.eval_key().eval_key(),
+                             galois_str) != fingerprint) {
+    NGRAPH_WARN << "Client key fingerprint does not match keys; not caching";
+    return;
+  }
+
+  auto keys = std::make_shared<SealClientKeys>();
+  keys->public_key = m_he_seal_backend.get_public_key();
+  keys->relin_keys = m_he_seal_backend.get_relin_keys();
+  if (!galois_str.empty()) {
+    keys->galois_keys = m_he_seal_backend.get_galois_keys();
+    keys->galois_steps = galois_steps();
+  }
+  m_he_seal_backend.client_key_cache().insert(fingerprint, std::move(keys));
+}
+
 void HESealExecutable::send_inference_shape() {
   m_sent_inference_shape = true;
 
@@ -394,7 +1300,9 @@ void HESealExecutable::send_inference_shape() {
   m_session->write_message(std::move(execute_msg));
 }
 
-void HESealExecutable::handle_relu_result(const pb::TCPMessage& proto_msg) {
+void HESealExecutable::handle_relu_result(
+    const pb::TCPMessage& proto_msg,
+    const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Server handling relu result";
   std::lock_guard<std::mutex> guard(m_relu_mutex);
 
@@ -403,47 +1311,55 @@ void HESealExecutable::handle_relu_result(const pb::TCPMessage& proto_msg) {
                proto_msg.he_tensors_size());
 
   const auto& proto_tensor = proto_msg.he_tensors(0);
-  auto he_tensor = HETensor::load_from_proto_tensor(
-      proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
-      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-      *m_he_seal_backend.get_decryptor(),
-      m_he_seal_backend.get_encryption_parameters());
+  std::vector<HEType> results = HETensor::load_proto_chunk(
+      proto_tensor, m_he_seal_backend.get_context(), ciphertexts);
 
-  size_t result_count = proto_tensor.data_size();
+  // Chunks of the responses arrive in order of the requests
+  size_t result_count = results.size();
+  NGRAPH_CHECK(m_relu_done_count + result_count <= m_unknown_relu_idx.size(),
+               "Relu result with ", result_count, " elements out of range");
   for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
     m_relu_data[m_unknown_relu_idx[result_idx + m_relu_done_count]] =
-        he_tensor->data(result_idx);
+        std::move(results[result_idx]);
   }
   m_relu_done_count += result_count;
   m_relu_cond.notify_all();
 }
 
 void HESealExecutable::handle_bounded_relu_result(
-    const pb::TCPMessage& proto_msg) {
-  handle_relu_result(proto_msg);
+    const pb::TCPMessage& proto_msg,
+    const TCPMessage::ciphertext_list& ciphertexts) {
+  handle_relu_result(proto_msg, ciphertexts);
 }
 
-void HESealExecutable::handle_max_pool_result(const pb::TCPMessage& proto_msg) {
-  std::lock_guard<std::mutex> guard(m_max_pool_mutex);
-
+void HESealExecutable::handle_max_pool_result(
+    const pb::TCPMessage& proto_msg,
+    const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_CHECK(proto_msg.he_tensors_size() == 1,
                "Can only handle one tensor at a time, got ",
                proto_msg.he_tensors_size());
 
-  const auto& proto_tensor = proto_msg.he_tensors(0);
-  size_t result_count = proto_tensor.data_size();
+  // The request id is the index of the first window in the message
+  json js = json::parse(proto_msg.function().function());
+  size_t request_id = js.at("request_id");
 
-  NGRAPH_CHECK(result_count == 1, "Maxpool only supports result_count 1, got ",
-               result_count);
-
-  auto he_tensor = HETensor::load_from_proto_tensor(
-      proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
-      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-      *m_he_seal_backend.get_decryptor(),
-      m_he_seal_backend.get_encryption_parameters());
+  const auto& proto_tensor = proto_msg.he_tensors(0);
+  std::vector<HEType> results = HETensor::load_proto_chunk(
+      proto_tensor, m_he_seal_backend.get_context(), ciphertexts);
+  size_t result_count = results.size();
 
-  m_max_pool_data.emplace_back(he_tensor->data(0));
-  m_max_pool_done = true;
+  // Responses may be split into chunks, each storing the maxima of the
+  // windows starting at its offset
+  size_t first_window = request_id + proto_tensor.offset();
+  std::lock_guard<std::mutex> guard(m_max_pool_mutex);
+  NGRAPH_CHECK(first_window + result_count <= m_max_pool_data.size(),
+               "Maxpool result ", request_id, " with ", result_count,
+               " windows out of range");
+  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+    m_max_pool_data[first_window + result_idx] =
+        std::move(results[result_idx]);
+  }
+  m_max_pool_done_count += result_count;
   m_max_pool_cond.notify_all();
 }
 
@@ -455,12 +1371,23 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
 #pragma clang diagnostic ignored "-Wswitch-enum"
   switch (proto_msg->type()) {
     case pb::TCPMessage_Type_RESPONSE: {
+      if (proto_msg->ciphertext_codecs_size() > 0) {
+        m_ciphertext_codec = negotiate_ciphertext_codec(
+            m_ciphertext_codec, proto_msg->ciphertext_codecs());
+      }
       if (proto_msg->has_public_key()) {
         load_public_key(*proto_msg);
       }
       if (proto_msg->has_eval_key()) {
         load_eval_key(*proto_msg);
       }
+      if (proto_msg->has_key_fingerprint()) {
+        if (proto_msg->has_public_key() && proto_msg->has_eval_key()) {
+          cache_client_keys(*proto_msg);
+        } else {
+          resume_client_keys(*proto_msg);
+        }
+      }
       if (!m_sent_inference_shape && m_client_public_key_set &&
           m_client_eval_key_set) {
         send_inference_shape();
@@ -472,11 +1399,11 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
 
         auto name = js.at("function");
         if (name == "Relu") {
-          handle_relu_result(*proto_msg);
+          handle_relu_result(*proto_msg, message.ciphertexts());
         } else if (name == "BoundedRelu") {
-          handle_bounded_relu_result(*proto_msg);
+          handle_bounded_relu_result(*proto_msg, message.ciphertexts());
         } else if (name == "MaxPool") {
-          handle_max_pool_result(*proto_msg);
+          handle_max_pool_result(*proto_msg, message.ciphertexts());
         } else {
           throw ngraph_error("Unknown function name");
         }
@@ -485,7 +1412,7 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
     }
     case pb::TCPMessage_Type_REQUEST: {
       if (proto_msg->he_tensors_size() > 0) {
-        handle_client_ciphers(*proto_msg);
+        handle_client_ciphers(*proto_msg, message.ciphertexts());
       }
       break;
     }
@@ -496,7 +1423,9 @@ void HESealExecutable::handle_message(const TCPMessage& message) {
 #pragma clang diagnostic pop
 }
 
-void HESealExecutable::handle_client_ciphers(const pb::TCPMessage& proto_msg) {
+void HESealExecutable::handle_client_ciphers(
+    const pb::TCPMessage& proto_msg,
+    const TCPMessage::ciphertext_list& ciphertexts) {
   NGRAPH_HE_LOG(3) << "Handling client tensors";
 
   NGRAPH_CHECK(proto_msg.he_tensors_size() > 0,
@@ -548,13 +1477,14 @@ void HESealExecutable::handle_client_ciphers(const pb::TCPMessage& proto_msg) {
   if (m_client_inputs[param_idx] == nullptr) {
     auto he_tensor = HETensor::load_from_proto_tensor(
         proto_tensor, *m_he_seal_backend.get_ckks_encoder(),
-        m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-        *m_he_seal_backend.get_decryptor(),
-        m_he_seal_backend.get_encryption_parameters());
+        m_he_seal_backend.get_context(), m_he_seal_backend.get_encryptor(),
+        m_he_seal_backend.get_decryptor(),
+        m_he_seal_backend.get_encryption_parameters(), ciphertexts);
     m_client_inputs[param_idx] = he_tensor;
   } else {
     HETensor::load_from_proto_tensor(m_client_inputs[param_idx], proto_tensor,
-                                     m_he_seal_backend.get_context());
+                                     m_he_seal_backend.get_context(),
+                                     ciphertexts);
   }
 
   auto done_loading = [&]() {
@@ -602,6 +1532,10 @@ bool HESealExecutable::call(
   validate(outputs, server_inputs);
   NGRAPH_HE_LOG(3) << "HESealExecutable::call validated inputs";
 
+  if (m_enable_client && m_client_sessions > 1) {
+    return call_client_sessions(outputs, server_inputs);
+  }
+
   if (m_enable_client) {
     if (!server_setup()) {
       return false;
@@ -675,19 +1609,18 @@ bool HESealExecutable::call(
           NGRAPH_HE_LOG(3) << "Encrypting parameter " << param->get_name()
                            << " from server";
 
-#pragma omp parallel for
-          for (size_t he_type_idx = 0;
-               he_type_idx < he_input->get_batched_element_count();
-               ++he_type_idx) {
-            if (he_input->data(he_type_idx).is_plaintext()) {
-              auto cipher = HESealBackend::create_empty_ciphertext();
-              m_he_seal_backend.encrypt(
-                  cipher, he_input->data(he_type_idx).get_plaintext(),
-                  he_input->get_element_type(),
-                  he_input->data(he_type_idx).complex_packing());
-              he_input->data(he_type_idx).set_ciphertext(cipher);
-            }
-          }
+          parallel_for(
+              0, he_input->get_batched_element_count(),
+              [&](size_t he_type_idx) {
+                if (he_input->data(he_type_idx).is_plaintext()) {
+                  auto cipher = HESealBackend::create_empty_ciphertext();
+                  m_he_seal_backend.encrypt(
+                      cipher, he_input->data(he_type_idx).get_plaintext(),
+                      he_input->get_element_type(),
+                      he_input->data(he_type_idx).complex_packing());
+                  he_input->data(he_type_idx).set_ciphertext(cipher);
+                }
+              });
 
           NGRAPH_CHECK(he_input->is_packed() == current_annotation->packed(),
                        "Mismatch between tensor input and annotation (",
@@ -709,6 +1642,11 @@ bool HESealExecutable::call(
   NGRAPH_HE_LOG(3) << "Updating HE op annotations";
   update_he_op_annotations();
 
+  // Inputs may change which rotations are needed
+  if (!m_enable_client) {
+    m_he_seal_backend.generate_galois_keys(galois_steps());
+  }
+
   NGRAPH_HE_LOG(3) << "Converting outputs to HETensor";
   std::vector<std::shared_ptr<HETensor>> he_outputs;
   he_outputs.reserve(outputs.size());
@@ -719,15 +1657,19 @@ bool HESealExecutable::call(
   NGRAPH_HE_LOG(3) << "Mapping function parameters to HETensor";
   NGRAPH_CHECK(he_inputs.size() >= parameters.size(),
                "Not enough inputs in input map");
-  std::unordered_map<ngraph::descriptor::Tensor*, std::shared_ptr<HETensor>>
-      tensor_map;
+  TensorMap tensor_map;
   size_t input_count = 0;
   for (const auto& param : parameters) {
     for (size_t param_out_idx = 0; param_out_idx < param->get_output_size();
          ++param_out_idx) {
       descriptor::Tensor* tensor =
           param->get_output_tensor_ptr(param_out_idx).get();
-      tensor_map.insert({tensor, he_inputs[input_count++]});
+      std::shared_ptr<HETensor> he_input = he_inputs[input_count++];
+      size_t row_stride = image_row_stride(*param);
+      if (row_stride != 0) {
+        he_input = pack_image_input(*he_input, row_stride);
+      }
+      tensor_map.insert({tensor, he_input});
     }
   }
 
@@ -756,8 +1698,33 @@ bool HESealExecutable::call(
     tensor_map.insert({tv, he_output});
   }
 
+  TaskRuntime::ThreadBudgetScope thread_budget_scope(m_intra_op_threads);
+  if (m_inter_op_threads > 1) {
+    run_ops_concurrently(tensor_map);
+  } else {
+    run_ops_in_order(tensor_map);
+  }
+
+  size_t total_time = 0;
+  for (const auto& elem : m_timer_map) {
+    total_time += elem.second.get_milliseconds();
+  }
+  if (verbose_op("total")) {
+    NGRAPH_HE_LOG(3) << "\033[1;32m"
+                     << "Total time " << total_time << " (ms) \033[0m";
+  }
+
+  // Send outputs to client.
+  if (m_enable_client) {
+    send_client_results();
+  }
+  return true;
+}
+
+void HESealExecutable::run_ops_in_order(TensorMap& tensor_map) {
   // for each ordered op in the graph
-  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+  for (size_t node_idx = 0; node_idx < m_wrapped_nodes.size(); ++node_idx) {
+    const NodeWrapper& wrapped = m_wrapped_nodes[node_idx];
     auto op = wrapped.get_node();
     auto type_id = wrapped.get_typeid();
     bool verbose = verbose_op(*op);
@@ -786,11 +1753,8 @@ bool HESealExecutable::call(
     m_timer_map[op].start();
 
     // get op inputs from map
-    std::vector<std::shared_ptr<HETensor>> op_inputs;
-    for (auto input : op->inputs()) {
-      descriptor::Tensor* tensor = &input.get_tensor();
-      op_inputs.push_back(tensor_map.at(tensor));
-    }
+    std::vector<std::shared_ptr<HETensor>> op_inputs =
+        get_op_inputs(op, tensor_map);
 
     if (m_enable_client && type_id == OP_TYPEID::Result) {
       // Client outputs don't have decryption performed, so skip result op
@@ -799,64 +1763,8 @@ bool HESealExecutable::call(
     }
 
     // get op outputs from map or create
-    std::vector<std::shared_ptr<HETensor>> op_outputs;
-    for (size_t i = 0; i < op->get_output_size(); ++i) {
-      auto tensor = &op->output(i).get_tensor();
-      auto it = tensor_map.find(tensor);
-      if (it == tensor_map.end()) {
-        // The output tensor is not in the tensor map so create a new tensor
-        Shape shape = op->get_output_shape(i);
-        const element::Type& element_type = op->get_output_element_type(i);
-        std::string name = op->output(i).get_tensor().get_name();
-
-        NGRAPH_HE_LOG(3) << "Get output packing / encrypted";
-
-        // TODO(fboemer): remove case once Constant becomes an op
-        // (https://github.com/NervanaSystems/ngraph/pull/3752)
-        bool encrypted_out;
-        bool packed_out;
-        if (op->is_op()) {
-          std::shared_ptr<HEOpAnnotations> he_op_annotation =
-              HEOpAnnotations::he_op_annotation(
-                  *std::static_pointer_cast<const ngraph::op::Op>(op));
-          encrypted_out = he_op_annotation->encrypted();
-          packed_out = he_op_annotation->packed();
-        } else {
-          NGRAPH_WARN
-              << "Node " << op->get_name()
-              << " is not op, using default encrypted / packing behavior";
-          encrypted_out = std::any_of(
-              op_inputs.begin(), op_inputs.end(),
-              [](const std::shared_ptr<ngraph::he::HETensor>& op_input) {
-                return op_input->any_encrypted_data();
-              });
-          packed_out = std::any_of(
-              op_inputs.begin(), op_inputs.end(),
-              [](const std::shared_ptr<ngraph::he::HETensor>& he_tensor) {
-                return he_tensor->is_packed();
-              });
-        }
-        NGRAPH_HE_LOG(3) << "encrypted_out " << encrypted_out;
-        NGRAPH_HE_LOG(3) << "packed_out " << packed_out;
-        if (packed_out) {
-          HETensor::unpack_shape(shape, m_batch_size);
-        }
-        NGRAPH_HE_LOG(5) << "Creating output tensor with shape " << shape;
-
-        if (encrypted_out) {
-          auto out_tensor = std::static_pointer_cast<HETensor>(
-              m_he_seal_backend.create_cipher_tensor(element_type, shape,
-                                                     packed_out, name));
-          tensor_map.insert({tensor, out_tensor});
-        } else {
-          auto out_tensor = std::static_pointer_cast<HETensor>(
-              m_he_seal_backend.create_plain_tensor(element_type, shape,
-                                                    packed_out, name));
-          tensor_map.insert({tensor, out_tensor});
-        }
-      }
-      op_outputs.push_back(tensor_map.at(tensor));
-    }
+    std::vector<std::shared_ptr<HETensor>> op_outputs =
+        get_op_outputs(wrapped, op_inputs, tensor_map);
 
     // get op type
     element::Type base_type;
@@ -866,45 +1774,371 @@ bool HESealExecutable::call(
       base_type = op->get_inputs().at(0).get_tensor().get_element_type();
     }
 
-    generate_calls(base_type, wrapped, op_outputs, op_inputs);
-    m_timer_map[op].stop();
-
-    // delete any obsolete tensors
-    for (const descriptor::Tensor* t : op->liveness_free_list) {
-      bool erased = false;
-      for (auto it = tensor_map.begin(); it != tensor_map.end(); ++it) {
-        const std::string& it_name = it->second->get_name();
-        if (it_name == t->get_name()) {
-          tensor_map.erase(it);
-          erased = true;
-          break;
+    // Compute the next op on chunks of the ReLU result as they arrive from
+    // the client, rather than waiting for the entire result
+    std::shared_ptr<const Node> streamed_op = nullptr;
+    if (m_enable_client && m_stream_relu &&
+        (type_id == OP_TYPEID::Relu || type_id == OP_TYPEID::BoundedRelu) &&
+        node_idx + 1 < m_wrapped_nodes.size()) {
+      const NodeWrapper& next_wrapped = m_wrapped_nodes[node_idx + 1];
+      auto next_op = next_wrapped.get_node();
+      std::vector<std::shared_ptr<HETensor>> next_inputs =
+          get_op_inputs(next_op, tensor_map);
+      std::vector<std::shared_ptr<HETensor>> next_outputs =
+          get_op_outputs(next_wrapped, next_inputs, tensor_map);
+
+      if (can_stream_relu_into(next_wrapped, op_outputs[0], next_inputs,
+                               next_outputs)) {
+        if (verbose) {
+          NGRAPH_HE_LOG(3) << "Streaming " << op->get_name() << " into "
+                           << next_op->get_name();
         }
+        // The fused computation is booked to the streamed op, so both ops
+        // keep their own timer without counting it twice
+        m_timer_map[op].stop();
+        m_timer_map[next_op].start();
+        stream_server_relu_op(op_inputs[0], op_outputs[0], wrapped,
+                              next_wrapped, next_inputs, next_outputs);
+        m_timer_map[next_op].stop();
+        streamed_op = next_op;
       }
-      if (!erased) {
-        NGRAPH_DEBUG << "Failed to erase " << t->get_name()
-                     << " from tensor map";
-      }
     }
+    if (streamed_op == nullptr) {
+      generate_calls(base_type, wrapped, op_outputs, op_inputs);
+      m_timer_map[op].stop();
+    }
+
+    // delete any obsolete tensors, once only the tensor map references them
+    op_inputs.clear();
+    op_outputs.clear();
+    free_obsolete_tensors(*op, tensor_map);
     if (verbose) {
       NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
                        << m_timer_map[op].get_milliseconds() << "ms"
                        << "\033[0m";
     }
+
+    // The streamed op is already computed, so skip it
+    if (streamed_op != nullptr) {
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "\033[1;31m" << streamed_op->get_name()
+                         << " fused with " << op->get_name() << " took "
+                         << m_timer_map[streamed_op].get_milliseconds() << "ms"
+                         << "\033[0m";
+      }
+      free_obsolete_tensors(*streamed_op, tensor_map);
+      ++node_idx;
+    }
   }
-  size_t total_time = 0;
-  for (const auto& elem : m_timer_map) {
-    total_time += elem.second.get_milliseconds();
+}
+
+void HESealExecutable::run_ops_concurrently(TensorMap& tensor_map) {
+  NGRAPH_HE_LOG(3) << "Running ops on " << m_inter_op_threads << " threads";
+  std::unordered_map<const Node*, size_t> node_indices;
+  for (size_t node_idx = 0; node_idx < m_wrapped_nodes.size(); ++node_idx) {
+    node_indices[m_wrapped_nodes[node_idx].get_node().get()] = node_idx;
   }
-  if (verbose_op("total")) {
-    NGRAPH_HE_LOG(3) << "\033[1;32m"
-                     << "Total time " << total_time << " (ms) \033[0m";
+
+  // Tensors freed by liveness analysis are freed once every op using them has
+  // finished, since ops no longer finish in order
+  std::unordered_set<const descriptor::Tensor*> freed_tensors;
+  for (const NodeWrapper& wrapped : m_wrapped_nodes) {
+    for (const descriptor::Tensor* tensor :
+         wrapped.get_node()->liveness_free_list) {
+      freed_tensors.insert(tensor);
+    }
+  }
+  std::vector<std::vector<const descriptor::Tensor*>> node_tensors(
+      m_wrapped_nodes.size());
+  std::unordered_map<const descriptor::Tensor*, size_t> remaining_uses;
+
+  DAGScheduler scheduler(m_wrapped_nodes.size());
+  for (size_t node_idx = 0; node_idx < m_wrapped_nodes.size(); ++node_idx) {
+    const auto& node = m_wrapped_nodes[node_idx].get_node();
+    std::set<size_t> dependencies;
+    for (const auto& input : node->inputs()) {
+      auto it = node_indices.find(input.get_source_output().get_node());
+      if (it != node_indices.end()) {
+        dependencies.insert(it->second);
+      }
+    }
+    for (const auto& control_dependency : node->get_control_dependencies()) {
+      auto it = node_indices.find(control_dependency.get());
+      if (it != node_indices.end()) {
+        dependencies.insert(it->second);
+      }
+    }
+    for (size_t dependency_idx : dependencies) {
+      scheduler.add_dependency(node_idx, dependency_idx);
+    }
+    // Client-aided ops share the session, and state awaiting its responses
+    if (m_client_aided_chain_indices.find(node.get()) !=
+        m_client_aided_chain_indices.end()) {
+      scheduler.set_exclusive(node_idx);
+    }
+
+    std::set<const descriptor::Tensor*> tensors;
+    for (const auto& input : node->inputs()) {
+      tensors.insert(&input.get_tensor());
+    }
+    for (const auto& output : node->outputs()) {
+      tensors.insert(&output.get_tensor());
+    }
+    for (const descriptor::Tensor* tensor : tensors) {
+      if (freed_tensors.find(tensor) != freed_tensors.end()) {
+        node_tensors[node_idx].emplace_back(tensor);
+        ++remaining_uses[tensor];
+      }
+    }
+    // Timers are created up front, since the map is not thread-safe
+    m_timer_map[node];
   }
 
-  // Send outputs to client.
-  if (m_enable_client) {
-    send_client_results();
+  std::mutex tensor_map_mutex;
+  auto run_op = [&](size_t node_idx) {
+    TaskRuntime::ThreadBudgetScope thread_budget_scope(m_intra_op_threads);
+    const NodeWrapper& wrapped = m_wrapped_nodes[node_idx];
+    auto op = wrapped.get_node();
+    auto type_id = wrapped.get_typeid();
+    bool verbose = verbose_op(*op);
+
+    if (type_id != OP_TYPEID::Parameter) {
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "\033[1;32m"
+                         << "[ " << op->get_name() << " ]"
+                         << "\033[0m";
+      }
+      m_timer_map.at(op).start();
+
+      std::vector<std::shared_ptr<HETensor>> op_inputs;
+      std::vector<std::shared_ptr<HETensor>> op_outputs;
+      {
+        std::lock_guard<std::mutex> guard(tensor_map_mutex);
+        op_inputs = get_op_inputs(op, tensor_map);
+        if (m_enable_client && type_id == OP_TYPEID::Result) {
+          // Client outputs don't have decryption performed, so skip result op
+          m_client_outputs = op_inputs;
+        }
+        op_outputs = get_op_outputs(wrapped, op_inputs, tensor_map);
+      }
+
+      element::Type base_type;
+      if (op->get_inputs().empty()) {
+        base_type = op->get_element_type();
+      } else {
+        base_type = op->get_inputs().at(0).get_tensor().get_element_type();
+      }
+      generate_calls(base_type, wrapped, op_outputs, op_inputs);
+      m_timer_map.at(op).stop();
+
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
+                         << m_timer_map.at(op).get_milliseconds() << "ms"
+                         << "\033[0m";
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(tensor_map_mutex);
+    for (const descriptor::Tensor* tensor : node_tensors[node_idx]) {
+      if (--remaining_uses.at(tensor) == 0) {
+        free_tensor(*tensor, tensor_map);
+      }
+    }
+  };
+  scheduler.run(run_op, m_inter_op_threads);
+}
+
+std::shared_ptr<HETensor> HESealExecutable::pack_image_input(
+    const HETensor& input, size_t row_stride) {
+  NGRAPH_HE_LOG(3) << "Image packing " << input.get_name()
+                   << " with row stride " << row_stride;
+  const Shape& shape = input.get_shape();
+  auto packed = std::static_pointer_cast<HETensor>(
+      m_he_seal_backend.create_cipher_tensor(input.get_element_type(), shape,
+                                             false, input.get_name()));
+  packed->use_image_packing(row_stride);
+  pack_image_seal(input.data(), packed->data(),
+                  Shape{shape[1], shape[2], shape[3]}, row_stride,
+                  m_he_seal_backend);
+  rescale_seal(packed->data(), m_he_seal_backend);
+  return packed;
+}
+
+bool HESealExecutable::is_packed_vector_dot(
+    const Node& node, const std::vector<std::shared_ptr<HETensor>>& args) {
+  const auto* dot = dynamic_cast<const op::Dot*>(&node);
+  return dot != nullptr && dot->get_reduction_axes_count() == 1 &&
+         node.get_input_shape(0).size() == 1 &&
+         node.get_input_shape(1).size() == 2 && args.size() == 2 &&
+         args[0]->is_packed() && !args[1]->is_packed();
+}
+
+std::vector<std::shared_ptr<HETensor>> HESealExecutable::get_op_inputs(
+    const std::shared_ptr<const Node>& op, const TensorMap& tensor_map) {
+  std::vector<std::shared_ptr<HETensor>> op_inputs;
+  for (auto input : op->inputs()) {
+    descriptor::Tensor* tensor = &input.get_tensor();
+    op_inputs.push_back(tensor_map.at(tensor));
   }
-  return true;
+  return op_inputs;
+}
+
+std::vector<std::shared_ptr<HETensor>> HESealExecutable::get_op_outputs(
+    const NodeWrapper& node_wrapper,
+    const std::vector<std::shared_ptr<HETensor>>& op_inputs,
+    TensorMap& tensor_map) {
+  const std::shared_ptr<const Node>& op = node_wrapper.get_node();
+  std::vector<std::shared_ptr<HETensor>> op_outputs;
+  for (size_t i = 0; i < op->get_output_size(); ++i) {
+    auto tensor = &op->output(i).get_tensor();
+    auto it = tensor_map.find(tensor);
+    if (it == tensor_map.end()) {
+      // The output tensor is not in the tensor map so create a new tensor
+      Shape shape = op->get_output_shape(i);
+      const element::Type& element_type = op->get_output_element_type(i);
+      std::string name = op->output(i).get_tensor().get_name();
+
+      NGRAPH_HE_LOG(3) << "Get output packing / encrypted";
+
+      // TODO(fboemer): remove case once Constant becomes an op
+      // (https://github.com/NervanaSystems/ngraph/pull/3752)
+      bool encrypted_out;
+      bool packed_out;
+      if (op->is_op()) {
+        std::shared_ptr<HEOpAnnotations> he_op_annotation =
+            HEOpAnnotations::he_op_annotation(
+                *std::static_pointer_cast<const ngraph::op::Op>(op));
+        encrypted_out = he_op_annotation->encrypted();
+        packed_out = he_op_annotation->packed();
+      } else {
+        NGRAPH_WARN
+            << "Node " << op->get_name()
+            << " is not op, using default encrypted / packing behavior";
+        encrypted_out = std::any_of(
+            op_inputs.begin(), op_inputs.end(),
+            [](const std::shared_ptr<ngraph::he::HETensor>& op_input) {
+              return op_input->any_encrypted_data();
+            });
+        packed_out = std::any_of(
+            op_inputs.begin(), op_inputs.end(),
+            [](const std::shared_ptr<ngraph::he::HETensor>& he_tensor) {
+              return he_tensor->is_packed();
+            });
+      }
+      NGRAPH_HE_LOG(3) << "encrypted_out " << encrypted_out;
+      NGRAPH_HE_LOG(3) << "packed_out " << packed_out;
+      // The product of a packed vector and a matrix is packed along the
+      // product, whose shape is known
+      if (packed_out && !is_packed_vector_dot(*op, op_inputs)) {
+        HETensor::unpack_shape(shape, m_batch_size);
+      }
+      NGRAPH_HE_LOG(5) << "Creating output tensor with shape " << shape;
+
+      if (auto out_view = create_output_view(node_wrapper, op_inputs,
+                                             element_type, shape, packed_out,
+                                             name)) {
+        tensor_map.insert({tensor, out_view});
+      } else if (encrypted_out) {
+        auto out_tensor = std::static_pointer_cast<HETensor>(
+            m_he_seal_backend.create_cipher_tensor(element_type, shape,
+                                                   packed_out, name));
+        size_t row_stride = image_row_stride(*op);
+        if (row_stride != 0) {
+          out_tensor->use_image_packing(row_stride);
+        }
+        allocate_output_ciphertexts(*out_tensor, op_inputs);
+        tensor_map.insert({tensor, out_tensor});
+      } else {
+        auto out_tensor = std::static_pointer_cast<HETensor>(
+            m_he_seal_backend.create_plain_tensor(element_type, shape,
+                                                  packed_out, name));
+        tensor_map.insert({tensor, out_tensor});
+      }
+    }
+    op_outputs.push_back(tensor_map.at(tensor));
+  }
+
+  return op_outputs;
+}
+
+std::shared_ptr<HETensor> HESealExecutable::create_output_view(
+    const NodeWrapper& node_wrapper,
+    const std::vector<std::shared_ptr<HETensor>>& op_inputs,
+    const element::Type& element_type, const Shape& shape, bool packed,
+    const std::string& name) {
+  if (!m_tensor_views || op_inputs.empty()) {
+    return nullptr;
+  }
+  switch (node_wrapper.get_typeid()) {
+    case OP_TYPEID::Broadcast:
+    case OP_TYPEID::Concat:
+    case OP_TYPEID::Reshape:
+    case OP_TYPEID::Reverse:
+    case OP_TYPEID::Slice:
+      break;
+    default:
+      return nullptr;
+  }
+  std::vector<Shape> arg_shapes;
+  for (const auto& op_input : op_inputs) {
+    // Elements are only rearranged, so the layout of each batch must match
+    if (op_input->is_packed() != packed) {
+      return nullptr;
+    }
+    arg_shapes.emplace_back(op_input->get_packed_shape());
+  }
+  Shape packed_shape = packed ? HETensor::pack_shape(shape) : shape;
+  ++m_output_view_count;
+  return std::make_shared<HETensor>(
+      op_inputs, get_index_plan(node_wrapper, arg_shapes, packed_shape),
+      element_type, shape, name);
+}
+
+void HESealExecutable::allocate_output_ciphertexts(
+    HETensor& tensor, const std::vector<std::shared_ptr<HETensor>>& args) {
+  // Outputs are at most at the level of the first encrypted argument
+  for (const auto& arg : args) {
+    auto cipher_it = std::find_if(
+        arg->data().begin(), arg->data().end(),
+        [](const HEType& he_type) { return he_type.is_ciphertext(); });
+    if (cipher_it == arg->data().end()) {
+      continue;
+    }
+    seal::parms_id_type parms_id =
+        cipher_it->get_ciphertext()->ciphertext().parms_id();
+    if (m_slab_tensor_storage) {
+      tensor.use_slab_storage(parms_id);
+    } else {
+      m_ciphertext_pool->acquire(tensor.data(), parms_id, 2,
+                                 *m_he_seal_backend.get_context());
+    }
+    return;
+  }
+}
+
+void HESealExecutable::free_obsolete_tensors(const Node& op,
+                                             TensorMap& tensor_map) {
+  for (const descriptor::Tensor* t : op.liveness_free_list) {
+    free_tensor(*t, tensor_map);
+  }
+}
+
+void HESealExecutable::free_tensor(const descriptor::Tensor& tensor,
+                                   TensorMap& tensor_map) {
+  for (auto it = tensor_map.begin(); it != tensor_map.end(); ++it) {
+    const std::string& it_name = it->second->get_name();
+    if (it_name == tensor.get_name()) {
+      // Ciphertexts of tensors referenced only by the tensor map are
+      // recycled for the outputs of later ops. Unmaterialized views own none
+      if (it->second.use_count() == 1 && !it->second->is_view()) {
+        m_ciphertext_pool->release(it->second->data());
+      }
+      tensor_map.erase(it);
+      return;
+    }
+  }
+  NGRAPH_DEBUG << "Failed to erase " << tensor.get_name()
+               << " from tensor map";
 }
 
 void HESealExecutable::send_client_results() {
@@ -913,24 +2147,27 @@ void HESealExecutable::send_client_results() {
                "HESealExecutable only supports output size 1 (got ",
                get_results().size(), "");
 
-  std::vector<pb::HETensor> proto_tensors;
-  m_client_outputs[0]->write_to_protos(proto_tensors);
-
-  for (const auto& proto_tensor : proto_tensors) {
-    pb::TCPMessage result_msg;
-    result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
-    *result_msg.add_he_tensors() = proto_tensor;
-
-    auto result_shape = result_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Server sending result with shape "
-                     << Shape{result_shape.begin(), result_shape.end()};
-    m_session->write_message(TCPMessage(std::move(result_msg)));
-  }
+  m_client_outputs[0]->set_ciphertext_codec(m_ciphertext_codec);
+  // Each chunk is sent as soon as it is serialized
+  m_client_outputs[0]->write_to_proto_chunks(
+      [this](pb::HETensor&& proto_tensor,
+             TCPMessage::ciphertext_list&& ciphertexts) {
+        pb::TCPMessage result_msg;
+        result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
+        *result_msg.add_he_tensors() = std::move(proto_tensor);
+
+        auto result_shape = result_msg.he_tensors(0).shape();
+        NGRAPH_HE_LOG(3) << "Server sending result chunk "
+                         << result_msg.he_tensors(0).chunk_index()
+                         << " with shape "
+                         << Shape{result_shape.begin(), result_shape.end()};
+        m_session->write_message(
+            TCPMessage(std::move(result_msg), std::move(ciphertexts)));
+      },
+      m_zero_copy_tcp);
 
   // Wait until message is written
-  std::unique_lock<std::mutex> mlock(m_result_mutex);
-  std::condition_variable& writing_cond = m_session->is_writing_cond();
-  writing_cond.wait(mlock, [this] { return !m_session->is_writing(); });
+  m_session->wait_for_writes();
 }
 
 void HESealExecutable::generate_calls(
@@ -941,6 +2178,14 @@ void HESealExecutable::generate_calls(
   bool verbose = verbose_op(node);
   std::string node_op = node.description();
 
+  // Outputs created as views of the arguments are gathered once read
+  if (out.size() == 1 && out[0]->is_view()) {
+    if (verbose) {
+      NGRAPH_HE_LOG(3) << "Output of " << node.get_name() << " is a view";
+    }
+    return;
+  }
+
 // We want to check that every OP_TYPEID enumeration is included in the
 // list. These GCC flags enable compile-time checking so that if an
 //      enumeration
@@ -955,7 +2200,6 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::AvgPool: {
-      const auto avg_pool = static_cast<const op::AvgPool*>(&node);
       Shape op_in_shape = args[0]->get_packed_shape();
       Shape op_out_shape = out[0]->get_packed_shape();
 
@@ -963,12 +2207,9 @@ void HESealExecutable::generate_calls(
         NGRAPH_HE_LOG(3) << "AvgPool " << op_in_shape << " => " << op_out_shape;
       }
 
-      avg_pool_seal(
-          args[0]->data(), out[0]->data(), op_in_shape, op_out_shape,
-          avg_pool->get_window_shape(), avg_pool->get_window_movement_strides(),
-          avg_pool->get_padding_below(), avg_pool->get_padding_above(),
-          avg_pool->get_include_padding_in_avg_computation(),
-          out[0]->get_batch_size(), m_he_seal_backend);
+      avg_pool_seal(args[0]->data(), out[0]->data(),
+                    *get_index_plan(node_wrapper, {op_in_shape}, op_out_shape),
+                    out[0]->get_batch_size(), m_he_seal_backend);
       rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
       break;
     }
@@ -1008,24 +2249,24 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Broadcast: {
-      const auto broadcast = static_cast<const op::Broadcast*>(&node);
       broadcast_seal(args[0]->data(), out[0]->data(),
-                     args[0]->get_packed_shape(), out[0]->get_packed_shape(),
-                     broadcast->get_broadcast_axes());
+                     *get_index_plan(node_wrapper,
+                                     {args[0]->get_packed_shape()},
+                                     out[0]->get_packed_shape()));
       break;
     }
     case OP_TYPEID::BroadcastLike:
       break;
     case OP_TYPEID::Concat: {
-      const auto* concat = static_cast<const op::Concat*>(&node);
       std::vector<Shape> in_shapes;
-      std::vector<std::vector<HEType>> in_args;
+      std::vector<const std::vector<HEType>*> in_args;
       for (auto& arg : args) {
-        in_args.push_back(arg->data());
+        in_args.push_back(&arg->data());
         in_shapes.push_back(arg->get_packed_shape());
       }
-      concat_seal(in_args, out[0]->data(), in_shapes,
-                  out[0]->get_packed_shape(), concat->get_concatenation_axis());
+      concat_seal(in_args, out[0]->data(),
+                  *get_index_plan(node_wrapper, in_shapes,
+                                  out[0]->get_packed_shape()));
       break;
     }
     case OP_TYPEID::Constant: {
@@ -1035,13 +2276,6 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Convolution: {
-      const auto* c = static_cast<const op::Convolution*>(&node);
-      const auto& window_movement_strides = c->get_window_movement_strides();
-      const auto& window_dilation_strides = c->get_window_dilation_strides();
-      const auto& padding_below = c->get_padding_below();
-      const auto& padding_above = c->get_padding_above();
-      const auto& data_dilation_strides = c->get_data_dilation_strides();
-
       Shape in_shape0 = args[0]->get_packed_shape();
       Shape in_shape1 = args[1]->get_packed_shape();
 
@@ -1049,12 +2283,37 @@ void HESealExecutable::generate_calls(
         NGRAPH_HE_LOG(3) << in_shape0 << " Conv " << in_shape1 << " => "
                          << out[0]->get_packed_shape();
       }
-      convolution_seal(args[0]->data(), args[1]->data(), out[0]->data(),
-                       in_shape0, in_shape1, out[0]->get_packed_shape(),
-                       window_movement_strides, window_dilation_strides,
-                       padding_below, padding_above, data_dilation_strides, 0,
-                       1, 1, 0, 0, 1, false, type, m_batch_size,
-                       m_he_seal_backend, verbose);
+      Shape out_shape = out[0]->get_packed_shape();
+      if (args[0]->is_image_packed()) {
+        NGRAPH_CHECK(out[0]->image_row_stride() == args[0]->image_row_stride(),
+                     "Packed image convolution output row stride ",
+                     out[0]->image_row_stride(), " does not match image row ",
+                     "stride ", args[0]->image_row_stride());
+        const auto* c = static_cast<const op::Convolution*>(&node);
+        const Shape& image_shape = node.get_input_shape(0);
+        convolution_packed_image_seal(
+            args[0]->data(), args[1]->data(), out[0]->data(),
+            Shape{image_shape[1], image_shape[2], image_shape[3]},
+            node.get_input_shape(1), c->get_padding_below(),
+            c->get_padding_above(), args[0]->image_row_stride(),
+            m_he_seal_backend);
+      } else if (convolution_seal_plan_entry_count(in_shape1, out_shape) >
+          m_max_convolution_plan_entries) {
+        const auto* c = static_cast<const op::Convolution*>(&node);
+        convolution_seal(
+            args[0]->data(), args[1]->data(), out[0]->data(), in_shape0,
+            in_shape1, out_shape, c->get_window_movement_strides(),
+            c->get_window_dilation_strides(), c->get_padding_below(),
+            c->get_padding_above(), c->get_data_dilation_strides(), 0, 1, 1,
+            0, 0, 1, false, type, m_batch_size, m_he_seal_backend, verbose,
+            get_constant_cache(node, 1));
+      } else {
+        convolution_seal(args[0]->data(), args[1]->data(), out[0]->data(),
+                         *get_index_plan(node_wrapper, {in_shape0, in_shape1},
+                                         out_shape),
+                         type, m_batch_size, m_he_seal_backend, verbose,
+                         get_constant_cache(node, 1));
+      }
 
       rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
 
@@ -1077,9 +2336,21 @@ void HESealExecutable::generate_calls(
       if (verbose) {
         NGRAPH_HE_LOG(3) << in_shape0 << " dot " << in_shape1;
       }
+      if (is_packed_vector_dot(node, args)) {
+        const Shape& matrix_shape = args[1]->get_shape();
+        NGRAPH_CHECK(m_he_seal_backend.has_galois_keys(
+                         dot_diagonal_rotation_steps(matrix_shape[0],
+                                                     matrix_shape[1])),
+                     "Missing Galois keys for Dot of a packed vector");
+        dot_diagonal_seal(args[0]->data(0), args[1]->data(), out[0]->data(0),
+                          matrix_shape[0], matrix_shape[1], m_he_seal_backend);
+        rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
+        break;
+      }
       dot_seal(args[0]->data(), args[1]->data(), out[0]->data(), in_shape0,
                in_shape1, out[0]->get_packed_shape(),
-               dot->get_reduction_axes_count(), type, m_he_seal_backend);
+               dot->get_reduction_axes_count(), type, m_he_seal_backend,
+               get_constant_cache(node, 1));
       rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
 
       break;
@@ -1117,7 +2388,6 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::MaxPool: {
-      const auto* max_pool = static_cast<const op::MaxPool*>(&node);
       if (m_enable_client) {
         handle_server_max_pool_op(args[0], out[0], node_wrapper);
       } else {
@@ -1128,11 +2398,10 @@ void HESealExecutable::generate_calls(
                      output_size, " doesn't match number of elements",
                      out[0]->data().size());
         max_pool_seal(args[0]->data(), out[0]->data(),
-                      args[0]->get_packed_shape(), out[0]->get_packed_shape(),
-                      max_pool->get_window_shape(),
-                      max_pool->get_window_movement_strides(),
-                      max_pool->get_padding_below(),
-                      max_pool->get_padding_above(), m_he_seal_backend);
+                      *get_index_plan(node_wrapper,
+                                      {args[0]->get_packed_shape()},
+                                      out[0]->get_packed_shape()),
+                      m_he_seal_backend);
       }
       break;
     }
@@ -1154,11 +2423,9 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Pad: {
-      const auto* pad = static_cast<const op::Pad*>(&node);
       pad_seal(args[0]->data(), args[1]->data(), out[0]->data(),
-               args[0]->get_packed_shape(), out[0]->get_packed_shape(),
-               pad->get_padding_below(), pad->get_padding_above(),
-               pad->get_pad_mode());
+               *get_index_plan(node_wrapper, {args[0]->get_packed_shape()},
+                               out[0]->get_packed_shape()));
       break;
     }
     case OP_TYPEID::Parameter: {
@@ -1195,29 +2462,33 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Reshape: {
-      const auto* reshape = static_cast<const op::Reshape*>(&node);
       if (verbose) {
         NGRAPH_HE_LOG(3) << args[0]->get_packed_shape() << " reshape "
                          << out[0]->get_packed_shape();
       }
-      reshape_seal(args[0]->data(), out[0]->data(), args[0]->get_packed_shape(),
-                   reshape->get_input_order(), out[0]->get_packed_shape());
+      reshape_seal(args[0]->data(), out[0]->data(),
+                   *get_index_plan(node_wrapper, {args[0]->get_packed_shape()},
+                                   out[0]->get_packed_shape()));
 
       break;
     }
     case OP_TYPEID::Result: {
+      // Image packed results are unpacked when read
+      if (args[0]->is_image_packed()) {
+        out[0]->use_image_packing(args[0]->image_row_stride());
+      }
       result_seal(args[0]->data(), out[0]->data(),
                   out[0]->get_batched_element_count(), m_he_seal_backend);
       break;
     }
     case OP_TYPEID::Reverse: {
-      const auto* reverse = static_cast<const op::Reverse*>(&node);
       if (verbose) {
         NGRAPH_HE_LOG(3) << args[0]->get_packed_shape() << " reshape "
                          << out[0]->get_packed_shape();
       }
-      reverse_seal(args[0]->data(), out[0]->data(), args[0]->get_packed_shape(),
-                   out[0]->get_packed_shape(), reverse->get_reversed_axes());
+      reverse_seal(args[0]->data(), out[0]->data(),
+                   *get_index_plan(node_wrapper, {args[0]->get_packed_shape()},
+                                   out[0]->get_packed_shape()));
       break;
     }
     case OP_TYPEID::ScalarConstantLike: {
@@ -1227,32 +2498,17 @@ void HESealExecutable::generate_calls(
       const auto* slice = static_cast<const op::Slice*>(&node);
       const Shape& in_shape = args[0]->get_packed_shape();
       const Shape& out_shape = out[0]->get_packed_shape();
-      const Coordinate& lower_bounds = slice->get_lower_bounds();
-      Coordinate upper_bounds = slice->get_upper_bounds();
-      const Strides& strides = slice->get_strides();
 
       if (verbose) {
         NGRAPH_HE_LOG(3) << "in_shape " << in_shape;
         NGRAPH_HE_LOG(3) << "out_shape " << out_shape;
-        NGRAPH_HE_LOG(3) << "lower_bounds " << lower_bounds;
-        NGRAPH_HE_LOG(3) << "upper_bounds " << upper_bounds;
-        NGRAPH_HE_LOG(3) << "strides " << strides;
-      }
-
-      if (!upper_bounds.empty() && !upper_bounds.empty() &&
-          (upper_bounds[0] > in_shape[0])) {
-        NGRAPH_CHECK(upper_bounds[0] == out[0]->get_batch_size(),
-                     "Slice upper bound shape ", upper_bounds,
-                     " is not compatible with tensor output shape ",
-                     out[0]->get_shape());
-        upper_bounds[0] = 1;
-        if (verbose) {
-          NGRAPH_HE_LOG(3) << "new upper_bounds " << upper_bounds;
-        }
+        NGRAPH_HE_LOG(3) << "lower_bounds " << slice->get_lower_bounds();
+        NGRAPH_HE_LOG(3) << "upper_bounds " << slice->get_upper_bounds();
+        NGRAPH_HE_LOG(3) << "strides " << slice->get_strides();
       }
 
-      slice_seal(args[0]->data(), out[0]->data(), in_shape, lower_bounds,
-                 upper_bounds, strides, out_shape);
+      slice_seal(args[0]->data(), out[0]->data(),
+                 *get_index_plan(node_wrapper, {in_shape}, out_shape));
 
       break;
     }
@@ -1375,37 +2631,55 @@ void HESealExecutable::handle_server_max_pool_op(
 
   const Node& node = *node_wrapper.get_node();
   bool verbose = verbose_op(node);
-  const auto* max_pool = static_cast<const op::MaxPool*>(&node);
-
-  m_max_pool_done = false;
 
   Shape unpacked_arg_shape = node.get_input_shape(0);
   Shape out_shape = HETensor::pack_shape(node.get_output_shape(0));
 
   // TODO(fboemer): call max_pool_seal directly?
-  std::vector<std::vector<size_t>> maximize_lists = max_pool_seal_max_list(
-      unpacked_arg_shape, out_shape, max_pool->get_window_shape(),
-      max_pool->get_window_movement_strides(), max_pool->get_padding_below(),
-      max_pool->get_padding_above());
-
-  m_max_pool_data.clear();
-
-  for (const auto& maximize_list : maximize_lists) {
-    pb::TCPMessage proto_msg;
-    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
-
-    json js = {{"function", node.description()}};
-    pb::Function f;
-    f.set_function(js.dump());
-    *proto_msg.mutable_function() = f;
+  std::shared_ptr<const IndexPlan> max_pool_plan =
+      get_index_plan(node_wrapper, {unpacked_arg_shape}, out_shape);
+  size_t window_count = max_pool_plan->output_count();
+
+  {
+    std::lock_guard<std::mutex> guard(m_max_pool_mutex);
+    m_max_pool_data.assign(window_count, HEType(HEPlaintext(), false));
+    m_max_pool_done_count = 0;
+  }
 
+  // TODO(fboemer): tune
+  const size_t max_max_pool_message_cnt = 1000;
+  size_t window_budget = m_max_pool_windows_in_flight == 0
+                             ? window_count
+                             : m_max_pool_windows_in_flight;
+
+  // Sends windows [first_window, last_window) in a single message. The
+  // client's response carries first_window as request id, so responses can
+  // arrive in any order.
+  auto send_max_pool_windows = [&](size_t first_window, size_t last_window) {
     std::vector<HEType> cipher_batch;
-    cipher_batch.reserve(maximize_list.size());
-    for (const size_t max_ind : maximize_list) {
-      cipher_batch.emplace_back(arg->data(max_ind));
+    std::vector<size_t> window_sizes;
+    window_sizes.reserve(last_window - first_window);
+    for (size_t window_idx = first_window; window_idx < last_window;
+         ++window_idx) {
+      size_t entry_begin = max_pool_plan->entry_begin(window_idx);
+      size_t entry_end = max_pool_plan->entry_end(window_idx);
+      NGRAPH_CHECK(entry_end > entry_begin, "Maxpool window is empty");
+      for (size_t entry_idx = entry_begin; entry_idx < entry_end;
+           ++entry_idx) {
+        cipher_batch.emplace_back(
+            arg->data(max_pool_plan->arg_index(entry_idx)));
+      }
+      window_sizes.emplace_back(entry_end - entry_begin);
     }
+    // Only the levels needed to decrypt are sent
+    mod_switch_to_lowest_level(cipher_batch, m_he_seal_backend);
 
-    NGRAPH_CHECK(!cipher_batch.empty(), "Maxpool cipher batch is empty");
+    json js = {{"function", node.description()},
+               {"request_id", first_window},
+               {"window_sizes", window_sizes},
+               {"chain_index", client_aided_chain_index(node)}};
+    pb::Function f;
+    f.set_function(js.dump());
 
     HETensor max_pool_tensor(
         arg->get_element_type(),
@@ -1413,37 +2687,70 @@ void HESealExecutable::handle_server_max_pool_op(
         cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
         true, m_he_seal_backend);
     max_pool_tensor.data() = cipher_batch;
-    std::vector<pb::HETensor> proto_tensors;
-    max_pool_tensor.write_to_protos(proto_tensors);
-    NGRAPH_CHECK(proto_tensors.size() == 1,
-                 "Only support MaxPool with 1 proto tensor");
-    *proto_msg.add_he_tensors() = proto_tensors[0];
+    max_pool_tensor.set_ciphertext_codec(m_ciphertext_codec);
 
-    // Send list of ciphertexts to maximize over to client
+    // Send list of ciphertexts to maximize over to client. The client
+    // computes the maxima once all chunks of the request have arrived.
     if (verbose) {
-      NGRAPH_HE_LOG(3) << "Sending " << cipher_batch.size()
-                       << " Maxpool ciphertexts to client";
+      NGRAPH_HE_LOG(3) << "Sending " << window_sizes.size()
+                       << " Maxpool windows with " << cipher_batch.size()
+                       << " ciphertexts to client";
     }
+    max_pool_tensor.write_to_proto_chunks(
+        [&](pb::HETensor&& proto_tensor,
+            TCPMessage::ciphertext_list&& ciphertexts) {
+          pb::TCPMessage proto_msg;
+          proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+          *proto_msg.mutable_function() = f;
+          *proto_msg.add_he_tensors() = std::move(proto_tensor);
 
-    TCPMessage max_pool_message(std::move(proto_msg));
-    m_session->write_message(std::move(max_pool_message));
+          TCPMessage max_pool_message(std::move(proto_msg),
+                                      std::move(ciphertexts));
+          m_session->write_message(std::move(max_pool_message));
+        },
+        m_zero_copy_tcp);
+  };
 
-    // Acquire lock
-    std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+  auto window_size = [&](size_t window_idx) {
+    return max_pool_plan->entry_end(window_idx) -
+           max_pool_plan->entry_begin(window_idx);
+  };
 
-    // Wait until max is done
-    m_max_pool_cond.wait(mlock,
-                         std::bind(&HESealExecutable::max_pool_done, this));
+  size_t sent_count = 0;
+  while (sent_count < window_count) {
+    // Batch windows into a message, up to the ciphertext and window budgets
+    size_t batch_end = sent_count;
+    size_t cipher_count = 0;
+    while (
+        batch_end < window_count && batch_end - sent_count < window_budget &&
+        (batch_end == sent_count ||
+         cipher_count + window_size(batch_end) <= max_max_pool_message_cnt)) {
+      cipher_count += window_size(batch_end);
+      ++batch_end;
+    }
 
-    // Reset for next max_pool call
-    m_max_pool_done = false;
+    // Wait until enough windows have completed to stay within the budget
+    {
+      std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+      m_max_pool_cond.wait(mlock, [&]() {
+        return batch_end - m_max_pool_done_count <= window_budget;
+      });
+    }
+    send_max_pool_windows(sent_count, batch_end);
+    sent_count = batch_end;
   }
+
+  // Wait until all windows have been processed
+  std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+  m_max_pool_cond.wait(
+      mlock, [&]() { return m_max_pool_done_count == window_count; });
+
   out->data() = m_max_pool_data;
 }
 
 void HESealExecutable::handle_server_relu_op(
     const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
-    const NodeWrapper& node_wrapper) {
+    const NodeWrapper& node_wrapper, const ReluResultCallback& on_result) {
   NGRAPH_HE_LOG(3) << "Server handle_server_relu_op";
 
   auto type_id = node_wrapper.get_typeid();
@@ -1466,8 +2773,12 @@ void HESealExecutable::handle_server_relu_op(
   // TODO(fboemer): tune
   const size_t max_relu_message_cnt = 1000;
 
-  m_unknown_relu_idx.clear();
-  m_unknown_relu_idx.reserve(element_count);
+  {
+    std::lock_guard<std::mutex> guard(m_relu_mutex);
+    m_relu_done_count = 0;
+    m_unknown_relu_idx.clear();
+    m_unknown_relu_idx.reserve(element_count);
+  }
 
   // Process known values
   for (size_t relu_idx = 0; relu_idx < element_count; ++relu_idx) {
@@ -1488,44 +2799,49 @@ void HESealExecutable::handle_server_relu_op(
     }
   }
   auto process_unknown_relu_ciphers_batch =
-      [&](const std::vector<HEType>& cipher_batch) {
+      [&](std::vector<HEType>& cipher_batch) {
         if (verbose) {
           NGRAPH_HE_LOG(3) << "Sending relu request size "
                            << cipher_batch.size();
         }
 
+        // Only the levels needed to decrypt are sent
+        mod_switch_to_lowest_level(cipher_batch, m_he_seal_backend);
+
         // TODO(fboemer): set complex_packing to correct values?
         HETensor relu_tensor(
             arg->get_element_type(),
             Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
             arg->is_packed(), false, true, m_he_seal_backend);
         relu_tensor.data() = cipher_batch;
-
-        std::vector<pb::HETensor> proto_tensors;
-        relu_tensor.write_to_protos(proto_tensors);
-        for (const auto& proto_tensor : proto_tensors) {
-          pb::TCPMessage proto_msg;
-          proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
-
-          // TODO(fboemer): factor out serializing the function
-          json js = {{"function", node.description()}};
-          if (type_id == OP_TYPEID::BoundedRelu) {
-            const auto* bounded_relu =
-                static_cast<const op::BoundedRelu*>(&node);
-            float alpha = bounded_relu->get_alpha();
-            js["bound"] = alpha;
-          }
-
-          pb::Function f;
-          f.set_function(js.dump());
-          *proto_msg.mutable_function() = f;
-
-          *proto_msg.add_he_tensors() = proto_tensor;
-          TCPMessage relu_message(std::move(proto_msg));
-
-          NGRAPH_HE_LOG(5) << "Server writing relu request message";
-          m_session->write_message(std::move(relu_message));
+        relu_tensor.set_ciphertext_codec(m_ciphertext_codec);
+
+        // TODO(fboemer): factor out serializing the function
+        json js = {{"function", node.description()},
+                   {"chain_index", client_aided_chain_index(node)}};
+        if (type_id == OP_TYPEID::BoundedRelu) {
+          const auto* bounded_relu = static_cast<const op::BoundedRelu*>(&node);
+          float alpha = bounded_relu->get_alpha();
+          js["bound"] = alpha;
         }
+        pb::Function f;
+        f.set_function(js.dump());
+
+        // Chunks are independent requests, answered in order by the client
+        relu_tensor.write_to_proto_chunks(
+            [&](pb::HETensor&& proto_tensor,
+                TCPMessage::ciphertext_list&& ciphertexts) {
+              pb::TCPMessage proto_msg;
+              proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+              *proto_msg.mutable_function() = f;
+              *proto_msg.add_he_tensors() = std::move(proto_tensor);
+              TCPMessage relu_message(std::move(proto_msg),
+                                      std::move(ciphertexts));
+
+              NGRAPH_HE_LOG(5) << "Server writing relu request message";
+              m_session->write_message(std::move(relu_message));
+            },
+            m_zero_copy_tcp);
       };
 
   // Process unknown values
@@ -1546,12 +2862,231 @@ void HESealExecutable::handle_server_relu_op(
     relu_ciphers_batch.clear();
   }
 
-  // Wait until all batches have been processed
-  std::unique_lock<std::mutex> mlock(m_relu_mutex);
-  m_relu_cond.wait(
-      mlock, [=]() { return m_relu_done_count == m_unknown_relu_idx.size(); });
+  if (!on_result) {
+    // Wait until all batches have been processed
+    std::unique_lock<std::mutex> mlock(m_relu_mutex);
+    m_relu_cond.wait(mlock, [=]() {
+      return m_relu_done_count == m_unknown_relu_idx.size();
+    });
+    m_relu_done_count = 0;
+
+    out->data() = m_relu_data;
+    return;
+  }
+
+  NGRAPH_CHECK(out->data().size() == element_count, "ReLU output size ",
+               out->data().size(), " does not match input size ",
+               element_count);
+
+  // Known values are ready immediately
+  std::vector<size_t> ready_idx;
+  ready_idx.reserve(element_count - m_unknown_relu_idx.size());
+  for (size_t relu_idx = 0; relu_idx < element_count; ++relu_idx) {
+    if (arg->data(relu_idx).is_plaintext()) {
+      out->data(relu_idx) = m_relu_data[relu_idx];
+      ready_idx.emplace_back(relu_idx);
+    }
+  }
+  if (!ready_idx.empty()) {
+    on_result(ready_idx);
+  }
+
+  // Hand off each chunk of results as soon as it arrives. The message
+  // handler only writes entries of m_relu_data past m_relu_done_count, so
+  // entries before it can be read without holding the lock.
+  size_t processed_count = 0;
+  while (processed_count < m_unknown_relu_idx.size()) {
+    size_t done_count;
+    {
+      std::unique_lock<std::mutex> mlock(m_relu_mutex);
+      m_relu_cond.wait(
+          mlock, [&]() { return m_relu_done_count > processed_count; });
+      done_count = m_relu_done_count;
+    }
+    if (verbose) {
+      NGRAPH_HE_LOG(3) << "Streaming relu results " << processed_count
+                       << " to " << done_count;
+    }
+    ready_idx.clear();
+    for (size_t unknown_idx = processed_count; unknown_idx < done_count;
+         ++unknown_idx) {
+      size_t relu_idx = m_unknown_relu_idx[unknown_idx];
+      out->data(relu_idx) = m_relu_data[relu_idx];
+      ready_idx.emplace_back(relu_idx);
+    }
+    on_result(ready_idx);
+    processed_count = done_count;
+  }
+
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
   m_relu_done_count = 0;
+}
+
+bool HESealExecutable::can_stream_relu_into(
+    const NodeWrapper& next_wrapper, const std::shared_ptr<HETensor>& relu_out,
+    const std::vector<std::shared_ptr<HETensor>>& next_args,
+    const std::vector<std::shared_ptr<HETensor>>& next_out) {
+  if (next_out.size() != 1) {
+    return false;
+  }
+  switch (next_wrapper.get_typeid()) {
+    case OP_TYPEID::Add:
+    case OP_TYPEID::Multiply: {
+      size_t out_size = next_out[0]->data().size();
+      bool uses_relu = false;
+      for (const auto& next_arg : next_args) {
+        if (next_arg->data().size() != out_size) {
+          return false;
+        }
+        uses_relu |= (next_arg == relu_out);
+      }
+      return uses_relu;
+    }
+    case OP_TYPEID::Dot: {
+      return next_args.size() == 2 && next_args[0] == relu_out &&
+             next_args[1] != relu_out &&
+             !is_packed_vector_dot(*next_wrapper.get_node(), next_args);
+    }
+    default:
+      return false;
+  }
+}
 
-  out->data() = m_relu_data;
+void HESealExecutable::stream_server_relu_op(
+    const std::shared_ptr<HETensor>& relu_arg,
+    const std::shared_ptr<HETensor>& relu_out,
+    const NodeWrapper& relu_wrapper, const NodeWrapper& next_wrapper,
+    const std::vector<std::shared_ptr<HETensor>>& next_args,
+    const std::vector<std::shared_ptr<HETensor>>& next_out) {
+  const Node& next_node = *next_wrapper.get_node();
+  bool verbose = verbose_op(next_node);
+  auto next_type_id = next_wrapper.get_typeid();
+  const element::Type& type = next_args[0]->get_element_type();
+  NGRAPH_CHECK(m_he_seal_backend.is_supported_type(type), "Unsupported type ",
+               type);
+
+  std::vector<HEType>& out = next_out[0]->data();
+
+  if (next_type_id == OP_TYPEID::Add || next_type_id == OP_TYPEID::Multiply) {
+    std::vector<HEType>& arg0 = next_args[0]->data();
+    std::vector<HEType>& arg1 = next_args[1]->data();
+    bool add = next_type_id == OP_TYPEID::Add;
+
+    handle_server_relu_op(
+        relu_arg, relu_out, relu_wrapper,
+        [&](const std::vector<size_t>& ready_idx) {
+          parallel_for(0, ready_idx.size(), [&](size_t i) {
+            seal::MemoryPoolHandle pool =
+                seal::MemoryPoolHandle::ThreadLocal();
+            size_t idx = ready_idx[i];
+            if (add) {
+              scalar_add_seal(arg0[idx], arg1[idx], out[idx],
+                              m_he_seal_backend, pool);
+            } else {
+              scalar_multiply_seal(arg0[idx], arg1[idx], out[idx],
+                                   m_he_seal_backend, pool);
+            }
+          });
+        });
+    if (!add) {
+      rescale_seal(out, m_he_seal_backend, verbose);
+    }
+    return;
+  }
+
+  NGRAPH_CHECK(next_type_id == OP_TYPEID::Dot, "Cannot stream relu into ",
+               next_node.description());
+  const auto* dot = static_cast<const op::Dot*>(&next_node);
+  size_t reduction_axes_count = dot->get_reduction_axes_count();
+
+  // View the Dot as a product of a (rows x inner) matrix and a
+  // (inner x cols) matrix
+  Shape arg0_shape = next_args[0]->get_packed_shape();
+  Shape arg1_shape = next_args[1]->get_packed_shape();
+  NGRAPH_CHECK(arg0_shape.size() >= reduction_axes_count &&
+                   arg1_shape.size() >= reduction_axes_count,
+               "Dot reduction axes count ", reduction_axes_count,
+               " too large");
+  size_t inner_size =
+      shape_size(Shape(arg1_shape.begin(),
+                       arg1_shape.begin() + reduction_axes_count));
+  size_t cols = shape_size(
+      Shape(arg1_shape.begin() + reduction_axes_count, arg1_shape.end()));
+  size_t rows = shape_size(
+      Shape(arg0_shape.begin(), arg0_shape.end() - reduction_axes_count));
+  NGRAPH_CHECK(out.size() == rows * cols, "Dot output size ", out.size(),
+               " does not match ", rows, " x ", cols);
+
+  const std::vector<HEType>& arg0 = next_args[0]->data();
+  const std::vector<HEType>& arg1 = next_args[1]->data();
+  SealPlaintextCache* arg1_cache = get_constant_cache(next_node, 1);
+  const std::vector<SealEncodedPlaintext>* arg1_encodings = nullptr;
+
+  // Whether or not each output is still unwritten
+  std::vector<char> first_adds(out.size(), 1);
+
+  handle_server_relu_op(
+      relu_arg, relu_out, relu_wrapper,
+      [&](const std::vector<size_t>& ready_idx) {
+        // Group the ready inputs by row, so each output is only updated by
+        // one thread
+        std::map<size_t, std::vector<size_t>> row_to_inner;
+        for (const size_t idx : ready_idx) {
+          row_to_inner[idx / inner_size].emplace_back(idx % inner_size);
+        }
+        std::vector<std::pair<size_t, std::vector<size_t>>> ready_rows(
+            row_to_inner.begin(), row_to_inner.end());
+
+        if (arg1_cache != nullptr && arg1_encodings == nullptr) {
+          std::vector<HEType> ready_values;
+          ready_values.reserve(ready_idx.size());
+          for (const size_t idx : ready_idx) {
+            ready_values.emplace_back(arg0[idx]);
+          }
+          arg1_encodings = arg1_cache->get_encodings(arg1, ready_values,
+                                                     m_he_seal_backend);
+        }
+
+        // Each chunk shares a product scratch ciphertext
+        auto accumulate_range = [&](size_t range_begin, size_t range_end) {
+          seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+          HEType prod(m_he_seal_backend.create_empty_ciphertext(pool), false,
+                      1);
+          for (size_t i = range_begin; i < range_end; ++i) {
+            size_t row = ready_rows[i / cols].first;
+            const std::vector<size_t>& inner_idx = ready_rows[i / cols].second;
+            size_t col = i % cols;
+            size_t out_idx = row * cols + col;
+
+            bool first_add = first_adds[out_idx] != 0;
+            for (const size_t inner : inner_idx) {
+              size_t arg1_idx = inner * cols + col;
+              const SealEncodedPlaintext* arg1_encoded =
+                  arg1_encodings != nullptr ? &(*arg1_encodings)[arg1_idx]
+                                            : nullptr;
+              scalar_multiply_accumulate_seal(
+                  arg0[row * inner_size + inner], arg1[arg1_idx],
+                  arg1_encoded, out[out_idx], prod, first_add,
+                  m_he_seal_backend, pool);
+            }
+            first_adds[out_idx] = first_add ? 1 : 0;
+          }
+        };
+        size_t ready_count = ready_rows.size() * cols;
+        parallel_for_ranges(0, ready_count, accumulate_range,
+                            TaskRuntime::global().default_grain(ready_count));
+      });
+
+  parallel_for(0, out.size(), [&](size_t out_idx) {
+    if (first_adds[out_idx] != 0) {
+      // TODO(fboemer): batch size number of zeros?
+      HEPlaintext zero(std::vector<double>{0});
+      out[out_idx].set_plaintext(zero);
+    } else {
+      multiply_accumulate_finalize_seal(out[out_idx], m_he_seal_backend,
+                                        seal::MemoryPoolHandle::ThreadLocal());
+    }
+  });
+  rescale_seal(out, m_he_seal_backend, verbose);
 }
 }  // namespace ngraph::he
@@ -20,10 +20,13 @@
 #include <boost/asio.hpp>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "he_op_annotations.hpp"
@@ -34,7 +37,11 @@
 #include "node_wrapper.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal.h"
+#include "seal/seal_ciphertext_codec.hpp"
+#include "seal/seal_ciphertext_pool.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/kernel/convolution_seal.hpp"
+#include "seal/seal_plaintext_cache.hpp"
 #include "tcp/tcp_message.hpp"
 #include "tcp/tcp_session.hpp"
 
@@ -62,8 +69,89 @@ class HESealExecutable : public runtime::Executable {
   /// \brief Starts the server, which awaits a connection from a client
   void start_server();
 
+  /// \brief Serves a client over an already-accepted connection instead of
+  /// starting a server
+  /// \param[in] socket Socket connected to the client
+  void start_session(boost::asio::ip::tcp::socket socket);
+
   void update_he_op_annotations();
 
+  /// \brief Sets the chain index at which the client re-encrypts the result
+  /// of each client-aided operation
+  void set_client_aided_chain_indices();
+
+  /// \brief Sets which ops output image packed tensors, if
+  /// PACKED_IMAGE_CONVOLUTION is set. These are encrypted batch-1 Parameters
+  /// whose users are all packed image convolutions, and the packed image
+  /// convolutions of those Parameters' images. Packed image convolutions
+  /// have a Constant filter, unit strides and dilations, and an output no
+  /// larger than their image, and their outputs are only used by packed
+  /// image convolutions or Results
+  void set_image_row_strides();
+
+  /// \brief Returns the number of slots between consecutive image rows of
+  /// an op's output, or 0 if the output is not image packed
+  /// \param[in] node Op of the function
+  size_t image_row_stride(const Node& node) const;
+
+  /// \brief Sets the index plan of each data-movement and windowed op, for
+  /// the packed shapes given by the HE op annotations. Plans are cached across
+  /// calls, and shared with session executables, so a plan is only rebuilt
+  /// when the shapes of its op change
+  void set_index_plans();
+
+  /// \brief Returns the codec of ciphertexts sent to the client, once
+  /// negotiated with the client
+  CiphertextCodec ciphertext_codec() const { return m_ciphertext_codec; }
+
+  /// \brief Returns the number of index plans built by the executable and
+  /// its session executables
+  size_t index_plan_build_count() const {
+    return m_op_caches->index_plan_build_count;
+  }
+
+  /// \brief Returns the number of op outputs created as views of their inputs
+  size_t output_view_count() const { return m_output_view_count; }
+
+  /// \brief Returns the pool recycling the ciphertexts of freed intermediate
+  /// tensors
+  const SealCiphertextPool& ciphertext_pool() const {
+    return *m_ciphertext_pool;
+  }
+
+  /// \brief Returns the index plan of an op for the given packed shapes. If
+  /// the op's plan was built for other shapes, a plan is built for this call
+  /// \param[in] node_wrapper Data-movement or windowed op
+  /// \param[in] arg_shapes Packed shapes of the arguments indexed by the plan
+  /// \param[in] out_shape Packed shape of the output
+  std::shared_ptr<const IndexPlan> get_index_plan(
+      const NodeWrapper& node_wrapper, const std::vector<Shape>& arg_shapes,
+      const Shape& out_shape) const;
+
+  /// \brief Builds the index plan of an op, or returns nullptr if the op has
+  /// no index plan
+  /// \param[in] node_wrapper Op
+  /// \param[in] arg_shapes Packed shapes of the arguments indexed by the plan
+  /// \param[in] out_shape Packed shape of the output
+  /// \param[in] max_convolution_plan_entries Maximum number of entries of a
+  /// Convolution plan. Larger convolutions have no plan
+  static std::shared_ptr<const IndexPlan> build_index_plan(
+      const NodeWrapper& node_wrapper, const std::vector<Shape>& arg_shapes,
+      const Shape& out_shape, size_t max_convolution_plan_entries);
+
+  /// \brief Returns the rotation steps for which the function requires Galois
+  /// keys. Step 0 denotes complex conjugation, which multiplying complex-packed
+  /// ciphertexts requires
+  std::vector<int> galois_steps();
+
+  /// \brief Returns the chain index at which the client re-encrypts the
+  /// result of a client-aided ReLU, BoundedReLU or MaxPool. This leaves just
+  /// enough levels for the rescaling operations before the next client-aided
+  /// operation or function result, or the first chain index if these cannot
+  /// be determined
+  /// \param[in] node Client-aided operation
+  size_t client_aided_chain_index(const Node& node) const;
+
   /// \brief Calls the executable on the given input tensors.
   /// If the client is enabled, the inputs are dummy values and ignored.
   /// Instead, the inputs will be provided by the client
@@ -85,9 +173,6 @@ class HESealExecutable : public runtime::Executable {
 
   // TODO(fboemer): merge _done() methods
 
-  /// \brief Returns whether or not the maxpool op has completed
-  bool max_pool_done() const { return m_max_pool_done; }
-
   /// \brief Returns whether or not the minimum op has completed
   bool minimum_done() const { return m_minimum_done; }
 
@@ -118,21 +203,33 @@ class HESealExecutable : public runtime::Executable {
   /// \brief Processes a client message with ciphertexts to call the appropriate
   /// function
   /// \param[in] proto_msg Message to process
-  void handle_client_ciphers(const pb::TCPMessage& proto_msg);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_client_ciphers(
+      const pb::TCPMessage& proto_msg,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a client message with ciphertextss after a ReLU function
   /// \param[in] proto_msg Message to process
-  void handle_relu_result(const pb::TCPMessage& proto_msg);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_relu_result(
+      const pb::TCPMessage& proto_msg,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a client message with ciphertextss after a BoundedReLU
   /// function
   /// \param[in] proto_msg Message to process
-  void handle_bounded_relu_result(const pb::TCPMessage& proto_msg);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_bounded_relu_result(
+      const pb::TCPMessage& proto_msg,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Processes a client message with ciphertextss after a MaxPool
   /// function
   /// \param[in] proto_msg Message to process
-  void handle_max_pool_result(const pb::TCPMessage& proto_msg);
+  /// \param[in] ciphertexts Ciphertexts attached to the message
+  void handle_max_pool_result(
+      const pb::TCPMessage& proto_msg,
+      const TCPMessage::ciphertext_list& ciphertexts = {});
 
   /// \brief Sends results to the client
   void send_client_results();
@@ -148,14 +245,63 @@ class HESealExecutable : public runtime::Executable {
   /// \param[in] proto_msg from which to load the evluation key
   void load_eval_key(const pb::TCPMessage& proto_msg);
 
+  /// \brief Uses the cached keys matching the message's key fingerprint, or
+  /// asks the client to upload its keys if they are not cached
+  /// \param[in] proto_msg Message storing the key fingerprint
+  void resume_client_keys(const pb::TCPMessage& proto_msg);
+
+  /// \brief Caches the keys loaded from the message under its key
+  /// fingerprint, if the fingerprint matches the keys
+  /// \param[in] proto_msg Message storing the keys and their fingerprint
+  void cache_client_keys(const pb::TCPMessage& proto_msg);
+
+  /// \brief Callback invoked with the indices of ReLU output elements which
+  /// have just been written
+  using ReluResultCallback = std::function<void(const std::vector<size_t>&)>;
+
   /// \brief Processes the ReLU operation if the client is enabled
   /// \param[in] arg Tensor argumnet
   /// \param[out] out Tensor result
   /// \param[in] node_wrapper Wrapper around operation to perform
+  /// \param[in] on_result If set, each chunk of results is written to out as
+  /// soon as it is received from the client, and on_result is called with the
+  /// indices of the chunk before waiting for the next chunk
   // TODO(fboemer): rename
   void handle_server_relu_op(const std::shared_ptr<HETensor>& arg,
                              const std::shared_ptr<HETensor>& out,
-                             const NodeWrapper& node_wrapper);
+                             const NodeWrapper& node_wrapper,
+                             const ReluResultCallback& on_result = nullptr);
+
+  /// \brief Returns whether or not the operation following a ReLU can be
+  /// computed on chunks of the ReLU result as they arrive from the client.
+  /// Supported are element-wise Add and Multiply, and Dot whose first argument
+  /// is the ReLU result.
+  /// \param[in] next_wrapper Wrapper around the operation following the ReLU
+  /// \param[in] relu_out Output tensor of the ReLU
+  /// \param[in] next_args Arguments of the following operation
+  /// \param[in] next_out Outputs of the following operation
+  bool can_stream_relu_into(
+      const NodeWrapper& next_wrapper,
+      const std::shared_ptr<HETensor>& relu_out,
+      const std::vector<std::shared_ptr<HETensor>>& next_args,
+      const std::vector<std::shared_ptr<HETensor>>& next_out);
+
+  /// \brief Processes the ReLU operation with the client, computing the
+  /// following operation on each chunk of ReLU results as it arrives. This
+  /// overlaps the client round-trip with server computation.
+  /// \param[in] relu_arg Argument of the ReLU
+  /// \param[out] relu_out Output of the ReLU
+  /// \param[in] relu_wrapper Wrapper around the ReLU operation
+  /// \param[in] next_wrapper Wrapper around the operation following the ReLU.
+  /// Must satisfy can_stream_relu_into
+  /// \param[in] next_args Arguments of the following operation
+  /// \param[out] next_out Outputs of the following operation
+  void stream_server_relu_op(
+      const std::shared_ptr<HETensor>& relu_arg,
+      const std::shared_ptr<HETensor>& relu_out,
+      const NodeWrapper& relu_wrapper, const NodeWrapper& next_wrapper,
+      const std::vector<std::shared_ptr<HETensor>>& next_args,
+      const std::vector<std::shared_ptr<HETensor>>& next_out);
 
   /// \brief Processes the MaxPool operation if the client is enabled
   /// \param[in] arg Tensor argumnet
@@ -222,6 +368,20 @@ class HESealExecutable : public runtime::Executable {
   }
 
  private:
+  /// \brief Constructs a session executable, which calls a clone of the
+  /// function of another executable, and shares its per-op state. Session
+  /// executables are cached by the parent, and reused by later calls with the
+  /// same parameter signature
+  /// \param[in] parent Executable whose function to clone
+  /// \param[in] he_seal_backend Backend storing the session's keys
+  HESealExecutable(const HESealExecutable& parent,
+                   HESealBackend& he_seal_backend);
+
+  /// \brief Runs the optimization and HE passes on the function, and wraps
+  /// its ops
+  /// \param[in] function Function in the executable
+  void compile_function(const std::shared_ptr<Function>& function);
+
   HESealBackend& m_he_seal_backend;
   bool m_is_compiled{false};
   bool m_verbose_all_ops{false};
@@ -238,6 +398,10 @@ class HESealExecutable : public runtime::Executable {
 
   std::unordered_map<std::shared_ptr<const Node>, stopwatch> m_timer_map;
   std::vector<NodeWrapper> m_wrapped_nodes;
+  // Chain index at which the client re-encrypts client-aided op results
+  std::unordered_map<const Node*, size_t> m_client_aided_chain_indices;
+  // Row stride of each op whose output is image packed
+  std::unordered_map<const Node*, size_t> m_image_row_strides;
 
   std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
 
@@ -264,20 +428,19 @@ class HESealExecutable : public runtime::Executable {
   size_t m_relu_done_count{0};
   std::vector<size_t> m_unknown_relu_idx;
 
-  // To trigger when max_pool is done
+  // To trigger when max_pool windows are done
   std::mutex m_max_pool_mutex;
   std::condition_variable m_max_pool_cond;
-  bool m_max_pool_done{false};
+  size_t m_max_pool_done_count{0};
+  // Maximum number of max_pool windows awaiting a client response. 0 means
+  // no limit
+  size_t m_max_pool_windows_in_flight{0};
 
   // To trigger when minimum is done
   std::mutex m_minimum_mutex;
   std::condition_variable m_minimum_cond;
   bool m_minimum_done{false};
 
-  // To trigger when result message has been written
-  std::mutex m_result_mutex;
-  std::condition_variable m_result_cond;
-
   // To trigger when session has started
   std::mutex m_session_mutex;
   std::condition_variable m_session_cond;
@@ -288,11 +451,209 @@ class HESealExecutable : public runtime::Executable {
   std::condition_variable m_client_inputs_cond;
   bool m_client_inputs_received{false};
 
+  /// \brief Per-op state shared by an executable and its session executables,
+  /// keyed by the ops of the executable's function
+  struct OpCaches {
+    std::mutex mutex;
+    std::unordered_map<const Node*, std::shared_ptr<const IndexPlan>>
+        index_plans;
+    std::atomic<size_t> index_plan_build_count{0};
+    // Encodings of Constant node outputs
+    std::unordered_map<const Node*, std::unique_ptr<SealPlaintextCache>>
+        constant_caches;
+  };
+  std::shared_ptr<OpCaches> m_op_caches{std::make_shared<OpCaches>()};
+  // For session executables, the op of the parent executable's function
+  // corresponding to each op of the cloned function
+  std::unordered_map<const Node*, const Node*> m_op_cache_keys;
+
+  /// \brief Returns the op keying the state of an op in m_op_caches
+  /// \param[in] node Op of the executable's function
+  const Node* op_cache_key(const Node& node) const;
+
+  // Convolutions whose index plan would have more entries compute it on the
+  // fly
+  size_t m_max_convolution_plan_entries{convolution_seal_max_plan_entries};
+
+  // Recycles the ciphertexts of freed intermediate tensors. Shared with
+  // session executables, and freed with the last of them
+  std::shared_ptr<SealCiphertextPool> m_ciphertext_pool{
+      std::make_shared<SealCiphertextPool>()};
+
+  /// \brief Session executable, with the backend storing its client's keys
+  struct SessionExecutable {
+    std::shared_ptr<HESealBackend> backend;
+    std::unique_ptr<HESealExecutable> executable;
+  };
+  // Session executables not serving a client, keyed by the parameter
+  // signature they were compiled for
+  std::mutex m_session_executables_mutex;
+  std::unordered_multimap<std::string, SessionExecutable>
+      m_session_executables;
+
+  /// \brief Returns the element types, shapes and HE op annotations of the
+  /// parameters, which determine how session executables are compiled
+  std::string parameter_signature() const;
+
+  /// \brief Prepares a session executable for serving another client. The
+  /// state of the previous session is dropped, and the parameter annotations
+  /// are copied from the parent again
+  /// \param[in] parent Executable whose function was cloned
+  void reset_session(const HESealExecutable& parent);
+
+  /// \brief Stops handling the messages of the session's client, whose
+  /// connection may outlive the session
+  void end_session();
+
+  /// \brief Map from graph tensors to the HETensors storing their values
+  using TensorMap = std::unordered_map<ngraph::descriptor::Tensor*,
+                                       std::shared_ptr<HETensor>>;
+
+  /// \brief Returns the input tensors of an operation
+  /// \param[in] op Operation whose inputs to return
+  /// \param[in] tensor_map Map storing the operation's inputs
+  std::vector<std::shared_ptr<HETensor>> get_op_inputs(
+      const std::shared_ptr<const Node>& op, const TensorMap& tensor_map);
+
+  /// \brief Returns the output tensors of an operation, creating them if they
+  /// are not in the tensor map yet. Outputs of data-movement ops are created
+  /// as views of the inputs, unless TENSOR_VIEWS is set to 0
+  /// \param[in] node_wrapper Operation whose outputs to return
+  /// \param[in] op_inputs Input tensors of the operation
+  /// \param[in,out] tensor_map Map to which created outputs are added
+  std::vector<std::shared_ptr<HETensor>> get_op_outputs(
+      const NodeWrapper& node_wrapper,
+      const std::vector<std::shared_ptr<HETensor>>& op_inputs,
+      TensorMap& tensor_map);
+
+  /// \brief Returns a view of the inputs of a data-movement op, which gathers
+  /// its elements once they are read
+  /// \param[in] node_wrapper Operation whose output to return
+  /// \param[in] op_inputs Input tensors of the operation
+  /// \param[in] element_type Datatype of the output
+  /// \param[in] shape Expanded shape of the output
+  /// \param[in] packed Whether or not the output is packed
+  /// \param[in] name Name of the output
+  /// \returns Pointer to the view, or nullptr if the op's output is not a view
+  std::shared_ptr<HETensor> create_output_view(
+      const NodeWrapper& node_wrapper,
+      const std::vector<std::shared_ptr<HETensor>>& op_inputs,
+      const element::Type& element_type, const Shape& shape, bool packed,
+      const std::string& name);
+
+  /// \brief Returns whether or not an operation multiplies a vector, packed
+  /// into a single ciphertext, with a matrix. Such products are computed with
+  /// rotations, and are packed along the product
+  /// \param[in] node Operation to check
+  /// \param[in] args Input tensors of the operation
+  static bool is_packed_vector_dot(
+      const Node& node, const std::vector<std::shared_ptr<HETensor>>& args);
+
+  /// \brief Packs the image of a batch-1 Parameter into one ciphertext per
+  /// channel, for packed image convolutions
+  /// \param[in] input Input tensor of the Parameter
+  /// \param[in] row_stride Number of slots between consecutive image rows
+  /// \returns Image packed tensor, at one level below the input
+  std::shared_ptr<HETensor> pack_image_input(const HETensor& input,
+                                             size_t row_stride);
+
+  /// \brief Removes tensors which are no longer used after an operation from
+  /// the tensor map
+  /// \param[in] op Operation after which to free tensors
+  /// \param[in,out] tensor_map Map from which to remove the tensors
+  void free_obsolete_tensors(const Node& op, TensorMap& tensor_map);
+
+  /// \brief Removes a tensor from the tensor map, recycling its ciphertexts
+  /// if nothing else references the tensor
+  /// \param[in] tensor Graph tensor to free
+  /// \param[in,out] tensor_map Map from which to remove the tensor
+  void free_tensor(const descriptor::Tensor& tensor, TensorMap& tensor_map);
+
+  /// \brief Runs the ops of the function one at a time, in topological order
+  /// \param[in,out] tensor_map Map storing the tensors of the function
+  void run_ops_in_order(TensorMap& tensor_map);
+
+  /// \brief Runs up to m_inter_op_threads ops of the function at once on the
+  /// task runtime, each once its arguments are computed. Client-aided ops run
+  /// one at a time, so independent ops run while awaiting the client. ReLUs
+  /// are not streamed
+  /// \param[in,out] tensor_map Map storing the tensors of the function
+  void run_ops_concurrently(TensorMap& tensor_map);
+
+  /// \brief Provides storage for the ciphertexts of a new output tensor, at
+  /// the level of its arguments. The ciphertexts are stored in a slab if
+  /// SLAB_TENSOR_STORAGE is set, or else taken from the ciphertext pool, if
+  /// any are available
+  /// \param[in,out] tensor Output tensor
+  /// \param[in] args Arguments of the op computing the tensor
+  void allocate_output_ciphertexts(
+      HETensor& tensor, const std::vector<std::shared_ptr<HETensor>>& args);
+
   void generate_calls(const element::Type& type,
                       const NodeWrapper& node_wrapper,
                       const std::vector<std::shared_ptr<HETensor>>& out,
                       const std::vector<std::shared_ptr<HETensor>>& args);
 
+  /// \brief Returns the cache of encoded values of a node's input. Since
+  /// Constant nodes never change, their values are encoded once and reused
+  /// across calls and client sessions.
+  /// \param[in] node Node whose input to return the cache of
+  /// \param[in] input_idx Index of the input
+  /// \returns Pointer to the cache, or nullptr if the input is not produced
+  /// by a Constant node
+  SealPlaintextCache* get_constant_cache(const Node& node, size_t input_idx);
+
+  /// \brief Opens the acceptor listening for client connections
+  void open_acceptor();
+
+  /// \brief Calls the function once for each client connecting, until
+  /// m_client_sessions clients have connected, or no client has connected
+  /// for m_client_session_idle_ms after the last session finished. Sessions
+  /// run on the calling thread and on workers of the task runtime, each with
+  /// its own keys, inputs, and ReLU / MaxPool state
+  /// \param[in] outputs Output tensors, used for their types and shapes. Not
+  /// written, since each session's result is encrypted with its client's keys
+  /// and only sent to that client
+  /// \param[in] server_inputs Input tensor arguments to the function
+  /// \returns True if every session succeeded, false otherwise
+  bool call_client_sessions(
+      const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+      const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs);
+
+  /// \brief Calls the function for the client connected to the given socket
+  /// \param[in] socket Socket connected to the client
+  /// \param[in] outputs Output tensors, used for their types and shapes. Not
+  /// written
+  /// \param[in] server_inputs Input tensor arguments to the function
+  void run_client_session(
+      boost::asio::ip::tcp::socket socket,
+      const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+      const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs);
+
   bool m_stop_const_fold{flag_to_bool(std::getenv("STOP_CONST_FOLD"))};
+  bool m_stream_relu{flag_to_bool(std::getenv("STREAM_RELU"))};
+  bool m_zero_copy_tcp{flag_to_bool(std::getenv("ZERO_COPY_TCP"))};
+  bool m_slab_tensor_storage{
+      flag_to_bool(std::getenv("SLAB_TENSOR_STORAGE"))};
+  bool m_tensor_views{flag_to_bool(std::getenv("TENSOR_VIEWS"), true)};
+  bool m_packed_image_convolution{
+      flag_to_bool(std::getenv("PACKED_IMAGE_CONVOLUTION"))};
+  std::atomic<size_t> m_output_view_count{0};
+  // Codec of sent ciphertexts, once negotiated with the client
+  CiphertextCodec m_ciphertext_codec{default_ciphertext_codec()};
+
+  // Maximum number of clients served by each call. 1 serves a single client
+  // on the calling thread
+  size_t m_client_sessions{1};
+  // Maximum number of client sessions running concurrently
+  size_t m_client_session_threads{0};
+  // Time without a running session or a new client after which a call stops
+  // accepting clients
+  size_t m_client_session_idle_ms{1000};
+  // Number of ops run concurrently by each call. 1 runs ops in order
+  size_t m_inter_op_threads{1};
+  // Maximum number of threads running the kernel loops of each op. 0 uses all
+  // threads of the task runtime
+  size_t m_intra_op_threads{0};
 };
 }  // namespace ngraph::he
@@ -16,6 +16,10 @@
 
 #include "seal/kernel/add_seal.hpp"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_util.hpp"
 
@@ -60,6 +64,48 @@ void scalar_add_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
   }
 }
 
+void add_tree_seal(const std::vector<const HEType*>& summands, HEType& out,
+                   HESealBackend& he_seal_backend,
+                   const seal::MemoryPoolHandle& pool) {
+  NGRAPH_CHECK(!summands.empty(), "No summands to add");
+  const size_t summand_count = summands.size();
+
+  // The first level writes to new elements, so the summands are never
+  // modified or aliased by the sum
+  std::vector<HEType> partial_sums;
+  partial_sums.reserve((summand_count + 1) / 2);
+  for (size_t i = 0; i + 1 < summand_count; i += 2) {
+    partial_sums.emplace_back(HEPlaintext(), false);
+    scalar_add_seal(*summands[i], *summands[i + 1], partial_sums.back(),
+                    he_seal_backend, pool);
+  }
+  if (summand_count % 2 == 1) {
+    const HEType& last = *summands.back();
+    partial_sums.emplace_back(last);
+    if (last.is_ciphertext()) {
+      partial_sums.back().set_ciphertext(
+          std::make_shared<SealCiphertextWrapper>(*last.get_ciphertext()));
+    }
+  }
+
+  // Remaining levels add neighboring partial sums in-place
+  for (size_t stride = 1; stride < partial_sums.size(); stride *= 2) {
+    for (size_t i = 0; i + stride < partial_sums.size(); i += 2 * stride) {
+      // Accumulate into the ciphertext, since turning the output into a
+      // ciphertext would clear the plaintext operand it aliases
+      if (partial_sums[i].is_plaintext() &&
+          partial_sums[i + stride].is_ciphertext()) {
+        std::swap(partial_sums[i], partial_sums[i + stride]);
+      }
+      scalar_add_seal(partial_sums[i], partial_sums[i + stride],
+                      partial_sums[i], he_seal_backend, pool);
+    }
+  }
+
+  partial_sums[0].batch_size() = summands[0]->batch_size();
+  out = std::move(partial_sums[0]);
+}
+
 void scalar_add_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                      HEPlaintext& out) {
   HEPlaintext out_vals;
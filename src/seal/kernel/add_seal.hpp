@@ -25,6 +25,7 @@
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 /// \brief Adds two ciphertexts
@@ -77,8 +78,11 @@ void scalar_add_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
 /// \param[in] arg1 Cipher or plaintext data to add
 /// \param[in] out Stores the ciphertext or plaintext sum
 /// \param[in] he_seal_backend Backend used to perform addition
-inline void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
-                            HESealBackend& he_seal_backend) {
+/// \param[in] pool Memory pool used for new memory allocation
+inline void scalar_add_seal(
+    const HEType& arg0, const HEType& arg1, HEType& out,
+    HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
   NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                "Complex packing types don't match");
   out.complex_packing() = arg0.complex_packing();
@@ -88,7 +92,7 @@ inline void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_add_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
-                    out.get_ciphertext(), he_seal_backend);
+                    out.get_ciphertext(), he_seal_backend, pool);
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
@@ -114,6 +118,19 @@ inline void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
   }
 }
 
+/// \brief Sums a list of ciphertext/plaintext elements using a balanced binary
+/// tree of additions
+/// \param[in] summands Elements to sum. Must be non-empty. Ciphertexts may be
+/// mod-switched in-place, but are otherwise not modified
+/// \param[out] out Stores the ciphertext or plaintext sum. Never shares a
+/// ciphertext with any of the summands
+/// \param[in] he_seal_backend Backend used to perform addition
+/// \param[in] pool Memory pool used for new memory allocation
+void add_tree_seal(
+    const std::vector<const HEType*>& summands, HEType& out,
+    HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
 /// \brief Adds two vectors of ciphertext/plaintext elements element-wise
 /// \param[in] arg0 Cipher or plaintext data to add
 /// \param[in] arg1 Cipher or plaintext data to add
@@ -132,10 +149,9 @@ inline void add_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_add_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
@@ -20,28 +20,26 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "ngraph/shape_util.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/add_seal.hpp"
 #include "seal/kernel/multiply_seal.hpp"
+#include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
-inline void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
-                          const Shape& arg_shape, const Shape& out_shape,
-                          const Shape& window_shape,
-                          const Strides& window_movement_strides,
-                          const Shape& padding_below,
-                          const Shape& padding_above,
-                          bool include_padding_in_avg_computation,
-                          size_t batch_size, HESealBackend& he_seal_backend) {
+inline IndexPlan avg_pool_seal_index_plan(
+    const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
+    const Strides& window_movement_strides, const Shape& padding_below,
+    const Shape& padding_above, bool include_padding_in_avg_computation) {
   // At the outermost level we will walk over every output coordinate O.
   CoordinateTransform output_transform(out_shape);
 
+  IndexPlan plan({arg_shape}, out_shape);
   for (const Coordinate& out_coord : output_transform) {
-    size_t out_coord_idx = output_transform.index(out_coord);
-
     // Our output coordinate O will have the form:
     //
     //   (N,chan,i_1,...,i_n)
@@ -107,62 +105,84 @@ inline void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
         input_batch_transform_padding_below,
         input_batch_transform_padding_above);
 
-    // As we go, we compute the sum value:
-    //
-    //   output[O] := output[O] + arg[I]
-    //
-    // and the number of elements:
+    // Gather the window elements, and count the number of elements:
     //
     //   n_elements := n_elements + 1
-
-    // T result = 0;
-    // TODO(fboemer): better type which matches arguments?
-    auto sum = HEType(HEPlaintext(), false);
-    bool first_add = true;
-
+    //
+    // Padding elements are zero, so they only contribute to n_elements.
     size_t n_elements = 0;
 
     for (const Coordinate& input_batch_coord : input_batch_transform) {
       bool in_bounds =
           input_batch_transform.has_source_coordinate(input_batch_coord);
 
+      if (in_bounds) {
+        plan.add_entry(input_batch_transform.index(input_batch_coord));
+      }
       if (in_bounds || include_padding_in_avg_computation) {
-        // T v = in_bounds ?: 0;
-        // result += v;
-
-        if (first_add) {
-          sum = arg[input_batch_transform.index(input_batch_coord)];
-          // TODO(fboemer): batch size number of zeros?
-          HEPlaintext zero(std::vector<double>{0});
-          out[out_coord_idx].set_plaintext(zero);
-          first_add = false;
-        } else {
-          scalar_add_seal(sum,
-                          arg[input_batch_transform.index(input_batch_coord)],
-                          sum, he_seal_backend);
-        }
         n_elements++;
       }
     }
+    plan.end_output(n_elements);
+  }
+  return plan;
+}
 
+inline void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                          const IndexPlan& plan, size_t batch_size,
+                          HESealBackend& he_seal_backend) {
+  // Windows overlap, so bring all inputs to the same level up-front rather
+  // than mod-switching shared inputs from multiple threads
+  match_to_smallest_chain_index(arg, he_seal_backend);
+
+  parallel_for(0, plan.output_count(), [&](size_t out_idx) {
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+    size_t n_elements = plan.element_count(out_idx);
     if (n_elements == 0) {
       throw std::runtime_error("AvgPool elements == 0, must be non-zero");
     }
 
-    if (first_add) {
+    std::vector<const HEType*> summands;
+    summands.reserve(plan.entry_end(out_idx) - plan.entry_begin(out_idx));
+    for (size_t entry_idx = plan.entry_begin(out_idx);
+         entry_idx < plan.entry_end(out_idx); ++entry_idx) {
+      summands.emplace_back(&arg[plan.arg_index(entry_idx)]);
+    }
+
+    if (summands.empty()) {
       // TODO(fboemer): batch size number of zeros?
       HEPlaintext zero(std::vector<double>{0});
-      out[out_coord_idx].set_plaintext(zero);
+      out[out_idx].set_plaintext(zero);
     } else {
+      // Summing as a tree keeps the number of additions into any one
+      // intermediate value logarithmic in the window size
+      HEType& sum = out[out_idx];
+      add_tree_seal(summands, sum, he_seal_backend, pool);
+
       // TODO(fboemer): batch size number of zeros?
       auto inv_n_elements =
           HEType(HEPlaintext(std::vector<double>{1.f / n_elements}),
                  sum.complex_packing());
 
-      scalar_multiply_seal(sum, inv_n_elements, sum, he_seal_backend);
-      out[out_coord_idx] = sum;
+      scalar_multiply_seal(sum, inv_n_elements, sum, he_seal_backend, pool);
     }
-  }
+  });
+}
+
+inline void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                          const Shape& arg_shape, const Shape& out_shape,
+                          const Shape& window_shape,
+                          const Strides& window_movement_strides,
+                          const Shape& padding_below,
+                          const Shape& padding_above,
+                          bool include_padding_in_avg_computation,
+                          size_t batch_size, HESealBackend& he_seal_backend) {
+  avg_pool_seal(arg, out,
+                avg_pool_seal_index_plan(arg_shape, out_shape, window_shape,
+                                         window_movement_strides, padding_below,
+                                         padding_above,
+                                         include_padding_in_avg_computation),
+                batch_size, he_seal_backend);
 }
 
 }  // namespace ngraph::he
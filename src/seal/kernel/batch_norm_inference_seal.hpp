@@ -27,6 +27,7 @@
 #include "seal/kernel/add_seal.hpp"
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/kernel/subtract_seal.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 inline void batch_norm_inference_seal(
@@ -44,8 +45,7 @@ inline void batch_norm_inference_seal(
   }
   size_t input_transform_size = input_coords.size();
 
-#pragma omp parallel for
-  for (size_t i = 0; i < input_transform_size; ++i) {
+  parallel_for(0, input_transform_size, [&](size_t i) {
     Coordinate input_coord = input_coords[i];
     // for (Coordinate input_coord : input_transform) {
     auto channel_num = input_coord[1];
@@ -92,6 +92,6 @@ inline void batch_norm_inference_seal(
 
     scalar_add_seal(normed_input[input_index], he_bias,
                     normed_input[input_index], he_seal_backend);
-  }
+  });
 };
 }  // namespace ngraph::he
@@ -23,6 +23,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
@@ -35,11 +36,12 @@ void scalar_bounded_relu_seal(const HEPlaintext& arg, HEPlaintext& out,
   std::transform(arg.begin(), arg.end(), out.begin(), bounded_relu);
 }
 
-void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
-                              const seal::parms_id_type& parms_id, double scale,
-                              seal::CKKSEncoder& ckks_encoder,
-                              seal::Encryptor& encryptor,
-                              seal::Decryptor& decryptor) {
+void scalar_bounded_relu_seal(
+    const HEType& arg, HEType& out, float alpha,
+    const seal::parms_id_type& parms_id, double scale,
+    seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
+    seal::Decryptor& decryptor,
+    const std::shared_ptr<seal::SEALContext>& seeded_context) {
   if (arg.is_plaintext()) {
     out.set_plaintext(arg.get_plaintext());
     scalar_bounded_relu_seal(arg.get_plaintext(), out.get_plaintext(), alpha);
@@ -49,7 +51,7 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
             ckks_encoder);
     scalar_bounded_relu_seal(plain, plain, alpha);
     encrypt(out.get_ciphertext(), plain, parms_id, ngraph::element::f32, scale,
-            ckks_encoder, encryptor, arg.complex_packing());
+            ckks_encoder, encryptor, arg.complex_packing(), seeded_context);
   }
 }
 
@@ -64,10 +66,9 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
 void bounded_relu_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                        float alpha, size_t count,
                        const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_bounded_relu_seal(arg[i], out[i], alpha, he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
@@ -29,11 +29,15 @@ namespace ngraph::he {
 void scalar_bounded_relu_seal(const HEPlaintext& arg, HEPlaintext& out,
                               float alpha);
 
-void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
-                              const seal::parms_id_type& parms_id, double scale,
-                              seal::CKKSEncoder& ckks_encoder,
-                              seal::Encryptor& encryptor,
-                              seal::Decryptor& decryptor);
+/// \brief Computes bounded ReLU by decrypting and re-encrypting
+/// \param[in] seeded_context If not nullptr, the result is encrypted as a
+/// seeded ciphertext. See encrypt()
+void scalar_bounded_relu_seal(
+    const HEType& arg, HEType& out, float alpha,
+    const seal::parms_id_type& parms_id, double scale,
+    seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
+    seal::Decryptor& decryptor,
+    const std::shared_ptr<seal::SEALContext>& seeded_context = nullptr);
 
 void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
                               const HESealBackend& he_seal_backend);
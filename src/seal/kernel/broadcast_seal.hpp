@@ -20,21 +20,37 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "ngraph/shape_util.hpp"
+#include "seal/kernel/gather_seal.hpp"
 
 namespace ngraph::he {
-inline void broadcast_seal(const std::vector<HEType>& arg,
-                           std::vector<HEType>& out, const Shape& in_shape,
-                           const Shape& out_shape,
-                           const AxisSet& broadcast_axes) {
+inline IndexPlan broadcast_seal_index_plan(const Shape& in_shape,
+                                           const Shape& out_shape,
+                                           const AxisSet& broadcast_axes) {
   CoordinateTransform input_transform(in_shape);
   CoordinateTransform output_transform(out_shape);
+
+  IndexPlan plan({in_shape}, out_shape);
   for (const Coordinate& output_coord : output_transform) {
     Coordinate input_coord = reduce(output_coord, broadcast_axes);
-
-    out[output_transform.index(output_coord)] =
-        arg[input_transform.index(input_coord)];
+    plan.add_entry(input_transform.index(input_coord));
+    plan.end_output();
   }
-};
+  return plan;
+}
+
+inline void broadcast_seal(const std::vector<HEType>& arg,
+                           std::vector<HEType>& out, const IndexPlan& plan) {
+  gather_seal(arg, out, plan);
+}
+
+inline void broadcast_seal(const std::vector<HEType>& arg,
+                           std::vector<HEType>& out, const Shape& in_shape,
+                           const Shape& out_shape,
+                           const AxisSet& broadcast_axes) {
+  broadcast_seal(
+      arg, out, broadcast_seal_index_plan(in_shape, out_shape, broadcast_axes));
+}
 }  // namespace ngraph::he
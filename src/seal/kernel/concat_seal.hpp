@@ -19,56 +19,59 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "ngraph/shape_util.hpp"
 
 namespace ngraph::he {
-inline void concat_seal(const std::vector<std::vector<HEType>>& args,
-                        std::vector<HEType>& out,
-                        const std::vector<Shape>& in_shapes,
-                        const Shape& out_shape, size_t concatenation_axis) {
-  // We will copy the inputs to the output one at a time. As we go, we will move
-  // out along the concatenation axis, starting at 0.
+/// \brief Returns the plan gathering each output element from the argument
+/// covering its position along the concatenation axis. Entries store the
+/// argument element index, and the index of the argument
+inline IndexPlan concat_seal_index_plan(const std::vector<Shape>& in_shapes,
+                                        const Shape& out_shape,
+                                        size_t concatenation_axis) {
+  IndexPlan plan(in_shapes, out_shape);
+  // CoordinateTransform gets confused by zero-size dims, and there is nothing
+  // to gather anyway
+  if (shape_size(out_shape) == 0) {
+    return plan;
+  }
+
+  std::vector<size_t> arg_ends;
+  std::vector<Strides> arg_strides;
   size_t concatenation_pos = 0;
+  for (const auto& in_shape : in_shapes) {
+    concatenation_pos += in_shape[concatenation_axis];
+    arg_ends.emplace_back(concatenation_pos);
+    arg_strides.emplace_back(row_major_strides(in_shape));
+  }
 
-  for (size_t i = 0; i < args.size(); i++) {
-    // CoordinateTransform gets confused when the last input has a zero-size
-    // dim, so we will just skip for zero-element tensors.
-    if (shape_size(in_shapes[i]) == 0) {
-      continue;
+  CoordinateTransform output_transform(out_shape);
+  for (const Coordinate& out_coord : output_transform) {
+    size_t axis_pos = out_coord[concatenation_axis];
+    size_t arg_idx = 0;
+    while (axis_pos >= arg_ends[arg_idx]) {
+      ++arg_idx;
     }
+    size_t arg_begin = arg_idx == 0 ? 0 : arg_ends[arg_idx - 1];
 
-    // The start coordinate for the copy is (0,...,0) except at the
-    // concatenation axis.
-    Coordinate out_start_coord(out_shape.size(), 0);
-    out_start_coord[concatenation_axis] = concatenation_pos;
-
-    // The end coordinate for the copy is the same as the output shape except at
-    // the concatenation axis.
-    Coordinate out_end_coord = out_shape;
-    out_end_coord[concatenation_axis] =
-        concatenation_pos + in_shapes[i][concatenation_axis];
-
-    CoordinateTransform input_transform(in_shapes[i]);
-    CoordinateTransform output_chunk_transform(out_shape, out_start_coord,
-                                               out_end_coord);
-
-    NGRAPH_CHECK(shape_size(input_transform.get_target_shape()) ==
-                 shape_size(output_chunk_transform.get_target_shape()));
-
-    CoordinateTransform::Iterator output_chunk_it =
-        output_chunk_transform.begin();
-
-    for (const Coordinate& input_coord : input_transform) {
-      size_t input_index = input_transform.index(input_coord);
-      size_t output_chunk_index =
-          output_chunk_transform.index(*output_chunk_it);
-      ++output_chunk_it;
-
-      out[output_chunk_index] = args[i][input_index];
+    size_t arg_element = 0;
+    for (size_t axis = 0; axis < out_coord.size(); ++axis) {
+      size_t in_pos =
+          axis == concatenation_axis ? axis_pos - arg_begin : out_coord[axis];
+      arg_element += in_pos * arg_strides[arg_idx][axis];
     }
+    plan.add_gather_entry(arg_element, arg_idx);
+    plan.end_output();
+  }
+  return plan;
+}
 
-    concatenation_pos += in_shapes[i][concatenation_axis];
+inline void concat_seal(const std::vector<const std::vector<HEType>*>& args,
+                        std::vector<HEType>& out, const IndexPlan& plan) {
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    const std::vector<HEType>& arg = *args[plan.gather_arg(out_idx)];
+    out[out_idx] = arg[plan.gather_index(out_idx)];
   }
 }
 
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 #include "util.hpp"
 
 namespace ngraph::he {
@@ -34,8 +35,7 @@ void constant_seal(std::vector<HEType>& out, const element::Type& element_type,
     throw ngraph_error("out.size() != count for constant op");
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     const void* src = static_cast<const char*>(data_ptr) + i * type_byte_size;
     auto plaintext =
         HEPlaintext(std::vector<double>{type_to_double(src, element_type)});
@@ -45,7 +45,7 @@ void constant_seal(std::vector<HEType>& out, const element::Type& element_type,
       he_seal_backend.encrypt(out[i].get_ciphertext(), plaintext, element_type,
                               he_seal_backend.complex_packing());
     }
-  }
+  });
 }
 
 }  // namespace ngraph::he
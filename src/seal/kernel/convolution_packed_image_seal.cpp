@@ -0,0 +1,310 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/convolution_packed_image_seal.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
+
+namespace ngraph::he {
+
+namespace {
+/// \brief Returns the rotation step which aligns a filter tap's input
+/// elements with the output positions
+int tap_step(size_t tap_row, size_t tap_col,
+             const CoordinateDiff& padding_below, size_t row_stride) {
+  auto row_offset = static_cast<int>(tap_row) -
+                    static_cast<int>(padding_below[0]);
+  auto col_offset = static_cast<int>(tap_col) -
+                    static_cast<int>(padding_below[1]);
+  return row_offset * static_cast<int>(row_stride) + col_offset;
+}
+}  // namespace
+
+std::vector<int> convolution_packed_image_rotation_steps(
+    const Shape& filter_shape, const CoordinateDiff& padding_below,
+    size_t row_stride) {
+  NGRAPH_CHECK(filter_shape.size() == 4, "Filter shape ", filter_shape,
+               " must have rank 4");
+  NGRAPH_CHECK(padding_below.size() == 2, "Padding must have 2 dimensions");
+  std::vector<int> steps;
+  for (size_t tap_row = 0; tap_row < filter_shape[2]; ++tap_row) {
+    for (size_t tap_col = 0; tap_col < filter_shape[3]; ++tap_col) {
+      int step = tap_step(tap_row, tap_col, padding_below, row_stride);
+      if (step != 0 &&
+          std::find(steps.begin(), steps.end(), step) == steps.end()) {
+        steps.emplace_back(step);
+      }
+    }
+  }
+  return steps;
+}
+
+void convolution_packed_image_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& image_shape,
+    const Shape& filter_shape, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, size_t row_stride,
+    HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(image_shape.size() == 3, "Image shape ", image_shape,
+               " must have rank 3");
+  NGRAPH_CHECK(filter_shape.size() == 4, "Filter shape ", filter_shape,
+               " must have rank 4");
+  NGRAPH_CHECK(padding_below.size() == 2 && padding_above.size() == 2,
+               "Padding must have 2 dimensions");
+
+  const size_t in_channels = image_shape[0];
+  const size_t rows = image_shape[1];
+  const size_t cols = image_shape[2];
+  const size_t out_channels = filter_shape[0];
+  const size_t filter_rows = filter_shape[2];
+  const size_t filter_cols = filter_shape[3];
+  NGRAPH_CHECK(filter_shape[1] == in_channels, "Filter has ", filter_shape[1],
+               " input channels (expected ", in_channels, ")");
+
+  const auto padded_rows = static_cast<int64_t>(rows) + padding_below[0] +
+                           padding_above[0];
+  const auto padded_cols = static_cast<int64_t>(cols) + padding_below[1] +
+                           padding_above[1];
+  NGRAPH_CHECK(padded_rows >= static_cast<int64_t>(filter_rows) &&
+                   padded_cols >= static_cast<int64_t>(filter_cols),
+               "Filter is larger than the padded image");
+  const auto out_rows = static_cast<size_t>(padded_rows - filter_rows + 1);
+  const auto out_cols = static_cast<size_t>(padded_cols - filter_cols + 1);
+
+  NGRAPH_CHECK(arg0.size() == in_channels, "Image has ", arg0.size(),
+               " channels (expected ", in_channels, ")");
+  NGRAPH_CHECK(arg1.size() == shape_size(filter_shape), "Filter has ",
+               arg1.size(), " elements (expected ", shape_size(filter_shape),
+               ")");
+  NGRAPH_CHECK(out.size() == out_channels, "Output has ", out.size(),
+               " channels (expected ", out_channels, ")");
+  NGRAPH_CHECK(row_stride >= cols && row_stride >= out_cols, "Row stride ",
+               row_stride, " is smaller than the image width");
+
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  NGRAPH_CHECK(std::max(rows, out_rows) * row_stride <= slot_count,
+               "Image does not fit in ", slot_count, " slots");
+
+  const seal::Evaluator& evaluator = *he_seal_backend.get_evaluator();
+  const seal::GaloisKeys& galois_keys = *he_seal_backend.get_galois_keys();
+
+  const size_t tap_count = filter_rows * filter_cols;
+  std::vector<seal::Ciphertext> rotations(tap_count);
+  std::vector<seal::Ciphertext> sums(out_channels);
+  std::vector<char> sum_set(out_channels, 0);
+
+  const SealCiphertextWrapper* first_cipher = nullptr;
+  for (size_t in_channel = 0; in_channel < in_channels; ++in_channel) {
+    const HEType& channel = arg0[in_channel];
+    // Output channels of a previous convolution whose weights are all zero
+    // are plaintext zeros, and contribute nothing
+    if (channel.is_plaintext() &&
+        std::all_of(channel.get_plaintext().begin(),
+                    channel.get_plaintext().end(),
+                    [](double value) { return value == 0; })) {
+      continue;
+    }
+    NGRAPH_CHECK(channel.is_ciphertext(),
+                 "Packed image convolution requires ciphertext channels");
+    NGRAPH_CHECK(!channel.complex_packing(),
+                 "Packed image convolution does not support complex packing");
+    const SealCiphertextWrapper& cipher = *channel.get_ciphertext();
+    NGRAPH_CHECK(he_seal_backend.get_chain_index(cipher) > 0,
+                 "Multiplicative depth limit reached");
+    if (first_cipher == nullptr) {
+      first_cipher = &cipher;
+    }
+    NGRAPH_CHECK(cipher.ciphertext().parms_id() ==
+                         first_cipher->ciphertext().parms_id() &&
+                     cipher.scale() == first_cipher->scale(),
+                 "Image channels must have the same level and scale");
+
+    // The rotations of an input channel are shared by all output channels
+    parallel_for(0, tap_count, [&](size_t tap) {
+      int step = tap_step(tap / filter_cols, tap % filter_cols, padding_below,
+                          row_stride);
+      if (step == 0) {
+        rotations[tap] = cipher.ciphertext();
+      } else {
+        evaluator.rotate_vector(cipher.ciphertext(), step, galois_keys,
+                                rotations[tap]);
+      }
+    });
+
+    parallel_for(0, out_channels, [&](size_t out_channel) {
+      seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+      seal::Ciphertext product(pool);
+      HEPlaintext mask(slot_count, 0);
+      SealPlaintextWrapper encoded(seal::Plaintext(pool), false);
+
+      for (size_t tap = 0; tap < tap_count; ++tap) {
+        const size_t tap_row = tap / filter_cols;
+        const size_t tap_col = tap % filter_cols;
+        const size_t filter_idx =
+            (out_channel * in_channels + in_channel) * tap_count + tap;
+        const HEType& weight = arg1[filter_idx];
+        NGRAPH_CHECK(weight.is_plaintext(),
+                     "Packed image convolution requires a plaintext filter");
+        const double value = weight.get_plaintext()[0];
+        // Multiplying by zero yields a transparent ciphertext
+        if (value == 0) {
+          continue;
+        }
+
+        // Mask the output positions whose tap reads inside the image
+        std::fill(mask.begin(), mask.end(), 0);
+        bool any_valid = false;
+        for (size_t out_row = 0; out_row < out_rows; ++out_row) {
+          auto in_row = static_cast<int64_t>(out_row + tap_row) -
+                        padding_below[0];
+          if (in_row < 0 || in_row >= static_cast<int64_t>(rows)) {
+            continue;
+          }
+          for (size_t out_col = 0; out_col < out_cols; ++out_col) {
+            auto in_col = static_cast<int64_t>(out_col + tap_col) -
+                          padding_below[1];
+            if (in_col < 0 || in_col >= static_cast<int64_t>(cols)) {
+              continue;
+            }
+            mask[out_row * row_stride + out_col] = value;
+            any_valid = true;
+          }
+        }
+        if (!any_valid) {
+          continue;
+        }
+
+        encode(encoded, mask, *he_seal_backend.get_ckks_encoder(),
+               cipher.ciphertext().parms_id(), element::f64, cipher.scale(),
+               false);
+        if (sum_set[out_channel] == 0) {
+          evaluator.multiply_plain(rotations[tap], encoded.plaintext(),
+                                   sums[out_channel], pool);
+          sum_set[out_channel] = 1;
+        } else {
+          evaluator.multiply_plain(rotations[tap], encoded.plaintext(),
+                                   product, pool);
+          evaluator.add_inplace(sums[out_channel], product);
+        }
+      }
+    });
+  }
+
+  for (size_t out_channel = 0; out_channel < out_channels; ++out_channel) {
+    HEType& out_type = out[out_channel];
+    out_type.complex_packing() = false;
+    out_type.batch_size() = out_rows * row_stride;
+    if (sum_set[out_channel] != 0) {
+      out_type.set_ciphertext(HESealBackend::create_empty_ciphertext());
+      out_type.get_ciphertext()->ciphertext() = std::move(sums[out_channel]);
+    } else {
+      out_type.set_plaintext(HEPlaintext(out_rows * row_stride, 0));
+    }
+  }
+}
+
+void pack_image_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                     const Shape& image_shape, size_t row_stride,
+                     HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(image_shape.size() == 3, "Image shape ", image_shape,
+               " must have rank 3");
+  const size_t channels = image_shape[0];
+  const size_t rows = image_shape[1];
+  const size_t cols = image_shape[2];
+  const size_t channel_size = rows * cols;
+  NGRAPH_CHECK(arg.size() == channels * channel_size, "Image has ",
+               arg.size(), " elements (expected ", channels * channel_size,
+               ")");
+  NGRAPH_CHECK(out.size() == channels, "Output has ", out.size(),
+               " channels (expected ", channels, ")");
+  NGRAPH_CHECK(row_stride >= cols, "Row stride ", row_stride,
+               " is smaller than the image width");
+
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  NGRAPH_CHECK(rows * row_stride <= slot_count, "Image does not fit in ",
+               slot_count, " slots");
+  const seal::Evaluator& evaluator = *he_seal_backend.get_evaluator();
+  seal::CKKSEncoder& ckks_encoder = *he_seal_backend.get_ckks_encoder();
+
+  parallel_for(0, channels, [&](size_t channel) {
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+    seal::Ciphertext sum(pool);
+    seal::Ciphertext product(pool);
+    HEPlaintext plain_values(rows * row_stride, 0);
+    HEPlaintext mask(slot_count, 0);
+    SealPlaintextWrapper encoded(seal::Plaintext(pool), false);
+    const SealCiphertextWrapper* first_cipher = nullptr;
+
+    for (size_t pixel = 0; pixel < channel_size; ++pixel) {
+      const HEType& element = arg[channel * channel_size + pixel];
+      const size_t slot = (pixel / cols) * row_stride + pixel % cols;
+      if (element.is_plaintext()) {
+        plain_values[slot] = element.get_plaintext()[0];
+        continue;
+      }
+      NGRAPH_CHECK(!element.complex_packing(),
+                   "Image packing does not support complex packing");
+      const SealCiphertextWrapper& cipher = *element.get_ciphertext();
+      NGRAPH_CHECK(he_seal_backend.get_chain_index(cipher) > 0,
+                   "Multiplicative depth limit reached");
+      if (first_cipher != nullptr) {
+        NGRAPH_CHECK(cipher.ciphertext().parms_id() ==
+                             first_cipher->ciphertext().parms_id() &&
+                         cipher.scale() == first_cipher->scale(),
+                     "Image elements must have the same level and scale");
+      }
+
+      // The element fills every slot, so a one-hot mask selects its slot
+      mask[slot] = 1;
+      encode(encoded, mask, ckks_encoder, cipher.ciphertext().parms_id(),
+             element::f64, cipher.scale(), false);
+      mask[slot] = 0;
+      if (first_cipher == nullptr) {
+        evaluator.multiply_plain(cipher.ciphertext(), encoded.plaintext(),
+                                 sum, pool);
+        first_cipher = &cipher;
+      } else {
+        evaluator.multiply_plain(cipher.ciphertext(), encoded.plaintext(),
+                                 product, pool);
+        evaluator.add_inplace(sum, product);
+      }
+    }
+
+    HEType& out_type = out[channel];
+    out_type.complex_packing() = false;
+    out_type.batch_size() = rows * row_stride;
+    if (first_cipher == nullptr) {
+      out_type.set_plaintext(std::move(plain_values));
+      return;
+    }
+    if (std::any_of(plain_values.begin(), plain_values.end(),
+                    [](double value) { return value != 0; })) {
+      encode(encoded, plain_values, ckks_encoder, sum.parms_id(),
+             element::f64, sum.scale(), false);
+      evaluator.add_plain_inplace(sum, encoded.plaintext());
+    }
+    out_type.set_ciphertext(HESealBackend::create_empty_ciphertext());
+    out_type.get_ciphertext()->ciphertext() = std::move(sum);
+  });
+}
+
+}  // namespace ngraph::he
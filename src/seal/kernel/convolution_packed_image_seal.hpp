@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "ngraph/coordinate_diff.hpp"
+#include "ngraph/shape.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::he {
+/// \brief Returns the rotation steps used by convolution_packed_image_seal
+/// \param[in] filter_shape Shape of the filter, (C_out, C_in, rows, columns)
+/// \param[in] padding_below Padding below the image rows and columns
+/// \param[in] row_stride Number of slots between consecutive image rows
+/// \returns Rotation steps, where negative steps rotate to the right
+std::vector<int> convolution_packed_image_rotation_steps(
+    const Shape& filter_shape, const CoordinateDiff& padding_below,
+    size_t row_stride);
+
+/// \brief Convolves a batch-1 image whose channels are each packed into the
+/// slots of a single ciphertext.
+///
+/// Image element (i, j) of a channel is stored in slot i * row_stride + j.
+/// Each output channel is the sum over input channels and filter taps of the
+/// input channel rotated by the tap's offset, multiplied with a plaintext
+/// mask. The mask holds the tap's weight at the output positions whose tap
+/// reads an element inside the image, and zero elsewhere. The rotations of an
+/// input channel are computed once and shared by all output channels. Only
+/// unit window strides and dilations are supported.
+/// \param[in] arg0 Ciphertexts storing the C_in image channels. Slots outside
+/// the image are ignored. Plaintext channels must be zero
+/// \param[in] arg1 Plaintext filter of shape filter_shape
+/// \param[out] out Stores the C_out output channels, using the same row
+/// stride. Slots outside the output image are zero
+/// \param[in] image_shape Shape of the image, (C_in, rows, columns)
+/// \param[in] filter_shape Shape of the filter, (C_out, C_in, rows, columns)
+/// \param[in] padding_below Padding below the image rows and columns
+/// \param[in] padding_above Padding above the image rows and columns
+/// \param[in] row_stride Number of slots between consecutive image rows. Must
+/// be at least the number of output columns
+/// \param[in] he_seal_backend Backend whose Galois keys are used for rotations
+void convolution_packed_image_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& image_shape,
+    const Shape& filter_shape, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, size_t row_stride,
+    HESealBackend& he_seal_backend);
+
+/// \brief Packs a batch-1 image, stored one element per ciphertext or
+/// plaintext, into one ciphertext per channel, with image element (i, j) of a
+/// channel in slot i * row_stride + j.
+///
+/// Each encrypted element fills every slot, so is multiplied with a one-hot
+/// plaintext mask selecting its slot, and the products of a channel are
+/// summed. The packed channels must be rescaled like the result of a
+/// multiplication.
+/// \param[in] arg Elements of the image, ordered by channel, row, and column.
+/// Ciphertexts must have the same level and scale
+/// \param[out] out Stores the C packed channels. Channels without encrypted
+/// elements are stored as plaintexts
+/// \param[in] image_shape Shape of the image, (C, rows, columns)
+/// \param[in] row_stride Number of slots between consecutive image rows. Must
+/// be at least the number of columns
+/// \param[in] he_seal_backend Backend used for encoding and multiplication
+void pack_image_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                     const Shape& image_shape, size_t row_stride,
+                     HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::he
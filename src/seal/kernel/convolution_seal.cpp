@@ -16,27 +16,90 @@
 
 #include "seal/kernel/convolution_seal.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include "logging/ngraph_he_log.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
-void convolution_seal(
+namespace {
+// Returns the coordinate of a row-major index into a shape
+Coordinate coordinate_of(const Shape& shape, size_t index) {
+  Coordinate coord(shape.size());
+  for (size_t axis = shape.size(); axis-- > 0;) {
+    coord[axis] = index % shape[axis];
+    index /= shape[axis];
+  }
+  return coord;
+}
+
+// Accumulates the outputs [plan_begin, plan_end) of the plan into out,
+// where output i of the plan is out[out_offset + i]
+void convolution_seal_outputs(
     const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
-    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
-    const Shape& out_shape, const Strides& window_movement_strides,
+    const std::vector<SealEncodedPlaintext>* arg1_encodings,
+    std::vector<HEType>& out, const IndexPlan& plan, size_t plan_begin,
+    size_t plan_end, size_t out_offset, size_t batch_size,
+    HESealBackend& he_seal_backend, bool verbose) {
+  // Per-chunk scratch product, allocated from the thread-local memory pool
+  // and reused across every tap of every output in this chunk
+  seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+  HEType prod(he_seal_backend.create_empty_ciphertext(pool), false,
+              batch_size);
+
+  for (size_t plan_idx = plan_begin; plan_idx < plan_end; ++plan_idx) {
+    size_t out_coord_idx = out_offset + plan_idx;
+    // Accumulate directly into the output element
+    HEType& sum = out[out_coord_idx];
+    bool first_add = true;
+
+    for (size_t entry_idx = plan.entry_begin(plan_idx);
+         entry_idx < plan.entry_end(plan_idx); ++entry_idx) {
+      size_t arg1_index = plan.filter_index(entry_idx);
+      const SealEncodedPlaintext* arg1_encoded =
+          arg1_encodings != nullptr ? &(*arg1_encodings)[arg1_index] : nullptr;
+      scalar_multiply_accumulate_seal(arg0[plan.arg_index(entry_idx)],
+                                      arg1[arg1_index], arg1_encoded, sum,
+                                      prod, first_add, he_seal_backend, pool);
+    }
+    if (first_add) {
+      // TODO(fboemer): batch size number of zeros?
+      HEPlaintext zero(std::vector<double>{0});
+      sum.set_plaintext(zero);
+    } else {
+      multiply_accumulate_finalize_seal(sum, he_seal_backend, pool);
+    }
+
+    static const size_t conv_verbosity_idx = 1000;
+    if (verbose && out_coord_idx % conv_verbosity_idx == 0 &&
+        out_coord_idx != 0) {
+      NGRAPH_HE_LOG(3) << "Finished out coord " << out_coord_idx;
+    }
+  }
+}
+}  // namespace
+
+size_t convolution_seal_plan_entry_count(const Shape& arg1_shape,
+                                         const Shape& out_shape) {
+  if (arg1_shape.empty() || arg1_shape[0] == 0) {
+    return 0;
+  }
+  return shape_size(out_shape) * (shape_size(arg1_shape) / arg1_shape[0]);
+}
+
+IndexPlan convolution_seal_index_plan(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
     const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
     const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
     size_t batch_axis_data, size_t input_channel_axis_data,
     size_t input_channel_axis_filters, size_t output_channel_axis_filters,
     size_t batch_axis_result, size_t output_channel_axis_result,
-    bool rotate_filter, const element::Type& element_type, size_t batch_size,
-    HESealBackend& he_seal_backend, bool verbose) {
-  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
-               "Unsupported type ", element_type);
-
+    bool rotate_filter, size_t out_begin, size_t out_end) {
   // Comments throughout assume without loss of generality that:
   //
   // * batch axes for both input data and output data are 0
@@ -46,26 +109,11 @@ void convolution_seal(
   // * rotate_filter is false
 
   // At the outermost level we will walk over every output coordinate O.
-  CoordinateTransform output_transform(out_shape);
-
-  // Store output coordinates for parallelization
-  std::vector<ngraph::Coordinate> out_coords;
-  for (const Coordinate& out_coord : output_transform) {
-    out_coords.emplace_back(out_coord);
-  }
-  size_t out_transform_size = out_coords.size();
-  if (verbose) {
-    NGRAPH_HE_LOG(5) << "Convolution output size " << out_transform_size;
-  }
-
-#pragma omp parallel for
-  for (size_t out_coord_idx = 0; out_coord_idx < out_transform_size;
-       ++out_coord_idx) {
-    // Init thread-local memory pool for each thread
-    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
-
-    const Coordinate& out_coord = out_coords[out_coord_idx];
+  out_end = std::min(out_end, shape_size(out_shape));
 
+  IndexPlan plan({arg0_shape, arg1_shape}, out_shape);
+  for (size_t out_idx = out_begin; out_idx < out_end; ++out_idx) {
+    Coordinate out_coord = coordinate_of(out_shape, out_idx);
     // for (Coordinate out_coord : output_transform)
     //{
     // Our output coordinate O will have the form:
@@ -90,10 +138,9 @@ void convolution_seal(
     //
     //   (1,l_1,...,l_n).
     //
-    // Note that we are iterating within the *padded* and *dilated* data batch,
-    // so further
-    // down we must check the current coordinate is in the padding or dilation
-    // gap.
+    // Note that we are iterating within the *padded* and *dilated* data
+    // batch, so further down we must check the current coordinate is in the
+    // padding or dilation gap.
 
     size_t n_spatial_dimensions = arg0_shape.size() - 2;
     size_t n_input_channels = arg0_shape[input_channel_axis_data];
@@ -101,10 +148,10 @@ void convolution_seal(
     Coordinate input_batch_transform_start(2 + n_spatial_dimensions);
     Coordinate input_batch_transform_end(2 + n_spatial_dimensions);
     Strides input_batch_transform_movement_strides(2 + n_spatial_dimensions, 1);
-    CoordinateDiff input_batch_transform_padding_below(2 + n_spatial_dimensions,
-                                                       0);
-    CoordinateDiff input_batch_transform_padding_above(2 + n_spatial_dimensions,
-                                                       0);
+    CoordinateDiff input_batch_transform_padding_below(
+        2 + n_spatial_dimensions, 0);
+    CoordinateDiff input_batch_transform_padding_above(
+        2 + n_spatial_dimensions, 0);
     Strides input_batch_transform_dilation_strides(2 + n_spatial_dimensions, 1);
 
     input_batch_transform_start[batch_axis_data] = batch_index;
@@ -169,21 +216,15 @@ void convolution_seal(
     CoordinateTransform filter_transform(arg1_shape, filter_transform_start,
                                          filter_transform_end);
 
-    // As we go, we sum up:
+    // As we go, we record the pairs summed up in:
     //
     //   output[O] += arg0[I] * arg1[F].
 
-    // T result = 0;
-
     CoordinateTransform::Iterator input_it = input_batch_transform.begin();
     CoordinateTransform::Iterator filter_it = filter_transform.begin();
     CoordinateTransform::Iterator input_end = input_batch_transform.end();
     CoordinateTransform::Iterator filter_end = filter_transform.end();
 
-    // TODO(fboemer): better type which matches complex packing?
-    auto sum = HEType(HEPlaintext(batch_size), false);
-    bool first_add = true;
-
     while (input_it != input_end && filter_it != filter_end) {
       const Coordinate& input_batch_coord = *input_it;
       Coordinate filter_coord = *filter_it;
@@ -199,38 +240,84 @@ void convolution_seal(
       }
 
       if (input_batch_transform.has_source_coordinate(input_batch_coord)) {
-        auto mult_arg0 = arg0[input_batch_transform.index(input_batch_coord)];
-        auto mult_arg1 = arg1[filter_transform.index(filter_coord)];
-
-        // TODO(fboemer): better type which matches arguments?
-        auto prod = HEType(HEPlaintext(batch_size), false);
-
-        scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
-        if (first_add) {
-          sum = prod;
-          first_add = false;
-        } else {
-          scalar_add_seal(prod, sum, sum, he_seal_backend);
-        }
+        plan.add_entry(input_batch_transform.index(input_batch_coord),
+                       filter_transform.index(filter_coord));
       }
       ++input_it;
       ++filter_it;
     }
-    if (first_add) {
-      // TODO(fboemer): batch size number of zeros?
-      HEPlaintext zero(std::vector<double>{0});
-      out[out_coord_idx].set_plaintext(zero);
-    } else {
-      // Write the sum back.
-      out[out_coord_idx] = sum;
-    }
+    plan.end_output();
+  }
+  return plan;
+}
 
-    static const size_t conv_verbosity_idx = 1000;
-    if (verbose && out_coord_idx % conv_verbosity_idx == 0 &&
-        out_coord_idx != 0) {
-      NGRAPH_HE_LOG(3) << "Finished out coord " << out_coord_idx;
-    }
+void convolution_seal(const std::vector<HEType>& arg0,
+                      const std::vector<HEType>& arg1, std::vector<HEType>& out,
+                      const IndexPlan& plan, const element::Type& element_type,
+                      size_t batch_size, HESealBackend& he_seal_backend,
+                      bool verbose, SealPlaintextCache* arg1_cache) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+
+  size_t out_transform_size = plan.output_count();
+  if (verbose) {
+    NGRAPH_HE_LOG(5) << "Convolution output size " << out_transform_size;
   }
+
+  const std::vector<SealEncodedPlaintext>* arg1_encodings =
+      arg1_cache != nullptr
+          ? arg1_cache->get_encodings(arg1, arg0, he_seal_backend)
+          : nullptr;
+
+  auto convolution_range = [&](size_t range_begin, size_t range_end) {
+    convolution_seal_outputs(arg0, arg1, arg1_encodings, out, plan,
+                             range_begin, range_end, 0, batch_size,
+                             he_seal_backend, verbose);
+  };
+  parallel_for_ranges(0, out_transform_size, convolution_range,
+                      TaskRuntime::global().default_grain(out_transform_size));
+}
+
+void convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    bool rotate_filter, const element::Type& element_type, size_t batch_size,
+    HESealBackend& he_seal_backend, bool verbose,
+    SealPlaintextCache* arg1_cache) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+
+  size_t out_transform_size = shape_size(out_shape);
+  if (verbose) {
+    NGRAPH_HE_LOG(5) << "Convolution output size " << out_transform_size
+                     << " without index plan";
+  }
+
+  const std::vector<SealEncodedPlaintext>* arg1_encodings =
+      arg1_cache != nullptr
+          ? arg1_cache->get_encodings(arg1, arg0, he_seal_backend)
+          : nullptr;
+
+  auto convolution_range = [&](size_t range_begin, size_t range_end) {
+    IndexPlan plan = convolution_seal_index_plan(
+        arg0_shape, arg1_shape, out_shape, window_movement_strides,
+        window_dilation_strides, padding_below, padding_above,
+        data_dilation_strides, batch_axis_data, input_channel_axis_data,
+        input_channel_axis_filters, output_channel_axis_filters,
+        batch_axis_result, output_channel_axis_result, rotate_filter,
+        range_begin, range_end);
+    convolution_seal_outputs(arg0, arg1, arg1_encodings, out, plan, 0,
+                             plan.output_count(), range_begin, batch_size,
+                             he_seal_backend, verbose);
+  };
+  parallel_for_ranges(0, out_transform_size, convolution_range,
+                      TaskRuntime::global().default_grain(out_transform_size));
 }
 
 }  // namespace ngraph::he
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <vector>
 
+#include "index_plan.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "ngraph/type/element_type.hpp"
@@ -26,9 +28,46 @@
 #include "seal/kernel/add_seal.hpp"
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_plaintext_cache.hpp"
 
 namespace ngraph::he {
 
+/// \brief Default maximum number of entries of a Convolution index plan.
+/// Larger convolutions pair inputs with filter elements on the fly instead
+inline constexpr size_t convolution_seal_max_plan_entries = 1UL << 24U;
+
+/// \brief Returns an upper bound on the number of entries of the index plan
+/// of a convolution: each output is the sum of at most one product per filter
+/// element of its output channel
+/// \param[in] arg1_shape Shape of the filter, with output channels first
+/// \param[in] out_shape Shape of the output
+size_t convolution_seal_plan_entry_count(const Shape& arg1_shape,
+                                         const Shape& out_shape);
+
+/// \brief Builds the index plan of the outputs [out_begin, out_end) of a
+/// convolution, in row-major order. Output i of the plan is output
+/// out_begin + i of the convolution
+IndexPlan convolution_seal_index_plan(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    bool rotate_filter, size_t out_begin = 0,
+    size_t out_end = std::numeric_limits<size_t>::max());
+
+void convolution_seal(const std::vector<HEType>& arg0,
+                      const std::vector<HEType>& arg1, std::vector<HEType>& out,
+                      const IndexPlan& plan, const element::Type& element_type,
+                      size_t batch_size, HESealBackend& he_seal_backend,
+                      bool verbose = true,
+                      SealPlaintextCache* arg1_cache = nullptr);
+
+/// \brief Computes a convolution without a precomputed index plan. Each chunk
+/// of outputs builds the plan of its outputs only, which bounds the memory
+/// used by plans of large convolutions
 void convolution_seal(
     const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
     std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
@@ -39,6 +78,7 @@ void convolution_seal(
     size_t input_channel_axis_filters, size_t output_channel_axis_filters,
     size_t batch_axis_result, size_t output_channel_axis_result,
     bool rotate_filter, const element::Type& element_type, size_t batch_size,
-    HESealBackend& he_seal_backend, bool verbose = true);
+    HESealBackend& he_seal_backend, bool verbose = true,
+    SealPlaintextCache* arg1_cache = nullptr);
 
 }  // namespace ngraph::he
@@ -24,6 +24,7 @@
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
@@ -93,10 +94,9 @@ void divide_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_divide_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
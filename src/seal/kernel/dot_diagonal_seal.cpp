@@ -0,0 +1,179 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/dot_diagonal_seal.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
+
+namespace ngraph::he {
+
+namespace {
+/// \brief Returns the number of baby steps for a vector of the given size
+size_t baby_step_count(size_t arg0_size) {
+  auto baby_steps = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(arg0_size))));
+  return std::min(std::max<size_t>(baby_steps, 1), arg0_size);
+}
+
+/// \brief Returns the number of copies of the vector needed such that every
+/// rotation used by the diagonal method reads a valid element
+size_t vector_copy_count(size_t arg0_size, size_t out_size) {
+  size_t copies = 1;
+  while (copies * arg0_size < arg0_size + out_size - 1) {
+    copies *= 2;
+  }
+  return copies;
+}
+}  // namespace
+
+std::vector<int> dot_diagonal_rotation_steps(size_t arg0_size,
+                                             size_t out_size) {
+  std::vector<int> steps;
+  size_t copies = vector_copy_count(arg0_size, out_size);
+  for (size_t copied = 1; copied < copies; copied *= 2) {
+    steps.emplace_back(-static_cast<int>(copied * arg0_size));
+  }
+  size_t baby_steps = baby_step_count(arg0_size);
+  for (size_t step = 1; step < baby_steps; ++step) {
+    steps.emplace_back(static_cast<int>(step));
+  }
+  for (size_t step = baby_steps; step < arg0_size; step += baby_steps) {
+    steps.emplace_back(static_cast<int>(step));
+  }
+  return steps;
+}
+
+void dot_diagonal_seal(const HEType& arg0, const std::vector<HEType>& arg1,
+                       HEType& out, size_t arg0_size, size_t out_size,
+                       HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(arg0_size > 0 && out_size > 0, "Empty vector or product");
+  NGRAPH_CHECK(arg1.size() == arg0_size * out_size, "Matrix has ",
+               arg1.size(), " elements (expected ", arg0_size * out_size, ")");
+  NGRAPH_CHECK(arg0.is_ciphertext(), "Diagonal dot requires a ciphertext");
+  NGRAPH_CHECK(!arg0.complex_packing(),
+               "Diagonal dot does not support complex packing");
+  const SealCiphertextWrapper& cipher = *arg0.get_ciphertext();
+  NGRAPH_CHECK(he_seal_backend.get_chain_index(cipher) > 0,
+               "Multiplicative depth limit reached");
+
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  const size_t copies = vector_copy_count(arg0_size, out_size);
+  NGRAPH_CHECK(copies * arg0_size <= slot_count, "Vector of size ", arg0_size,
+               " and product of size ", out_size, " do not fit in ",
+               slot_count, " slots");
+
+  const seal::Evaluator& evaluator = *he_seal_backend.get_evaluator();
+  const seal::GaloisKeys& galois_keys = *he_seal_backend.get_galois_keys();
+
+  // Copy the vector, such that slot i stores element (i mod arg0_size)
+  seal::Ciphertext vector = cipher.ciphertext();
+  for (size_t copied = 1; copied < copies; copied *= 2) {
+    seal::Ciphertext rotated;
+    evaluator.rotate_vector(vector, -static_cast<int>(copied * arg0_size),
+                            galois_keys, rotated);
+    evaluator.add_inplace(vector, rotated);
+  }
+
+  // Baby-step rotations of the vector are shared by all giant steps
+  const size_t baby_steps = baby_step_count(arg0_size);
+  std::vector<seal::Ciphertext> baby_rotations(baby_steps);
+  baby_rotations[0] = vector;
+  parallel_for(1, baby_steps, [&](size_t step) {
+    evaluator.rotate_vector(vector, static_cast<int>(step), galois_keys,
+                            baby_rotations[step]);
+  });
+
+  // Giant step g sums the diagonals g * baby_steps + j, each pre-rotated by
+  // -g * baby_steps and multiplied with the vector rotated by j. Rotating the
+  // sum by g * baby_steps then aligns the products with the output slots
+  const size_t giant_steps = (arg0_size + baby_steps - 1) / baby_steps;
+  std::vector<seal::Ciphertext> giant_sums(giant_steps);
+  std::vector<char> giant_sum_set(giant_steps, 0);
+  const double plain_scale = cipher.scale();
+  const seal::parms_id_type parms_id = cipher.ciphertext().parms_id();
+
+  parallel_for(0, giant_steps, [&](size_t giant_idx) {
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+    const size_t giant_step = giant_idx * baby_steps;
+    seal::Ciphertext& sum = giant_sums[giant_idx];
+    seal::Ciphertext product(pool);
+    HEPlaintext diagonal(slot_count, 0);
+    SealPlaintextWrapper encoded(seal::Plaintext(pool), false);
+
+    for (size_t baby_idx = 0;
+         baby_idx < baby_steps && giant_step + baby_idx < arg0_size;
+         ++baby_idx) {
+      const size_t diagonal_idx = giant_step + baby_idx;
+      bool zero_diagonal = true;
+      std::fill(diagonal.begin(), diagonal.end(), 0);
+      for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+        size_t row = (out_idx + diagonal_idx) % arg0_size;
+        const HEType& weight = arg1[row * out_size + out_idx];
+        NGRAPH_CHECK(weight.is_plaintext(),
+                     "Diagonal dot requires a plaintext matrix");
+        double value = weight.get_plaintext()[0];
+        diagonal[(out_idx + giant_step) % slot_count] = value;
+        zero_diagonal = zero_diagonal && value == 0;
+      }
+      // Multiplying by zero yields a transparent ciphertext
+      if (zero_diagonal) {
+        continue;
+      }
+      encode(encoded, diagonal, *he_seal_backend.get_ckks_encoder(), parms_id,
+             element::f64, plain_scale, false);
+      if (giant_sum_set[giant_idx] == 0) {
+        evaluator.multiply_plain(baby_rotations[baby_idx], encoded.plaintext(),
+                                 sum, pool);
+        giant_sum_set[giant_idx] = 1;
+      } else {
+        evaluator.multiply_plain(baby_rotations[baby_idx], encoded.plaintext(),
+                                 product, pool);
+        evaluator.add_inplace(sum, product);
+      }
+    }
+    if (giant_sum_set[giant_idx] != 0 && giant_step != 0) {
+      evaluator.rotate_vector_inplace(sum, static_cast<int>(giant_step),
+                                      galois_keys, pool);
+    }
+  });
+
+  out.complex_packing() = false;
+  out.batch_size() = out_size;
+  bool first_add = true;
+  for (size_t giant_idx = 0; giant_idx < giant_steps; ++giant_idx) {
+    if (giant_sum_set[giant_idx] == 0) {
+      continue;
+    }
+    if (first_add) {
+      out.set_ciphertext(HESealBackend::create_empty_ciphertext());
+      out.get_ciphertext()->ciphertext() = std::move(giant_sums[giant_idx]);
+      first_add = false;
+    } else {
+      evaluator.add_inplace(out.get_ciphertext()->ciphertext(),
+                            giant_sums[giant_idx]);
+    }
+  }
+  if (first_add) {
+    out.set_plaintext(HEPlaintext(out_size, 0));
+  }
+}
+
+}  // namespace ngraph::he
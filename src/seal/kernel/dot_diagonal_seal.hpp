@@ -0,0 +1,53 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::he {
+/// \brief Returns the rotation steps used by dot_diagonal_seal
+/// \param[in] arg0_size Number of elements in the vector
+/// \param[in] out_size Number of elements in the product
+/// \returns Rotation steps, where negative steps rotate to the right
+std::vector<int> dot_diagonal_rotation_steps(size_t arg0_size,
+                                             size_t out_size);
+
+/// \brief Multiplies a vector, packed into a single ciphertext, with a
+/// plaintext matrix using the diagonal method.
+///
+/// The product is the sum of the matrix's generalized diagonals, each
+/// multiplied with a rotation of the vector. Rotations are split into baby
+/// steps and giant steps, so only about 2 * sqrt(arg0_size) rotations are
+/// performed. The baby-step rotations of the vector are computed once, and
+/// shared across all giant steps.
+/// \param[in] arg0 Ciphertext storing the vector in its first arg0_size slots.
+/// The remaining slots must be zero
+/// \param[in] arg1 Plaintext matrix of shape (arg0_size, out_size)
+/// \param[out] out Stores the product in its first out_size slots. The
+/// remaining slots are zero. Plaintext zeros if the matrix is zero
+/// \param[in] arg0_size Number of elements in the vector
+/// \param[in] out_size Number of elements in the product
+/// \param[in] he_seal_backend Backend whose Galois keys are used for rotations
+/// \throws ngraph_error if the vector and product do not fit in the slots
+void dot_diagonal_seal(const HEType& arg0, const std::vector<HEType>& arg1,
+                       HEType& out, size_t arg0_size, size_t out_size,
+                       HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::he
@@ -16,15 +16,15 @@
 
 #include "seal/kernel/dot_seal.hpp"
 
-#include "seal/kernel/add_seal.hpp"
-#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
               std::vector<HEType>& out, const Shape& arg0_shape,
               const Shape& arg1_shape, const Shape& out_shape,
               size_t reduction_axes_count, const element::Type& element_type,
-              HESealBackend& he_seal_backend) {
+              HESealBackend& he_seal_backend, SealPlaintextCache* arg1_cache) {
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
   // Get the sizes of the dot axes. It's easiest to pull them from arg1
@@ -74,74 +74,84 @@ void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
   size_t arg1_projected_size = arg1_projected_coords.size();
   size_t global_projected_size = arg0_projected_size * arg1_projected_size;
 
-#pragma omp parallel for
-  for (size_t global_projected_idx = 0;
-       global_projected_idx < global_projected_size; ++global_projected_idx) {
-    // Compute outer and inner index
-    size_t arg0_projected_idx = global_projected_idx / arg1_projected_size;
-    size_t arg1_projected_idx = global_projected_idx % arg1_projected_size;
-
-    const Coordinate& arg0_projected_coord =
-        arg0_projected_coords[arg0_projected_idx];
-    const Coordinate& arg1_projected_coord =
-        arg1_projected_coords[arg1_projected_idx];
-
-    // The output coordinate is just the concatenation of the projected
-    // coordinates.
-    Coordinate out_coord(arg0_projected_coord.size() +
-                         arg1_projected_coord.size());
-
-    auto out_coord_it =
-        std::copy(arg0_projected_coord.begin(), arg0_projected_coord.end(),
-                  out_coord.begin());
-    std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
-              out_coord_it);
-
-    size_t out_index = output_transform.index(out_coord);
-
-    // Walk along the dotted axes.
-    Coordinate arg0_coord(arg0_shape.size());
-    Coordinate arg1_coord(arg1_shape.size());
-    auto arg0_it = std::copy(arg0_projected_coord.begin(),
-                             arg0_projected_coord.end(), arg0_coord.begin());
-
-    // TODO(fboemer): better type which matches arguments?
-    auto sum = HEType(HEPlaintext(), false);
-    bool first_add = true;
-
-    for (const Coordinate& dot_axis_positions : dot_axes_transform) {
-      // In order to find the points to multiply together, we need to inject
-      // our current positions along the dotted axes back into the projected
-      // arg0 and arg1 coordinates.
-      std::copy(dot_axis_positions.begin(), dot_axis_positions.end(), arg0_it);
-
-      auto arg1_it = std::copy(dot_axis_positions.begin(),
-                               dot_axis_positions.end(), arg1_coord.begin());
+  const std::vector<SealEncodedPlaintext>* arg1_encodings =
+      arg1_cache != nullptr
+          ? arg1_cache->get_encodings(arg1, arg0, he_seal_backend)
+          : nullptr;
+
+  auto dot_range = [&](size_t range_begin, size_t range_end) {
+    // Per-chunk scratch product, allocated from the thread-local memory pool
+    // and reused across all multiply-accumulates of this chunk
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+    HEType prod(he_seal_backend.create_empty_ciphertext(pool), false, 1);
+
+    for (size_t global_projected_idx = range_begin;
+         global_projected_idx < range_end; ++global_projected_idx) {
+      // Compute outer and inner index
+      size_t arg0_projected_idx = global_projected_idx / arg1_projected_size;
+      size_t arg1_projected_idx = global_projected_idx % arg1_projected_size;
+
+      const Coordinate& arg0_projected_coord =
+          arg0_projected_coords[arg0_projected_idx];
+      const Coordinate& arg1_projected_coord =
+          arg1_projected_coords[arg1_projected_idx];
+
+      // The output coordinate is just the concatenation of the projected
+      // coordinates.
+      Coordinate out_coord(arg0_projected_coord.size() +
+                           arg1_projected_coord.size());
+
+      auto out_coord_it =
+          std::copy(arg0_projected_coord.begin(), arg0_projected_coord.end(),
+                    out_coord.begin());
       std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
-                arg1_it);
-
-      // Multiply and add to the summands.
-      auto mult_arg0 = arg0[arg0_transform.index(arg0_coord)];
-      auto mult_arg1 = arg1[arg1_transform.index(arg1_coord)];
-      // TODO(fboemer): better type which matches arguments?
-      auto prod = HEType(HEPlaintext(), false);
-      scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
+                out_coord_it);
+
+      size_t out_index = output_transform.index(out_coord);
+
+      // Walk along the dotted axes.
+      Coordinate arg0_coord(arg0_shape.size());
+      Coordinate arg1_coord(arg1_shape.size());
+      auto arg0_it = std::copy(arg0_projected_coord.begin(),
+                               arg0_projected_coord.end(), arg0_coord.begin());
+
+      // Accumulate directly into the output element
+      HEType& sum = out[out_index];
+      bool first_add = true;
+
+      for (const Coordinate& dot_axis_positions : dot_axes_transform) {
+        // In order to find the points to multiply together, we need to inject
+        // our current positions along the dotted axes back into the projected
+        // arg0 and arg1 coordinates.
+        std::copy(dot_axis_positions.begin(), dot_axis_positions.end(),
+                  arg0_it);
+
+        auto arg1_it = std::copy(dot_axis_positions.begin(),
+                                 dot_axis_positions.end(), arg1_coord.begin());
+        std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
+                  arg1_it);
+
+        // Multiply and add to the summands.
+        size_t arg1_index = arg1_transform.index(arg1_coord);
+        const SealEncodedPlaintext* arg1_encoded =
+            arg1_encodings != nullptr ? &(*arg1_encodings)[arg1_index]
+                                      : nullptr;
+        scalar_multiply_accumulate_seal(arg0[arg0_transform.index(arg0_coord)],
+                                        arg1[arg1_index], arg1_encoded, sum,
+                                        prod, first_add, he_seal_backend, pool);
+      }
       if (first_add) {
-        sum = prod;
-        first_add = false;
+        // TODO(fboemer): batch size number of zeros?
+        HEPlaintext zero(std::vector<double>{0});
+        sum.set_plaintext(zero);
       } else {
-        scalar_add_seal(prod, sum, sum, he_seal_backend);
+        multiply_accumulate_finalize_seal(sum, he_seal_backend, pool);
       }
     }
-    // Write the sum back.
-    if (first_add) {
-      // TODO(fboemer): batch size number of zeros?
-      HEPlaintext zero(std::vector<double>{0});
-      out[out_index].set_plaintext(zero);
-    } else {
-      out[out_index] = sum;
-    }
-  }
+  };
+  parallel_for_ranges(
+      0, global_projected_size, dot_range,
+      TaskRuntime::global().default_grain(global_projected_size));
 }
 
 }  // namespace ngraph::he
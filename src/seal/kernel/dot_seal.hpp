@@ -22,12 +22,26 @@
 #include "he_type.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/seal_plaintext_cache.hpp"
 
 namespace ngraph::he {
+/// \brief Computes the dot product of two tensors
+/// \param[in] arg0 Cipher or plaintext data of the first argument
+/// \param[in] arg1 Cipher or plaintext data of the second argument
+/// \param[out] out Stores the dot product
+/// \param[in] arg0_shape Shape of the first argument
+/// \param[in] arg1_shape Shape of the second argument
+/// \param[in] out_shape Shape of the output
+/// \param[in] reduction_axes_count Number of axes to reduce over
+/// \param[in] element_type Datatype of the arguments
+/// \param[in] he_seal_backend Backend used to perform the dot product
+/// \param[in] arg1_cache Cache of encodings of arg1, or nullptr. Should only
+/// be set if arg1 does not change between calls
 void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
               std::vector<HEType>& out, const Shape& arg0_shape,
               const Shape& arg1_shape, const Shape& out_shape,
               size_t reduction_axes_count, const element::Type& element_type,
-              HESealBackend& he_seal_backend);
+              HESealBackend& he_seal_backend,
+              SealPlaintextCache* arg1_cache = nullptr);
 
 }  // namespace ngraph::he
@@ -23,6 +23,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
@@ -60,10 +61,9 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
 
 void exp_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
               size_t count, const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_exp_seal(arg[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
@@ -0,0 +1,34 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "index_plan.hpp"
+
+namespace ngraph::he {
+// Copies arg[plan.gather_index(i)] to out[i], for data-movement ops whose
+// plan has one entry per output
+inline void gather_seal(const std::vector<HEType>& arg,
+                        std::vector<HEType>& out, const IndexPlan& plan) {
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    out[out_idx] = arg[plan.gather_index(out_idx)];
+  }
+}
+
+}  // namespace ngraph::he
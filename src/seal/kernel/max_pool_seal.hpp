@@ -21,30 +21,22 @@
 #include <numeric>
 #include <vector>
 
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "seal/kernel/max_seal.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::he {
-// Returns list where L[i] is the list of input indices to maximize over for
-// output i
-inline std::vector<std::vector<size_t>> max_pool_seal_max_list(
+// Returns a plan whose entries for output i are the input indices to maximize
+// over for output i
+inline IndexPlan max_pool_seal_index_plan(
     const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
     const Strides& window_movement_strides, const Shape& padding_below,
     const Shape& padding_above) {
   // At the outermost level we will walk over every output coordinate O.
   CoordinateTransform output_transform(out_shape);
 
-  size_t out_size = 0;
-  for (const Coordinate& out_coord : output_transform) {
-    static_cast<void>(out_coord);  // Avoid unused-variable warning
-    out_size++;
-  }
-  NGRAPH_CHECK(out_size == shape_size(out_shape), "out size ", out_size,
-               " != shape_size(out_shape) ", out_shape);
-
-  std::vector<std::vector<size_t>> maximize_list(shape_size(out_shape));
-
+  IndexPlan plan({arg_shape}, out_shape);
   for (const Coordinate& out_coord : output_transform) {
     // Our output coordinate O will have the form:
     //
@@ -116,45 +108,50 @@ inline std::vector<std::vector<size_t>> max_pool_seal_max_list(
     //
     //   output[O] = max(output[O],arg[I])
 
-    size_t out_index = output_transform.index(out_coord);
     for (const Coordinate& input_batch_coord : input_batch_transform) {
       if (input_batch_transform.has_source_coordinate(input_batch_coord)) {
-        int new_index = input_batch_transform.index(input_batch_coord);
-        maximize_list[out_index].emplace_back(new_index);
+        plan.add_entry(input_batch_transform.index(input_batch_coord));
       }
     }
+    plan.end_output();
   }
-  return maximize_list;
+  NGRAPH_CHECK(plan.output_count() == shape_size(out_shape), "out size ",
+               plan.output_count(), " != shape_size(out_shape) ", out_shape);
+  return plan;
 }
 
-inline void max_pool_seal(
-    const std::vector<HEType>& arg, std::vector<HEType>& out,
-    const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
-    const Strides& window_movement_strides, const Shape& padding_below,
-    const Shape& padding_above, const seal::parms_id_type& parms_id,
-    double scale, seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
-    seal::Decryptor& decryptor) {
-  auto max_lists = max_pool_seal_max_list(arg_shape, out_shape, window_shape,
-                                          window_movement_strides,
-                                          padding_below, padding_above);
-
-  for (size_t out_idx = 0; out_idx < max_lists.size(); ++out_idx) {
-    auto& max_list = max_lists[out_idx];
-    std::vector<HEType> max_args(max_list.size(), HEType(HEPlaintext(), false));
-    for (size_t i = 0; i < max_list.size(); ++i) {
-      max_args[i] = arg[max_list[i]];
+inline void max_pool_seal(const std::vector<HEType>& arg,
+                          std::vector<HEType>& out, const IndexPlan& plan,
+                          const seal::parms_id_type& parms_id, double scale,
+                          seal::CKKSEncoder& ckks_encoder,
+                          seal::Encryptor& encryptor,
+                          seal::Decryptor& decryptor) {
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    size_t window_size = plan.entry_end(out_idx) - plan.entry_begin(out_idx);
+    std::vector<HEType> max_args(window_size, HEType(HEPlaintext(), false));
+    for (size_t i = 0; i < window_size; ++i) {
+      max_args[i] = arg[plan.arg_index(plan.entry_begin(out_idx) + i)];
     }
-    Shape in_shape{max_list.size()};
 
     std::vector<HEType> max_out{out[out_idx]};
 
-    max_seal(max_args, max_out, Shape{max_list.size()}, Shape{}, AxisSet{0},
+    max_seal(max_args, max_out, Shape{window_size}, Shape{}, AxisSet{0},
              out[out_idx].batch_size(), parms_id, scale, ckks_encoder,
              encryptor, decryptor);
     out[out_idx] = max_out[0];
   }
 }
 
+inline void max_pool_seal(const std::vector<HEType>& arg,
+                          std::vector<HEType>& out, const IndexPlan& plan,
+                          HESealBackend& he_seal_backend) {
+  max_pool_seal(arg, out, plan, he_seal_backend.get_context()->first_parms_id(),
+                he_seal_backend.get_scale(),
+                *he_seal_backend.get_ckks_encoder(),
+                *he_seal_backend.get_encryptor(),
+                *he_seal_backend.get_decryptor());
+}
+
 inline void max_pool_seal(const std::vector<HEType>& arg,
                           std::vector<HEType>& out, const Shape& arg_shape,
                           const Shape& out_shape, const Shape& window_shape,
@@ -162,12 +159,11 @@ inline void max_pool_seal(const std::vector<HEType>& arg,
                           const Shape& padding_below,
                           const Shape& padding_above,
                           HESealBackend& he_seal_backend) {
-  max_pool_seal(
-      arg, out, arg_shape, out_shape, window_shape, window_movement_strides,
-      padding_below, padding_above,
-      he_seal_backend.get_context()->first_parms_id(),
-      he_seal_backend.get_scale(), *he_seal_backend.get_ckks_encoder(),
-      *he_seal_backend.get_encryptor(), *he_seal_backend.get_decryptor());
+  max_pool_seal(arg, out,
+                max_pool_seal_index_plan(arg_shape, out_shape, window_shape,
+                                         window_movement_strides, padding_below,
+                                         padding_above),
+                he_seal_backend);
 }
 
 }  // namespace ngraph::he
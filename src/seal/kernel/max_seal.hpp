@@ -28,12 +28,17 @@
 
 namespace ngraph::he {
 
-inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
-                     const Shape& in_shape, const Shape& out_shape,
-                     const AxisSet& reduction_axes, size_t batch_size,
-                     const seal::parms_id_type& parms_id, double scale,
-                     seal::CKKSEncoder& ckks_encoder,
-                     seal::Encryptor& encryptor, seal::Decryptor& decryptor) {
+/// \brief Computes Max by decrypting and re-encrypting
+/// \param[in] seeded_context If not nullptr, the result is encrypted as
+/// seeded ciphertexts. See encrypt()
+inline void max_seal(
+    const std::vector<HEType>& arg, std::vector<HEType>& out,
+    const Shape& in_shape, const Shape& out_shape,
+    const AxisSet& reduction_axes, size_t batch_size,
+    const seal::parms_id_type& parms_id, double scale,
+    seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
+    seal::Decryptor& decryptor,
+    const std::shared_ptr<seal::SEALContext>& seeded_context = nullptr) {
   std::vector<HEPlaintext> out_plain(
       out.size(), HEPlaintext(std::vector<double>(
                       batch_size, -std::numeric_limits<double>::infinity())));
@@ -66,7 +71,7 @@ inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
     } else {
       encrypt(out[out_idx].get_ciphertext(), out_plain[out_idx], parms_id,
               ngraph::element::f32, scale, ckks_encoder, encryptor,
-              out[out_idx].complex_packing());
+              out[out_idx].complex_packing(), seeded_context);
     }
   }
 }
@@ -0,0 +1,205 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::he {
+
+namespace {
+/// \brief Returns whether or not multiplying by the plaintext yields zero
+bool is_zero_multiplicand(const HEPlaintext& plain) {
+  return std::all_of(plain.begin(), plain.end(),
+                     [](double f) { return std::abs(f) < 1e-5f; });
+}
+
+/// \brief Multiplies two ciphertexts without relinearizing the product
+void multiply_no_relin_seal(SealCiphertextWrapper& arg0,
+                            SealCiphertextWrapper& arg1, HEType& out,
+                            HESealBackend& he_seal_backend,
+                            const seal::MemoryPoolHandle& pool) {
+  match_modulus_and_scale_inplace(arg0, arg1, he_seal_backend, pool);
+  NGRAPH_CHECK(he_seal_backend.get_chain_index(arg0) > 0,
+               "Multiplicative depth limit reached");
+
+  if (!out.is_ciphertext()) {
+    out.set_ciphertext(HESealBackend::create_empty_ciphertext());
+  }
+  seal::Ciphertext& destination = out.get_ciphertext()->ciphertext();
+  if (&arg0 == &arg1) {
+    he_seal_backend.get_evaluator()->square(arg0.ciphertext(), destination,
+                                            pool);
+  } else {
+    he_seal_backend.get_evaluator()->multiply(
+        arg0.ciphertext(), arg1.ciphertext(), destination, pool);
+  }
+}
+
+/// \brief Multiplies a ciphertext with a non-zero plaintext. If sum is a
+/// ciphertext at the same level as arg0 with a similar scale, the plaintext is
+/// encoded such that the product has exactly the scale of sum. The cached
+/// encoding of arg1 is used instead if it matches the required level and scale
+void multiply_plain_to_scale_seal(SealCiphertextWrapper& arg0,
+                                  const HEPlaintext& arg1,
+                                  const SealEncodedPlaintext* arg1_encoded,
+                                  const HEType* sum, HEType& out,
+                                  HESealBackend& he_seal_backend,
+                                  const seal::MemoryPoolHandle& pool) {
+  double plain_scale = arg0.scale();
+  bool match_sum_scale = false;
+  if (sum != nullptr && sum->is_ciphertext() &&
+      he_seal_backend.get_chain_index(*sum->get_ciphertext()) ==
+          he_seal_backend.get_chain_index(arg0)) {
+    double target_scale = sum->get_ciphertext()->scale() / arg0.scale();
+    if (target_scale / plain_scale <= 1.05 &&
+        plain_scale / target_scale <= 1.05) {
+      plain_scale = target_scale;
+      match_sum_scale = true;
+    }
+  }
+
+  // The cached encoding may differ from the required scale by round-off only
+  bool use_encoded =
+      arg1_encoded != nullptr &&
+      arg1_encoded->parms_id() == arg0.ciphertext().parms_id() &&
+      std::abs(arg1_encoded->scale() / plain_scale - 1.0) < 1e-9;
+
+  if (!out.is_ciphertext()) {
+    out.set_ciphertext(HESealBackend::create_empty_ciphertext());
+  }
+  seal::Ciphertext& destination = out.get_ciphertext()->ciphertext();
+
+  if (arg1.size() == 1) {
+    destination = arg0.ciphertext();
+    if (use_encoded) {
+      multiply_plain_inplace(destination, arg1_encoded->scalar(),
+                             arg1_encoded->scale(), he_seal_backend, pool);
+    } else {
+      multiply_plain_inplace(destination, arg1[0], plain_scale,
+                             he_seal_backend, pool);
+    }
+    if (destination.is_transparent()) {
+      HEPlaintext zeros({std::vector<double>(arg1.size(), 0)});
+      out.set_plaintext(zeros);
+    }
+  } else {
+    NGRAPH_CHECK(he_seal_backend.get_chain_index(arg0) > 0,
+                 "Multiplicative depth exceeded for arg0");
+    if (use_encoded) {
+      he_seal_backend.get_evaluator()->multiply_plain(
+          arg0.ciphertext(), arg1_encoded->plaintext().plaintext(),
+          destination, pool);
+    } else {
+      auto p = SealPlaintextWrapper(seal::Plaintext(pool), false);
+      encode(p, arg1, *he_seal_backend.get_ckks_encoder(),
+             arg0.ciphertext().parms_id(), element::f32, plain_scale, false);
+      he_seal_backend.get_evaluator()->multiply_plain(
+          arg0.ciphertext(), p.plaintext(), destination, pool);
+    }
+  }
+  // Avoid floating-point round-off in the product of the scales
+  if (match_sum_scale && out.is_ciphertext()) {
+    destination.scale() = sum->get_ciphertext()->scale();
+  }
+}
+
+/// \brief Multiplies two elements, deferring relinearization
+/// \param[in] arg1_encoded Cached encoding of arg1, or nullptr
+/// \param[in] sum Running sum whose scale the product should match, or nullptr
+void lazy_multiply_seal(const HEType& arg0, const HEType& arg1,
+                        const SealEncodedPlaintext* arg1_encoded,
+                        const HEType* sum, HEType& out,
+                        HESealBackend& he_seal_backend,
+                        const seal::MemoryPoolHandle& pool) {
+  out.complex_packing() = arg0.complex_packing();
+  if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
+    multiply_no_relin_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(), out,
+                           he_seal_backend, pool);
+    return;
+  }
+  const HEType& cipher = arg0.is_ciphertext() ? arg0 : arg1;
+  const HEPlaintext& plain =
+      arg0.is_ciphertext() ? arg1.get_plaintext() : arg0.get_plaintext();
+  if (is_zero_multiplicand(plain)) {
+    HEPlaintext zeros({std::vector<double>(plain.size(), 0)});
+    out.set_plaintext(zeros);
+    return;
+  }
+  // The cached encoding is only valid if arg1 is the plaintext
+  const SealEncodedPlaintext* plain_encoded =
+      arg0.is_ciphertext() ? arg1_encoded : nullptr;
+  multiply_plain_to_scale_seal(*cipher.get_ciphertext(), plain, plain_encoded,
+                               sum, out, he_seal_backend, pool);
+}
+}  // namespace
+
+void scalar_multiply_accumulate_seal(const HEType& arg0, const HEType& arg1,
+                                     const SealEncodedPlaintext* arg1_encoded,
+                                     HEType& sum, HEType& prod,
+                                     bool& first_add,
+                                     HESealBackend& he_seal_backend,
+                                     const seal::MemoryPoolHandle& pool) {
+  bool lazy = (arg0.is_ciphertext() || arg1.is_ciphertext()) &&
+              !arg0.complex_packing() && !arg1.complex_packing() &&
+              !he_seal_backend.naive_rescaling();
+
+  // The first product is written straight into the sum, so no copy of the
+  // product is ever needed
+  if (first_add) {
+    if (lazy) {
+      lazy_multiply_seal(arg0, arg1, arg1_encoded, nullptr, sum,
+                         he_seal_backend, pool);
+    } else {
+      scalar_multiply_seal(arg0, arg1, sum, he_seal_backend, pool);
+    }
+    first_add = false;
+    return;
+  }
+
+  if (lazy) {
+    // Adding a zero product to an encrypted sum is a no-op
+    if (sum.is_ciphertext()) {
+      if ((arg0.is_plaintext() && is_zero_multiplicand(arg0.get_plaintext())) ||
+          (arg1.is_plaintext() && is_zero_multiplicand(arg1.get_plaintext()))) {
+        return;
+      }
+    }
+    lazy_multiply_seal(arg0, arg1, arg1_encoded, &sum, prod, he_seal_backend,
+                       pool);
+  } else {
+    scalar_multiply_seal(arg0, arg1, prod, he_seal_backend, pool);
+  }
+  scalar_add_seal(prod, sum, sum, he_seal_backend, pool);
+}
+
+void multiply_accumulate_finalize_seal(HEType& sum,
+                                       HESealBackend& he_seal_backend,
+                                       const seal::MemoryPoolHandle& pool) {
+  if (sum.is_ciphertext() && sum.get_ciphertext()->size() > 2) {
+    sum.get_ciphertext()->clear_seeded();
+    he_seal_backend.get_evaluator()->relinearize_inplace(
+        sum.get_ciphertext()->ciphertext(), *he_seal_backend.get_relin_keys(),
+        pool);
+  }
+}
+
+}  // namespace ngraph::he
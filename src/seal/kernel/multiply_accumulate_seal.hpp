@@ -0,0 +1,61 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_plaintext_cache.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::he {
+/// \brief Multiplies two ciphertext/plaintext elements and adds the product to
+/// a running sum, without copying either operand.
+///
+/// Unless complex packing or naive rescaling is used, the products are
+/// accumulated lazily: ciphertext-ciphertext products are not relinearized,
+/// and ciphertext-plaintext products are encoded such that they land on the
+/// scale of the running sum. The sum must be passed to
+/// multiply_accumulate_finalize_seal once all products have been accumulated.
+/// \param[in] arg0 Cipher or plaintext data to multiply. Ciphertexts may be
+/// mod-switched in-place to match the other operand
+/// \param[in] arg1 Cipher or plaintext data to multiply. Ciphertexts may be
+/// mod-switched in-place to match the other operand
+/// \param[in] arg1_encoded Cached encoding of arg1, or nullptr. Only used if
+/// arg0 is a ciphertext at the level and scale of the encoding
+/// \param[in,out] sum Running sum. Overwritten with the product on the first
+/// add
+/// \param[in,out] prod Scratch element storing the product. Should be reused
+/// across calls so its ciphertext buffer is only allocated once
+/// \param[in,out] first_add Whether sum has not been written yet. Set to false
+/// once the product has been accumulated
+/// \param[in] he_seal_backend Backend used to perform the multiply-accumulate
+/// \param[in] pool Memory pool used for temporary allocations
+void scalar_multiply_accumulate_seal(
+    const HEType& arg0, const HEType& arg1,
+    const SealEncodedPlaintext* arg1_encoded, HEType& sum, HEType& prod,
+    bool& first_add, HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
+/// \brief Relinearizes a sum of lazily accumulated products, if needed
+/// \param[in,out] sum Sum computed by scalar_multiply_accumulate_seal
+/// \param[in] he_seal_backend Backend whose relinearization keys are used
+/// \param[in] pool Memory pool used for temporary allocations
+void multiply_accumulate_finalize_seal(
+    HEType& sum, HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
+}  // namespace ngraph::he
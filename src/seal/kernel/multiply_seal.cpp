@@ -141,7 +141,7 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
     }
 
     // Never complex-pack for multiplication
-    auto p = SealPlaintextWrapper(false);
+    auto p = SealPlaintextWrapper(seal::Plaintext(pool), false);
     encode(p, arg1, *he_seal_backend.get_ckks_encoder(),
            arg0.ciphertext().parms_id(), element::f32,
            arg0.ciphertext().scale(), false);
@@ -25,6 +25,7 @@
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 /// \brief Multiplies two ciphertexts
@@ -77,8 +78,11 @@ void scalar_multiply_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
 /// \param[in] arg1 Cipher or plaintext data to multiply
 /// \param[in] out Stores the ciphertext or plaintext product
 /// \param[in] he_seal_backend Backend used to perform multiplication
-inline void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
-                                 HESealBackend& he_seal_backend) {
+/// \param[in] pool Memory pool used for new memory allocation
+inline void scalar_multiply_seal(
+    const HEType& arg0, const HEType& arg1, HEType& out,
+    HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -87,19 +91,19 @@ inline void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
     }
     scalar_multiply_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
                          out.get_ciphertext(), arg0.complex_packing(),
-                         he_seal_backend);
+                         he_seal_backend, pool);
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_multiply_seal(*arg0.get_ciphertext(), arg1.get_plaintext(), out,
-                         he_seal_backend);
+                         he_seal_backend, pool);
   } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_multiply_seal(*arg1.get_ciphertext(), arg0.get_plaintext(), out,
-                         he_seal_backend);
+                         he_seal_backend, pool);
   } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -132,10 +136,9 @@ inline void multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_multiply_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
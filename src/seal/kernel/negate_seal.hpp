@@ -22,6 +22,7 @@
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 void scalar_negate_seal(const SealCiphertextWrapper& arg,
@@ -59,10 +60,9 @@ inline void negate_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
   NGRAPH_CHECK(count <= out.size(), "Count ", count,
                " is too large for out, with size ", out.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_negate_seal(arg[i], out[i], element_type, he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
@@ -26,16 +26,10 @@
 
 namespace ngraph::he {
 
-void pad_seal(std::vector<HEType>& arg0,
-              std::vector<HEType>& arg1,  // scalar
-              std::vector<HEType>& out, const Shape& arg0_shape,
-              const Shape& out_shape, const CoordinateDiff& padding_below,
-              const CoordinateDiff& padding_above, op::PadMode pad_mode) {
-  if (arg1.size() != 1) {
-    throw ngraph_error("Padding element must be scalar");
-  }
-  auto& pad_val = arg1[0];
-
+IndexPlan pad_seal_index_plan(const Shape& arg0_shape, const Shape& out_shape,
+                              const CoordinateDiff& padding_below,
+                              const CoordinateDiff& padding_above,
+                              op::PadMode pad_mode) {
   // start at (0,0,...,0)
   Coordinate input_start(arg0_shape.size(), 0);
   // end at (d'0,d'1,...,d'n), the outer corner of the post-padding shape
@@ -51,24 +45,18 @@ void pad_seal(std::vector<HEType>& arg0,
   CoordinateTransform input_transform(arg0_shape, input_start, input_end,
                                       input_strides, input_axis_order,
                                       padding_below, padding_above);
-  CoordinateTransform output_transform(out_shape);
-
-  CoordinateTransform::Iterator output_it = output_transform.begin();
 
   NGRAPH_CHECK(shape_size(input_transform.get_target_shape()) ==
-               shape_size(output_transform.get_target_shape()));
+               shape_size(out_shape));
 
+  IndexPlan plan({arg0_shape}, out_shape);
   for (const Coordinate& in_coord : input_transform) {
-    const Coordinate& out_coord = *output_it;
-
-    HEType v(HEPlaintext(), false);
-
     switch (pad_mode) {
       case op::PadMode::CONSTANT:
         // If the coordinate is out of bounds, substitute pad_val.
-        v = input_transform.has_source_coordinate(in_coord)
-                ? arg0[input_transform.index(in_coord)]
-                : pad_val;
+        plan.add_entry(input_transform.has_source_coordinate(in_coord)
+                           ? input_transform.index(in_coord)
+                           : IndexPlan::padding_index);
         break;
       case op::PadMode::EDGE: {
         Coordinate c = in_coord;  // have to copy because in_coord is const
@@ -85,7 +73,7 @@ void pad_seal(std::vector<HEType>& arg0,
                 padding_below[i] + static_cast<ptrdiff_t>(arg0_shape[i]) - 1);
           }
         }
-        v = arg0[input_transform.index(c)];
+        plan.add_entry(input_transform.index(c));
         break;
       }
       case op::PadMode::REFLECT: {
@@ -142,7 +130,7 @@ void pad_seal(std::vector<HEType>& arg0,
 
           c[i] = static_cast<size_t>(new_dim);
         }
-        v = arg0[input_transform.index(c)];
+        plan.add_entry(input_transform.index(c));
         break;
       }
       case op::PadMode::SYMMETRIC: {
@@ -150,10 +138,36 @@ void pad_seal(std::vector<HEType>& arg0,
         throw ngraph_error("Symmetric mode padding not supported");
       }
     }
+    plan.end_output();
+  }
+  return plan;
+}
 
-    out[output_transform.index(out_coord)] = v;
+void pad_seal(std::vector<HEType>& arg0,
+              std::vector<HEType>& arg1,  // scalar
+              std::vector<HEType>& out, const IndexPlan& plan) {
+  if (arg1.size() != 1) {
+    throw ngraph_error("Padding element must be scalar");
+  }
+  const HEType& pad_val = arg1[0];
+
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    uint32_t arg0_index = plan.gather_index(out_idx);
+    out[out_idx] =
+        arg0_index == IndexPlan::padding_index ? pad_val : arg0[arg0_index];
+  }
+}
 
-    ++output_it;
+void pad_seal(std::vector<HEType>& arg0,
+              std::vector<HEType>& arg1,  // scalar
+              std::vector<HEType>& out, const Shape& arg0_shape,
+              const Shape& out_shape, const CoordinateDiff& padding_below,
+              const CoordinateDiff& padding_above, op::PadMode pad_mode) {
+  if (arg1.size() != 1) {
+    throw ngraph_error("Padding element must be scalar");
   }
+  pad_seal(arg0, arg1, out,
+           pad_seal_index_plan(arg0_shape, out_shape, padding_below,
+                               padding_above, pad_mode));
 }
 }  // namespace ngraph::he
@@ -19,12 +19,22 @@
 #include <memory>
 #include <vector>
 
+#include "index_plan.hpp"
 #include "ngraph/axis_vector.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "ngraph/op/pad.hpp"
 #include "seal/he_seal_backend.hpp"
 
 namespace ngraph::he {
+IndexPlan pad_seal_index_plan(const Shape& arg0_shape, const Shape& out_shape,
+                              const CoordinateDiff& padding_below,
+                              const CoordinateDiff& padding_above,
+                              op::PadMode pad_mode);
+
+void pad_seal(std::vector<HEType>& arg0,
+              std::vector<HEType>& arg1,  // scalar
+              std::vector<HEType>& out, const IndexPlan& plan);
+
 void pad_seal(std::vector<HEType>& arg0,
               std::vector<HEType>& arg1,  // scalar
               std::vector<HEType>& out, const Shape& arg0_shape,
@@ -23,6 +23,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
@@ -32,10 +33,11 @@ void scalar_relu_seal(const HEPlaintext& arg, HEPlaintext& out) {
   std::transform(arg.begin(), arg.end(), out.begin(), relu);
 }
 
-void scalar_relu_seal(const HEType& arg, HEType& out,
-                      const seal::parms_id_type& parms_id, double scale,
-                      seal::CKKSEncoder& ckks_encoder,
-                      seal::Encryptor& encryptor, seal::Decryptor& decryptor) {
+void scalar_relu_seal(
+    const HEType& arg, HEType& out, const seal::parms_id_type& parms_id,
+    double scale, seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
+    seal::Decryptor& decryptor,
+    const std::shared_ptr<seal::SEALContext>& seeded_context) {
   if (arg.is_plaintext()) {
     out.set_plaintext(arg.get_plaintext());
     scalar_relu_seal(arg.get_plaintext(), out.get_plaintext());
@@ -45,7 +47,7 @@ void scalar_relu_seal(const HEType& arg, HEType& out,
             ckks_encoder);
     scalar_relu_seal(plain, plain);
     encrypt(out.get_ciphertext(), plain, parms_id, ngraph::element::f32, scale,
-            ckks_encoder, encryptor, arg.complex_packing());
+            ckks_encoder, encryptor, arg.complex_packing(), seeded_context);
     out.set_ciphertext(out.get_ciphertext());
   }
 }
@@ -60,10 +62,9 @@ void scalar_relu_seal(const HEType& arg, HEType& out,
 
 void relu_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                size_t count, const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_relu_seal(arg[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
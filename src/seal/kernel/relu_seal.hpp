@@ -28,10 +28,14 @@
 namespace ngraph::he {
 void scalar_relu_seal(const HEPlaintext& arg, HEPlaintext& out);
 
-void scalar_relu_seal(const HEType& arg, HEType& out,
-                      const seal::parms_id_type& parms_id, double scale,
-                      seal::CKKSEncoder& ckks_encoder,
-                      seal::Encryptor& encryptor, seal::Decryptor& decryptor);
+/// \brief Computes ReLU by decrypting and re-encrypting
+/// \param[in] seeded_context If not nullptr, the result is encrypted as a
+/// seeded ciphertext. See encrypt()
+void scalar_relu_seal(
+    const HEType& arg, HEType& out, const seal::parms_id_type& parms_id,
+    double scale, seal::CKKSEncoder& ckks_encoder, seal::Encryptor& encryptor,
+    seal::Decryptor& decryptor,
+    const std::shared_ptr<seal::SEALContext>& seeded_context = nullptr);
 
 void scalar_relu_seal(const HEType& arg, HEType& out,
                       const HESealBackend& he_seal_backend);
@@ -19,6 +19,8 @@
 #include <memory>
 #include <vector>
 
+#include "task_runtime.hpp"
+
 namespace ngraph::he {
 
 void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
@@ -68,14 +70,13 @@ void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
     NGRAPH_HE_LOG(3) << "New chain index " << new_chain_index;
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < arg.size(); ++i) {  // NOLINT
-    auto cipher = arg[i];
+  parallel_for(0, arg.size(), [&](size_t i) {
     if (arg[i].is_ciphertext()) {
+      arg[i].get_ciphertext()->clear_seeded();
       he_seal_backend.get_evaluator()->rescale_to_next_inplace(
           arg[i].get_ciphertext()->ciphertext());
     }
-  }
+  });
   if (verbose) {
     auto t2 = Clock::now();
     NGRAPH_HE_LOG(3) << "Rescale_xxx took "
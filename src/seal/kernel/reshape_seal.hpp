@@ -19,14 +19,20 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/axis_vector.hpp"
 #include "ngraph/coordinate_transform.hpp"
+#include "seal/kernel/gather_seal.hpp"
 
 namespace ngraph::he {
-inline void reshape_seal(const std::vector<HEType>& arg,
-                         std::vector<HEType>& out, const Shape& in_shape,
-                         const AxisVector& in_axis_order,
-                         const Shape& out_shape) {
+inline IndexPlan reshape_seal_index_plan(const Shape& in_shape,
+                                         const AxisVector& in_axis_order,
+                                         const Shape& out_shape) {
+  IndexPlan plan({in_shape}, out_shape);
+  if (shape_size(out_shape) == 0) {
+    return plan;
+  }
+
   // Unfortunately we don't yet have a constructor for CoordinateTransform that
   // lets us pass only source_space_shape and source_axis_order so we have to
   // construct the defaults here.
@@ -36,19 +42,24 @@ inline void reshape_seal(const std::vector<HEType>& arg,
   CoordinateTransform input_transform(in_shape, in_start_corner, in_shape,
                                       in_strides, in_axis_order);
 
-  CoordinateTransform output_transform(out_shape);
-  CoordinateTransform::Iterator output_it = output_transform.begin();
-
-  if (output_it == output_transform.end()) {
-    return;
-  }
-
   for (const Coordinate& input_coord : input_transform) {
-    const Coordinate& output_coord = *output_it;
-    out[output_transform.index(output_coord)] =
-        arg[input_transform.index(input_coord)];
-    ++output_it;
+    plan.add_entry(input_transform.index(input_coord));
+    plan.end_output();
   }
+  return plan;
+}
+
+inline void reshape_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, const IndexPlan& plan) {
+  gather_seal(arg, out, plan);
+}
+
+inline void reshape_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, const Shape& in_shape,
+                         const AxisVector& in_axis_order,
+                         const Shape& out_shape) {
+  reshape_seal(arg, out,
+               reshape_seal_index_plan(in_shape, in_axis_order, out_shape));
 }
 
 }  // namespace ngraph::he
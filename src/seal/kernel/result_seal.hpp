@@ -24,6 +24,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 
@@ -55,10 +56,9 @@ inline void result_seal(const std::vector<HEType>& arg,
   NGRAPH_CHECK(out.size() >= count, "Result out size ", out.size(),
                " smaller than count ", count);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_result_seal(arg[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
@@ -19,17 +19,20 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
+#include "seal/kernel/gather_seal.hpp"
 
 namespace ngraph::he {
-inline void reverse_seal(const std::vector<HEType>& arg,
-                         std::vector<HEType>& out, const Shape& arg_shape,
-                         const Shape& out_shape, const AxisSet& reversed_axes) {
+inline IndexPlan reverse_seal_index_plan(const Shape& arg_shape,
+                                         const Shape& out_shape,
+                                         const AxisSet& reversed_axes) {
   // In fact arg_shape == out_shape, but we'll use both for stylistic
   // consistency with other kernels.
   CoordinateTransform arg_transform(arg_shape);
   CoordinateTransform output_transform(out_shape);
 
+  IndexPlan plan({arg_shape}, out_shape);
   for (const Coordinate& out_coord : output_transform) {
     Coordinate arg_coord = out_coord;
 
@@ -39,9 +42,22 @@ inline void reverse_seal(const std::vector<HEType>& arg,
       }
     }
 
-    out[output_transform.index(out_coord)] =
-        arg[arg_transform.index(arg_coord)];
+    plan.add_entry(arg_transform.index(arg_coord));
+    plan.end_output();
   }
+  return plan;
+}
+
+inline void reverse_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, const IndexPlan& plan) {
+  gather_seal(arg, out, plan);
+}
+
+inline void reverse_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, const Shape& arg_shape,
+                         const Shape& out_shape, const AxisSet& reversed_axes) {
+  reverse_seal(arg, out,
+               reverse_seal_index_plan(arg_shape, out_shape, reversed_axes));
 }
 
 }  // namespace ngraph::he
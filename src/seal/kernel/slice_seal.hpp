@@ -19,31 +19,43 @@
 #include <vector>
 
 #include "he_type.hpp"
+#include "index_plan.hpp"
 #include "ngraph/coordinate_transform.hpp"
+#include "seal/kernel/gather_seal.hpp"
 
 namespace ngraph::he {
-inline void slice_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
-                       const Shape& arg_shape, const Coordinate& lower_bounds,
-                       const Coordinate& upper_bounds, const Strides& strides,
-                       const Shape& out_shape) {
+inline IndexPlan slice_seal_index_plan(const Shape& arg_shape,
+                                       const Coordinate& lower_bounds,
+                                       const Coordinate& upper_bounds,
+                                       const Strides& strides,
+                                       const Shape& out_shape) {
   CoordinateTransform input_transform(arg_shape, lower_bounds, upper_bounds,
                                       strides);
-  CoordinateTransform output_transform(out_shape);
-
-  CoordinateTransform::Iterator output_it = output_transform.begin();
 
   NGRAPH_CHECK(shape_size(input_transform.get_target_shape()) ==
-                   shape_size(output_transform.get_target_shape()),
+                   shape_size(out_shape),
                "Slice transform shape sizes don't match");
 
+  IndexPlan plan({arg_shape}, out_shape);
   for (const Coordinate& in_coord : input_transform) {
-    const Coordinate& out_coord = *output_it;
+    plan.add_entry(input_transform.index(in_coord));
+    plan.end_output();
+  }
+  return plan;
+}
 
-    out[output_transform.index(out_coord)] =
-        arg[input_transform.index(in_coord)];
+inline void slice_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                       const IndexPlan& plan) {
+  gather_seal(arg, out, plan);
+}
 
-    ++output_it;
-  }
+inline void slice_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                       const Shape& arg_shape, const Coordinate& lower_bounds,
+                       const Coordinate& upper_bounds, const Strides& strides,
+                       const Shape& out_shape) {
+  slice_seal(arg, out,
+             slice_seal_index_plan(arg_shape, lower_bounds, upper_bounds,
+                                   strides, out_shape));
 }
 
 }  // namespace ngraph::he
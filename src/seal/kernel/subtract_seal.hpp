@@ -25,6 +25,7 @@
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 /// \brief Subtracts two ciphertexts
@@ -117,10 +118,9 @@ inline void subtract_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for(0, count, [&](size_t i) {
     scalar_subtract_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::he
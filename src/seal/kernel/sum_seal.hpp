@@ -16,11 +16,16 @@
 
 #pragma once
 
+#include <vector>
+
 #include "he_type.hpp"
 #include "ngraph/coordinate_transform.hpp"
+#include "ngraph/shape_util.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/add_seal.hpp"
+#include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 inline void sum_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
@@ -35,22 +40,35 @@ inline void sum_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
   bool complex_packing = arg.size() > 0 ? arg[0].complex_packing() : false;
   size_t batch_size = arg.size() > 0 ? arg[0].batch_size() : 1;
 
-  for (const Coordinate& output_coord : output_transform) {
-    // TODO(fboemer): batch size
-    const auto out_coord_idx = output_transform.index(output_coord);
-    out[out_coord_idx] = HEType(HEPlaintext(std::vector<double>(batch_size, 0)),
-                                complex_packing);
-  }
-
+  // Gather the input indices reduced into each output
+  std::vector<std::vector<size_t>> summand_indices(shape_size(out_shape));
   CoordinateTransform input_transform(in_shape);
-
   for (const Coordinate& input_coord : input_transform) {
     Coordinate output_coord = reduce(input_coord, reduction_axes);
-
-    auto& input = arg[input_transform.index(input_coord)];
-    auto& output = out[output_transform.index(output_coord)];
-    scalar_add_seal(input, output, output, he_seal_backend);
+    summand_indices[output_transform.index(output_coord)].emplace_back(
+        input_transform.index(input_coord));
   }
+
+  // Many inputs share an output, so bring all inputs to the same level
+  // up-front rather than mod-switching them from multiple threads
+  match_to_smallest_chain_index(arg, he_seal_backend);
+
+  parallel_for(0, summand_indices.size(), [&](size_t out_idx) {
+    seal::MemoryPoolHandle pool = seal::MemoryPoolHandle::ThreadLocal();
+    const std::vector<size_t>& indices = summand_indices[out_idx];
+    if (indices.empty()) {
+      // TODO(fboemer): batch size
+      out[out_idx] = HEType(HEPlaintext(std::vector<double>(batch_size, 0)),
+                            complex_packing);
+      return;
+    }
+    std::vector<const HEType*> summands;
+    summands.reserve(indices.size());
+    for (const size_t index : indices) {
+      summands.emplace_back(&arg[index]);
+    }
+    add_tree_seal(summands, out[out_idx], he_seal_backend, pool);
+  });
 }
 
 }  // namespace ngraph::he
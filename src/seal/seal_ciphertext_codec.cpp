@@ -0,0 +1,323 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_ciphertext_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+#include "ngraph/util.hpp"
+#include "util.hpp"
+
+namespace {
+/// \brief Appends values to a string as a little-endian bit stream
+class BitWriter {
+ public:
+  explicit BitWriter(std::string& dst) : m_dst(dst) {}
+
+  /// \brief Appends the low bit_count bits of value
+  void write(uint64_t value, size_t bit_count) {
+    // Write at most 32 bits at a time, so the accumulator never overflows
+    while (bit_count > 0) {
+      size_t piece_bits = std::min<size_t>(bit_count, 32);
+      uint64_t mask = (uint64_t{1} << piece_bits) - 1;
+      m_acc |= (value & mask) << m_acc_bits;
+      m_acc_bits += piece_bits;
+      value >>= piece_bits;
+      bit_count -= piece_bits;
+      while (m_acc_bits >= 8) {
+        m_dst.push_back(static_cast<char>(m_acc & 0xff));
+        m_acc >>= 8;
+        m_acc_bits -= 8;
+      }
+    }
+  }
+
+  /// \brief Pads the stream with zero bits to a byte boundary
+  void flush() {
+    if (m_acc_bits > 0) {
+      m_dst.push_back(static_cast<char>(m_acc & 0xff));
+    }
+    m_acc = 0;
+    m_acc_bits = 0;
+  }
+
+ private:
+  std::string& m_dst;
+  uint64_t m_acc{0};
+  size_t m_acc_bits{0};
+};
+
+/// \brief Reads values from a little-endian bit stream written by BitWriter
+class BitReader {
+ public:
+  BitReader(const std::string& src, size_t offset)
+      : m_src(src), m_offset(offset) {}
+
+  /// \brief Reads bit_count bits
+  uint64_t read(size_t bit_count) {
+    uint64_t value = 0;
+    size_t value_bits = 0;
+    while (value_bits < bit_count) {
+      size_t piece_bits = std::min<size_t>(bit_count - value_bits, 32);
+      while (m_acc_bits < piece_bits) {
+        NGRAPH_CHECK(m_offset < m_src.size(), "Bit-packed ciphertext is short");
+        m_acc |= static_cast<uint64_t>(static_cast<unsigned char>(
+                     m_src[m_offset++]))
+                 << m_acc_bits;
+        m_acc_bits += 8;
+      }
+      uint64_t mask = (uint64_t{1} << piece_bits) - 1;
+      value |= (m_acc & mask) << value_bits;
+      m_acc >>= piece_bits;
+      m_acc_bits -= piece_bits;
+      value_bits += piece_bits;
+    }
+    return value;
+  }
+
+  /// \brief Skips the padding bits up to the next byte boundary
+  void align() {
+    m_acc = 0;
+    m_acc_bits = 0;
+  }
+
+  size_t offset() const { return m_offset; }
+
+ private:
+  const std::string& m_src;
+  size_t m_offset;
+  uint64_t m_acc{0};
+  size_t m_acc_bits{0};
+};
+
+size_t significant_bit_count(uint64_t value) {
+  size_t bit_count = 0;
+  while (value != 0) {
+    ++bit_count;
+    value >>= 1;
+  }
+  return bit_count;
+}
+
+/// \brief Serializes a ciphertext with each RNS limb packed into the bit width
+/// of its largest coefficient. Since coefficients are reduced modulo the limb
+/// modulus, this is at most the bit width of the modulus.
+///
+/// Layout, with integers little-endian: parms_id (4 x uint64), size, coeff
+/// mod count, poly modulus degree, scale (each uint64), is_ntt_form (uint8),
+/// the bit width of each limb (uint8 each), then the coefficients of each
+/// limb of each polynomial, with each limb starting at a byte boundary
+void save_bit_packed(const seal::Ciphertext& cipher, std::string& dst) {
+  size_t size = cipher.size();
+  size_t coeff_mod_count = cipher.coeff_mod_count();
+  size_t coeff_count = cipher.poly_modulus_degree();
+
+  std::vector<size_t> limb_bits(coeff_mod_count, 0);
+  for (size_t poly_idx = 0; poly_idx < size; ++poly_idx) {
+    const uint64_t* poly = cipher.data(poly_idx);
+    for (size_t limb_idx = 0; limb_idx < coeff_mod_count; ++limb_idx) {
+      const uint64_t* limb = poly + limb_idx * coeff_count;
+      uint64_t limb_max = *std::max_element(limb, limb + coeff_count);
+      limb_bits[limb_idx] =
+          std::max(limb_bits[limb_idx], significant_bit_count(limb_max));
+    }
+  }
+
+  size_t data_bytes = 0;
+  for (size_t bits : limb_bits) {
+    data_bytes += size * ((coeff_count * bits + 7) / 8);
+  }
+  dst.clear();
+  dst.reserve(8 * 8 + 1 + coeff_mod_count + data_bytes);
+
+  BitWriter writer(dst);
+  for (uint64_t parms_id_elem : cipher.parms_id()) {
+    writer.write(parms_id_elem, 64);
+  }
+  writer.write(size, 64);
+  writer.write(coeff_mod_count, 64);
+  writer.write(coeff_count, 64);
+  double scale = cipher.scale();
+  uint64_t scale_bits;
+  std::memcpy(&scale_bits, &scale, sizeof(scale_bits));
+  writer.write(scale_bits, 64);
+  writer.write(cipher.is_ntt_form() ? 1 : 0, 8);
+  for (size_t bits : limb_bits) {
+    writer.write(bits, 8);
+  }
+
+  for (size_t poly_idx = 0; poly_idx < size; ++poly_idx) {
+    const uint64_t* poly = cipher.data(poly_idx);
+    for (size_t limb_idx = 0; limb_idx < coeff_mod_count; ++limb_idx) {
+      const uint64_t* limb = poly + limb_idx * coeff_count;
+      for (size_t coeff_idx = 0; coeff_idx < coeff_count; ++coeff_idx) {
+        writer.write(limb[coeff_idx], limb_bits[limb_idx]);
+      }
+      writer.flush();
+    }
+  }
+}
+
+void load_bit_packed(seal::Ciphertext& cipher, const std::string& src,
+                     const std::shared_ptr<seal::SEALContext>& context) {
+  BitReader reader(src, 0);
+  seal::parms_id_type parms_id;
+  for (auto& parms_id_elem : parms_id) {
+    parms_id_elem = reader.read(64);
+  }
+  NGRAPH_CHECK(context->get_context_data(parms_id) != nullptr,
+               "Bit-packed ciphertext parms_id is not valid for context");
+  size_t size = reader.read(64);
+  size_t coeff_mod_count = reader.read(64);
+  size_t coeff_count = reader.read(64);
+  uint64_t scale_bits = reader.read(64);
+  bool is_ntt_form = reader.read(8) != 0;
+  std::vector<size_t> limb_bits(coeff_mod_count);
+  for (auto& bits : limb_bits) {
+    bits = reader.read(8);
+    NGRAPH_CHECK(bits <= 64, "Invalid bit-packed limb width ", bits);
+  }
+
+  const auto& parms = context->get_context_data(parms_id)->parms();
+  NGRAPH_CHECK(coeff_mod_count == parms.coeff_modulus().size() &&
+                   coeff_count == parms.poly_modulus_degree(),
+               "Bit-packed ciphertext shape does not match context");
+  NGRAPH_CHECK(size >= 2 && size <= SEAL_CIPHERTEXT_SIZE_MAX,
+               "Invalid bit-packed ciphertext size ", size);
+
+  cipher.resize(context, parms_id, size);
+  cipher.is_ntt_form() = is_ntt_form;
+  std::memcpy(&cipher.scale(), &scale_bits, sizeof(scale_bits));
+  for (size_t poly_idx = 0; poly_idx < size; ++poly_idx) {
+    uint64_t* poly = cipher.data(poly_idx);
+    for (size_t limb_idx = 0; limb_idx < coeff_mod_count; ++limb_idx) {
+      uint64_t* limb = poly + limb_idx * coeff_count;
+      for (size_t coeff_idx = 0; coeff_idx < coeff_count; ++coeff_idx) {
+        limb[coeff_idx] = reader.read(limb_bits[limb_idx]);
+      }
+      reader.align();
+    }
+  }
+  NGRAPH_CHECK(reader.offset() == src.size(),
+               "Bit-packed ciphertext has trailing data");
+}
+}  // namespace
+
+namespace ngraph::he {
+std::vector<CiphertextCodec> supported_ciphertext_codecs() {
+  std::vector<CiphertextCodec> codecs{pb::HEType::NONE};
+#ifdef SEAL_USE_ZLIB
+  codecs.emplace_back(pb::HEType::DEFLATE);
+#endif
+  codecs.emplace_back(pb::HEType::BIT_PACKED);
+  return codecs;
+}
+
+bool is_supported(CiphertextCodec codec) {
+  auto codecs = supported_ciphertext_codecs();
+  return std::find(codecs.begin(), codecs.end(), codec) != codecs.end();
+}
+
+CiphertextCodec ciphertext_codec_from_string(const std::string& name) {
+  std::string lower_name = ngraph::to_lower(name);
+  CiphertextCodec codec;
+  if (lower_name == "none") {
+    codec = pb::HEType::NONE;
+  } else if (lower_name == "deflate") {
+    codec = pb::HEType::DEFLATE;
+  } else if (lower_name == "bit_packed") {
+    codec = pb::HEType::BIT_PACKED;
+  } else {
+    throw ngraph_error("Unknown ciphertext codec " + name);
+  }
+  if (!is_supported(codec)) {
+    throw ngraph_error("Ciphertext codec " + name + " is not supported");
+  }
+  return codec;
+}
+
+CiphertextCodec default_ciphertext_codec() {
+  std::string name = env_string("CIPHERTEXT_CODEC");
+  if (name.empty()) {
+    return pb::HEType::NONE;
+  }
+  return ciphertext_codec_from_string(name);
+}
+
+CiphertextCodec negotiate_ciphertext_codec(
+    CiphertextCodec codec,
+    const google::protobuf::RepeatedField<int>& peer_codecs) {
+  if (std::find(peer_codecs.begin(), peer_codecs.end(), codec) ==
+      peer_codecs.end()) {
+    return pb::HEType::NONE;
+  }
+  return codec;
+}
+
+void add_supported_ciphertext_codecs(pb::TCPMessage& message) {
+  for (CiphertextCodec codec : supported_ciphertext_codecs()) {
+    message.add_ciphertext_codecs(codec);
+  }
+}
+
+void save_ciphertext(const seal::Ciphertext& cipher, CiphertextCodec codec,
+                     std::string& dst) {
+  if (codec == pb::HEType::BIT_PACKED) {
+    save_bit_packed(cipher, dst);
+    return;
+  }
+#ifdef SEAL_USE_ZLIB
+  if (codec == pb::HEType::DEFLATE) {
+    // save_size bounds the compressed size
+    dst.resize(cipher.save_size(seal::compr_mode_type::deflate));
+    auto save_size =
+        cipher.save(reinterpret_cast<std::byte*>(dst.data()), dst.size(),
+                    seal::compr_mode_type::deflate);
+    dst.resize(static_cast<size_t>(save_size));
+    return;
+  }
+#endif
+  NGRAPH_CHECK(codec == pb::HEType::NONE, "Unsupported ciphertext codec ",
+               codec);
+  dst.resize(cipher.save_size(seal::compr_mode_type::none));
+  auto save_size =
+      cipher.save(reinterpret_cast<std::byte*>(dst.data()), dst.size(),
+                  seal::compr_mode_type::none);
+  NGRAPH_CHECK(static_cast<size_t>(save_size) == dst.size(),
+               "Save size != cipher size");
+}
+
+void load_ciphertext(seal::Ciphertext& cipher, CiphertextCodec codec,
+                     const std::string& src,
+                     std::shared_ptr<seal::SEALContext> context) {
+  if (codec == pb::HEType::BIT_PACKED) {
+    load_bit_packed(cipher, src, context);
+    NGRAPH_CHECK(seal::is_valid_for(cipher, context),
+                 "Bit-packed ciphertext is not valid for context");
+    return;
+  }
+  // SEAL serializations record their compression mode
+  NGRAPH_CHECK(is_supported(codec), "Unsupported ciphertext codec ", codec);
+  cipher.load(std::move(context),
+              reinterpret_cast<const std::byte*>(src.data()), src.size());
+}
+
+}  // namespace ngraph::he
@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "protos/message.pb.h"
+#include "seal/seal.h"
+
+namespace ngraph::he {
+/// \brief Serialization format of a ciphertext
+using CiphertextCodec = pb::HEType::Codec;
+
+/// \brief Returns the ciphertext codecs this build can encode and decode.
+/// DEFLATE is only supported if SEAL was built with zlib
+std::vector<CiphertextCodec> supported_ciphertext_codecs();
+
+/// \brief Returns whether or not a codec is supported
+/// \param[in] codec Ciphertext codec
+bool is_supported(CiphertextCodec codec);
+
+/// \brief Returns the codec with the given name
+/// \param[in] name One of "none", "deflate" or "bit_packed", ignoring case
+/// \throws ngraph_error if the name is unknown or the codec is unsupported
+CiphertextCodec ciphertext_codec_from_string(const std::string& name);
+
+/// \brief Returns the codec specified by the CIPHERTEXT_CODEC environment
+/// variable, or NONE if not set
+CiphertextCodec default_ciphertext_codec();
+
+/// \brief Returns the codec to send ciphertexts to a peer with
+/// \param[in] codec Preferred codec
+/// \param[in] peer_codecs Codecs the peer can decode
+/// \returns codec if the peer can decode it, NONE otherwise
+CiphertextCodec negotiate_ciphertext_codec(
+    CiphertextCodec codec,
+    const google::protobuf::RepeatedField<int>& peer_codecs);
+
+/// \brief Advertises the supported codecs in a message
+/// \param[out] message Message to add the supported codecs to
+void add_supported_ciphertext_codecs(pb::TCPMessage& message);
+
+/// \brief Serializes a ciphertext
+/// \param[in] cipher Ciphertext to serialize
+/// \param[in] codec Codec to serialize with
+/// \param[out] dst Serialized ciphertext
+void save_ciphertext(const seal::Ciphertext& cipher, CiphertextCodec codec,
+                     std::string& dst);
+
+/// \brief Loads a serialized ciphertext
+/// \param[out] cipher De-serialized ciphertext
+/// \param[in] codec Codec the ciphertext was serialized with
+/// \param[in] src Serialized ciphertext
+/// \param[in] context SEAL context to validate the ciphertext against
+/// \throws ngraph_error if the ciphertext is not valid for the context
+void load_ciphertext(seal::Ciphertext& cipher, CiphertextCodec codec,
+                     const std::string& src,
+                     std::shared_ptr<seal::SEALContext> context);
+
+}  // namespace ngraph::he
@@ -0,0 +1,158 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_ciphertext_pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "util.hpp"
+
+namespace {
+size_t capacity_bytes(const ngraph::he::SealCiphertextWrapper& cipher) {
+  return cipher.ciphertext().uint64_count_capacity() * sizeof(std::uint64_t);
+}
+}  // namespace
+
+namespace ngraph::he {
+
+size_t SealCiphertextPool::default_max_bytes() {
+  std::string max_mb = env_string("CIPHERTEXT_POOL_MB");
+  if (max_mb.empty()) {
+    return size_t{1} << 30;
+  }
+  return std::stoul(max_mb) << 20;
+}
+
+size_t SealCiphertextPool::acquire(std::vector<HEType>& he_types,
+                                   seal::parms_id_type parms_id, size_t size,
+                                   const seal::SEALContext& context) {
+  auto context_data = context.get_context_data(parms_id);
+  if (context_data == nullptr) {
+    return 0;
+  }
+  const auto& parms = context_data->parms();
+  size_t needed_bytes = size * parms.poly_modulus_degree() *
+                        parms.coeff_modulus().size() * sizeof(std::uint64_t);
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_count == 0) {
+    return 0;
+  }
+  // Prefer the exact size class, then ciphertexts of any other class with
+  // enough capacity. Each source is a class, with the number of usable
+  // ciphertexts at the back of the class
+  SizeClass exact_class = std::make_pair(parms_id, size);
+  std::vector<std::pair<Ciphertexts*, size_t>> sources;
+  auto exact_it = m_ciphertexts.find(exact_class);
+  if (exact_it != m_ciphertexts.end()) {
+    sources.emplace_back(&exact_it->second, exact_it->second.size());
+  }
+  for (auto& [size_class, ciphers] : m_ciphertexts) {
+    if (size_class == exact_class) {
+      continue;
+    }
+    // Capacities differ within a class, e.g. once relinearized ciphertexts
+    // are pooled, so move every ciphertext with enough capacity to the back
+    auto fitting_it = std::partition(
+        ciphers.begin(), ciphers.end(),
+        [&](const std::shared_ptr<SealCiphertextWrapper>& cipher) {
+          return capacity_bytes(*cipher) < needed_bytes;
+        });
+    auto fitting_count = static_cast<size_t>(ciphers.end() - fitting_it);
+    if (fitting_count > 0) {
+      sources.emplace_back(&ciphers, fitting_count);
+    }
+  }
+
+  size_t acquired = 0;
+  auto source_it = sources.begin();
+  for (auto& he_type : he_types) {
+    if (!he_type.is_ciphertext()) {
+      continue;
+    }
+    while (source_it != sources.end() && source_it->second == 0) {
+      ++source_it;
+    }
+    if (source_it == sources.end()) {
+      break;
+    }
+    auto& ciphers = *source_it->first;
+    m_byte_count -= capacity_bytes(*ciphers.back());
+    he_type.set_ciphertext(ciphers.back());
+    ciphers.pop_back();
+    --source_it->second;
+    ++acquired;
+  }
+  m_count -= acquired;
+  return acquired;
+}
+
+size_t SealCiphertextPool::release(std::vector<HEType>& he_types) {
+  if (m_max_bytes == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  size_t released = 0;
+  for (auto& he_type : he_types) {
+    if (!he_type.is_ciphertext()) {
+      continue;
+    }
+    auto& cipher = he_type.get_ciphertext();
+    // Shared ciphertexts are still in use elsewhere
+    if (cipher == nullptr || cipher.use_count() != 1) {
+      continue;
+    }
+    // Ciphertexts in a tensor's slab would keep the entire slab alive
+    if (cipher->ciphertext().pool() != seal::MemoryManager::GetPool()) {
+      continue;
+    }
+    size_t cipher_bytes = capacity_bytes(*cipher);
+    if (cipher_bytes == 0 || m_byte_count + cipher_bytes > m_max_bytes) {
+      continue;
+    }
+    // Seeded serializations are stale once the ciphertext is overwritten
+    cipher->clear_seeded();
+    const seal::Ciphertext& ciphertext = cipher->ciphertext();
+    m_ciphertexts[std::make_pair(ciphertext.parms_id(), ciphertext.size())]
+        .emplace_back(std::move(cipher));
+    cipher = nullptr;
+    m_byte_count += cipher_bytes;
+    ++released;
+  }
+  m_count += released;
+  return released;
+}
+
+size_t SealCiphertextPool::size() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_count;
+}
+
+size_t SealCiphertextPool::byte_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_byte_count;
+}
+
+void SealCiphertextPool::clear() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_ciphertexts.clear();
+  m_byte_count = 0;
+  m_count = 0;
+}
+
+}  // namespace ngraph::he
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::he {
+/// \brief Recycles the storage of ciphertexts which are no longer used.
+///
+/// Ciphertexts are pooled by size class, a (parms_id, polynomial count) pair.
+/// Intermediate tensors freed by liveness analysis return their ciphertexts to
+/// the pool, and output tensors of later ops take them from the pool. Since
+/// SEAL operations resize their destination in place, a recycled ciphertext
+/// with enough capacity is overwritten without a new allocation. Each
+/// executable owns a pool, which is freed with the executable.
+class SealCiphertextPool {
+ public:
+  /// \brief Constructs an empty pool
+  /// \param[in] max_bytes Maximum number of bytes of ciphertext storage to
+  /// hold. If 0, no ciphertexts are pooled
+  explicit SealCiphertextPool(size_t max_bytes = default_max_bytes())
+      : m_max_bytes(max_bytes) {}
+
+  /// \brief Returns the maximum pool size in bytes specified by the
+  /// CIPHERTEXT_POOL_MB environment variable, or 1 GB if not set
+  static size_t default_max_bytes();
+
+  /// \brief Replaces the ciphertexts of he_types with pooled ciphertexts,
+  /// while any are available. Ciphertexts of the requested size class are
+  /// used first, then those of other classes with enough capacity.
+  /// Plaintexts are unchanged
+  /// \param[in,out] he_types Values whose ciphertexts will be overwritten
+  /// \param[in] parms_id Parameter id of the ciphertexts to be written
+  /// \param[in] size Number of polynomials of the ciphertexts to be written
+  /// \param[in] context SEAL context used to find the needed capacity
+  /// \returns Number of ciphertexts taken from the pool
+  size_t acquire(std::vector<HEType>& he_types, seal::parms_id_type parms_id,
+                 size_t size, const seal::SEALContext& context);
+
+  /// \brief Returns the ciphertexts of he_types to the pool. Only ciphertexts
+  /// with storage from the global memory pool, which are referenced by
+  /// nothing else, are pooled
+  /// \param[in,out] he_types Values which are no longer used
+  /// \returns Number of ciphertexts returned to the pool
+  size_t release(std::vector<HEType>& he_types);
+
+  /// \brief Returns the number of pooled ciphertexts
+  size_t size() const;
+
+  /// \brief Returns the number of bytes of pooled ciphertext storage
+  size_t byte_count() const;
+
+  /// \brief Removes all pooled ciphertexts
+  void clear();
+
+ private:
+  using SizeClass = std::pair<seal::parms_id_type, size_t>;
+  using Ciphertexts = std::vector<std::shared_ptr<SealCiphertextWrapper>>;
+
+  mutable std::mutex m_mutex;
+  size_t m_max_bytes;
+  size_t m_byte_count{0};
+  size_t m_count{0};
+  std::map<SizeClass, Ciphertexts> m_ciphertexts;
+};
+
+}  // namespace ngraph::he
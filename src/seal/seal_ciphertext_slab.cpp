@@ -0,0 +1,117 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_ciphertext_slab.hpp"
+
+#include <sys/mman.h>
+
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include "ngraph/check.hpp"
+
+namespace {
+constexpr size_t huge_page_byte_count = size_t{2} << 20;
+
+size_t round_up(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+seal::SEAL_BYTE* allocate_slab(size_t byte_count) {
+  if (byte_count == 0) {
+    return nullptr;
+  }
+  // Slabs spanning huge pages start on a huge page boundary, so the kernel
+  // can back them with huge pages
+  size_t alignment =
+      byte_count >= huge_page_byte_count ? huge_page_byte_count : 64;
+  size_t alloc_byte_count = round_up(byte_count, alignment);
+  void* data = std::aligned_alloc(alignment, alloc_byte_count);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+#ifdef MADV_HUGEPAGE
+  if (alignment == huge_page_byte_count) {
+    madvise(data, alloc_byte_count, MADV_HUGEPAGE);
+  }
+#endif
+  return static_cast<seal::SEAL_BYTE*>(data);
+}
+}  // namespace
+
+namespace ngraph::he {
+
+SealCiphertextSlab::SealCiphertextSlab(size_t item_byte_count,
+                                       size_t item_count)
+    : m_byte_count(item_byte_count * item_count),
+      m_data(allocate_slab(m_byte_count)),
+      m_head(m_data, item_byte_count, item_count, m_mutex) {}
+
+SealCiphertextSlab::~SealCiphertextSlab() { std::free(m_data); }
+
+seal::util::Pointer<seal::SEAL_BYTE> SealCiphertextSlab::get_for_byte_count(
+    size_t byte_count) {
+  if (byte_count > 0 && byte_count <= m_head.item_byte_count()) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_head.free_count() > 0) {
+      return seal::util::Pointer<seal::SEAL_BYTE>(&m_head);
+    }
+  }
+  return static_cast<seal::util::MemoryPool&>(seal::MemoryManager::GetPool())
+      .get_for_byte_count(byte_count);
+}
+
+size_t SealCiphertextSlab::free_count() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_head.free_count();
+}
+
+bool SealCiphertextSlab::contains(const void* ptr) const {
+  std::less_equal<const void*> less_equal;
+  std::less<const void*> less;
+  return m_data != nullptr && less_equal(m_data, ptr) &&
+         less(ptr, m_data + m_byte_count);
+}
+
+SealCiphertextSlab::Head::Head(seal::SEAL_BYTE* data, size_t item_byte_count,
+                               size_t item_count, std::mutex& mutex)
+    : m_item_byte_count(item_byte_count), m_mutex(mutex) {
+  NGRAPH_CHECK(item_byte_count > 0, "Slab item size must be positive");
+  m_items.reserve(item_count);
+  m_free_items.reserve(item_count);
+  // Items are handed out in address order
+  for (size_t item_idx = item_count; item_idx > 0; --item_idx) {
+    m_items.emplace_back(std::make_unique<seal::util::MemoryPoolItem>(
+        data + (item_idx - 1) * item_byte_count));
+    m_free_items.emplace_back(m_items.back().get());
+  }
+}
+
+seal::util::MemoryPoolItem* SealCiphertextSlab::Head::get() {
+  NGRAPH_CHECK(!m_free_items.empty(), "No free items in ciphertext slab");
+  seal::util::MemoryPoolItem* item = m_free_items.back();
+  m_free_items.pop_back();
+  return item;
+}
+
+void SealCiphertextSlab::Head::add(
+    seal::util::MemoryPoolItem* new_first) noexcept {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_free_items.emplace_back(new_first);
+}
+
+}  // namespace ngraph::he
@@ -0,0 +1,106 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "seal/memorymanager.h"
+#include "seal/seal.h"
+#include "seal/util/mempool.h"
+#include "seal/util/pointer.h"
+
+namespace ngraph::he {
+/// \brief SEAL memory pool which serves allocations of up to a single size from
+/// one contiguous slab, and any larger allocation from the global memory pool.
+///
+/// Ciphertexts created with a handle to the slab store their coefficients in
+/// consecutive items of the slab, rather than in separate heap allocations.
+/// Large slabs are aligned to, and advised to use, huge pages. The slab is
+/// freed once no ciphertext or handle refers to it.
+class SealCiphertextSlab : public seal::util::MemoryPool {
+ public:
+  /// \brief Constructs a slab
+  /// \param[in] item_byte_count Number of bytes of each item
+  /// \param[in] item_count Number of items in the slab
+  SealCiphertextSlab(size_t item_byte_count, size_t item_count);
+
+  SealCiphertextSlab(const SealCiphertextSlab&) = delete;
+  SealCiphertextSlab& operator=(const SealCiphertextSlab&) = delete;
+
+  ~SealCiphertextSlab() override;
+
+  /// \brief Returns an item of the slab if byte_count is at most the item size
+  /// and an item is free, or an allocation from the global memory pool
+  /// \param[in] byte_count Number of bytes to allocate
+  seal::util::Pointer<seal::SEAL_BYTE> get_for_byte_count(
+      size_t byte_count) override;
+
+  /// \brief Returns the number of slabs, i.e. 1
+  size_t pool_count() const override { return 1; }
+
+  /// \brief Returns the number of bytes of the slab
+  size_t alloc_byte_count() const override { return m_byte_count; }
+
+  /// \brief Returns the number of bytes of each item
+  size_t item_byte_count() const { return m_head.item_byte_count(); }
+
+  /// \brief Returns the number of items which are not in use
+  size_t free_count() const;
+
+  /// \brief Returns whether or not ptr points into the slab
+  /// \param[in] ptr Pointer to check
+  bool contains(const void* ptr) const;
+
+ private:
+  /// \brief Hands out the items of the slab. Allocation is guarded by the
+  /// mutex of the slab
+  class Head : public seal::util::MemoryPoolHead {
+   public:
+    Head(seal::SEAL_BYTE* data, size_t item_byte_count, size_t item_count,
+         std::mutex& mutex);
+
+    size_t item_byte_count() const noexcept override {
+      return m_item_byte_count;
+    }
+
+    size_t item_count() const noexcept override { return m_items.size(); }
+
+    /// \brief Returns a free item. Must be called with the mutex held
+    seal::util::MemoryPoolItem* get() override;
+
+    /// \brief Returns an item to the slab
+    void add(seal::util::MemoryPoolItem* new_first) noexcept override;
+
+    size_t free_count() const noexcept { return m_free_items.size(); }
+
+   private:
+    size_t m_item_byte_count;
+    std::mutex& m_mutex;
+    std::vector<std::unique_ptr<seal::util::MemoryPoolItem>> m_items;
+    std::vector<seal::util::MemoryPoolItem*> m_free_items;
+  };
+
+  size_t m_byte_count;
+  seal::SEAL_BYTE* m_data;
+  mutable std::mutex m_mutex;
+  Head m_head;
+};
+
+}  // namespace ngraph::he
@@ -16,14 +16,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "protos/message.pb.h"
 #include "seal/seal.h"
+#include "seal/seal_ciphertext_codec.hpp"
 
 namespace ngraph::he {
 /// \brief Returns the size in bytes required to serialize a ciphertext
@@ -64,7 +68,8 @@ class SealCiphertextWrapper {
   explicit SealCiphertextWrapper(seal::Ciphertext cipher)
       : m_ciphertext(std::move(cipher)) {}
 
-  /// \brief Returns the ciphertext
+  /// \brief Returns the ciphertext. Callers which modify the ciphertext must
+  /// call clear_seeded(), so the stale seeded serialization is not sent
   seal::Ciphertext& ciphertext() { return m_ciphertext; }
 
   /// \brief Returns the ciphertext
@@ -79,22 +84,89 @@ class SealCiphertextWrapper {
   /// \brief Returns scale of the ciphertext
   double scale() const { return m_ciphertext.scale(); }
 
-  /// \brief Writes the ciphertext to a protobuf object
+  /// \brief Returns whether the ciphertext has a seeded serialization
+  bool is_seeded() const { return !m_seeded_ciphertext.empty(); }
+
+  /// \brief Stores the seeded serialization of the ciphertext, as written by
+  /// seal::Encryptor::encrypt_symmetric_save. The seeded form stores a PRNG
+  /// seed in place of the second polynomial, so is about half the size. It is
+  /// written by save until the ciphertext is next modified
+  /// \param[in] seeded_ciphertext Seeded serialization of ciphertext()
+  void set_seeded(std::string seeded_ciphertext) {
+    m_seeded_ciphertext = std::move(seeded_ciphertext);
+  }
+
+  /// \brief Discards the seeded serialization of the ciphertext, once the
+  /// ciphertext is modified
+  void clear_seeded() { m_seeded_ciphertext.clear(); }
+
+  /// \brief Writes the ciphertext to a protobuf object. Writes the seeded
+  /// serialization, if any, regardless of the codec
   /// \param[out] he_type Protobuf object to write ciphertext to
-  void save(pb::HEType& he_type) const {
-    size_t cipher_size = ciphertext_size(m_ciphertext);
+  /// \param[in] codec Codec to serialize the ciphertext with
+  void save(pb::HEType& he_type,
+            CiphertextCodec codec = pb::HEType::NONE) const {
+    if (is_seeded()) {
+      he_type.set_ciphertext(m_seeded_ciphertext);
+      he_type.set_is_seeded(true);
+      return;
+    }
     std::string cipher_str;
-    cipher_str.resize(cipher_size);
+    save_ciphertext(m_ciphertext, codec, cipher_str);
+    he_type.set_ciphertext(std::move(cipher_str));
+    he_type.set_codec(codec);
+  }
 
-    size_t save_size = ngraph::he::save(
-        m_ciphertext, reinterpret_cast<std::byte*>(cipher_str.data()));
+  /// \brief Returns the number of bytes of the ciphertext's polynomial data
+  size_t data_size() const {
+    return m_ciphertext.uint64_count() * sizeof(std::uint64_t);
+  }
 
-    NGRAPH_CHECK(save_size == cipher_size, "Save size != cipher size");
+  /// \brief Writes the ciphertext metadata to a protobuf header. The
+  /// polynomial data is not written, and should be transferred directly from
+  /// ciphertext().data()
+  /// \param[out] header Protobuf header to write the metadata to
+  void save_header(pb::CiphertextHeader& header) const {
+    for (const auto& parms_id_elem : m_ciphertext.parms_id()) {
+      header.add_parms_id(parms_id_elem);
+    }
+    header.set_size(m_ciphertext.size());
+    header.set_scale(m_ciphertext.scale());
+    header.set_is_ntt_form(m_ciphertext.is_ntt_form());
+    header.set_data_size(data_size());
+  }
 
-    he_type.set_ciphertext(std::move(cipher_str));
+  /// \brief Allocates a ciphertext with the metadata in a protobuf header,
+  /// such that the polynomial data can be read directly into
+  /// ciphertext().data()
+  /// \param[out] dst Ciphertext to allocate
+  /// \param[in] header Protobuf header to read metadata from
+  /// \param[in] context SEAL context to validate the metadata against
+  /// \throws ngraph_error if the header is not valid for the context
+  static void allocate(SealCiphertextWrapper& dst,
+                       const pb::CiphertextHeader& header,
+                       const std::shared_ptr<seal::SEALContext>& context) {
+    seal::parms_id_type parms_id;
+    NGRAPH_CHECK(
+        static_cast<size_t>(header.parms_id_size()) == parms_id.size(),
+        "Ciphertext header has invalid parms_id");
+    std::copy(header.parms_id().begin(), header.parms_id().end(),
+              parms_id.begin());
+    NGRAPH_CHECK(context->get_context_data(parms_id) != nullptr,
+                 "Ciphertext header parms_id is not valid for context");
+
+    dst.clear_seeded();
+    seal::Ciphertext& cipher = dst.ciphertext();
+    cipher.resize(context, parms_id, header.size());
+    cipher.is_ntt_form() = header.is_ntt_form();
+    cipher.scale() = header.scale();
+    NGRAPH_CHECK(dst.data_size() == header.data_size(),
+                 "Ciphertext header data size ", header.data_size(),
+                 " does not match allocated size ", dst.data_size());
   }
 
-  /// \brief Loads a ciphertext from a protobuf object
+  /// \brief Loads a ciphertext from a protobuf object. Seeded ciphertexts are
+  /// expanded to their full size
   /// \param[out] dst Destination to load ciphertext to
   /// \param[in] proto_he_type Protobuf object to load object from
   /// \param[in] context SEAL context to validate loaded ciphertext against
@@ -103,14 +175,16 @@ class SealCiphertextWrapper {
     NGRAPH_CHECK(!proto_he_type.is_plaintext(),
                  "Cannot load ciphertext from plaintext HEType");
 
-    const std::string& cipher_str = proto_he_type.ciphertext();
-    ngraph::he::load(dst.ciphertext(), std::move(context),
-                     reinterpret_cast<const std::byte*>(cipher_str.data()),
-                     cipher_str.size());
+    dst.clear_seeded();
+    load_ciphertext(dst.ciphertext(), proto_he_type.codec(),
+                    proto_he_type.ciphertext(), std::move(context));
+    NGRAPH_CHECK(!proto_he_type.is_seeded() || dst.size() == 2,
+                 "Seeded ciphertext has size ", dst.size(), ", expected 2");
   }
 
  private:
   seal::Ciphertext m_ciphertext;
+  std::string m_seeded_ciphertext;
 };
 
 }  // namespace ngraph::he
@@ -0,0 +1,89 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_client_key_cache.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "seal/util/hash.h"
+
+namespace ngraph::he {
+std::string client_key_fingerprint(const std::string& public_key,
+                                   const std::string& relin_keys,
+                                   const std::string& galois_keys) {
+  // Hash the sizes followed by the zero-padded key data
+  const std::string* keys[] = {&public_key, &relin_keys, &galois_keys};
+  std::vector<std::uint64_t> words;
+  for (const std::string* key : keys) {
+    words.emplace_back(key->size());
+  }
+  for (const std::string* key : keys) {
+    size_t offset = words.size();
+    words.resize(offset + (key->size() + sizeof(std::uint64_t) - 1) /
+                              sizeof(std::uint64_t),
+                 0);
+    std::memcpy(words.data() + offset, key->data(), key->size());
+  }
+
+  seal::util::HashFunction::hash_block_type hash;
+  seal::util::HashFunction::hash(words.data(), words.size(), hash);
+  return std::string(reinterpret_cast<const char*>(hash.data()),
+                     hash.size() * sizeof(std::uint64_t));
+}
+
+size_t SealClientKeyCache::default_capacity() {
+  const char* capacity = std::getenv("CLIENT_KEY_CACHE_SIZE");
+  if (capacity == nullptr) {
+    return 16;
+  }
+  return std::stoul(capacity);
+}
+
+std::shared_ptr<const SealClientKeys> SealClientKeyCache::find(
+    const std::string& fingerprint) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_index.find(fingerprint);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->second;
+}
+
+void SealClientKeyCache::insert(const std::string& fingerprint,
+                                std::shared_ptr<const SealClientKeys> keys) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_capacity == 0) {
+    return;
+  }
+  auto it = m_index.find(fingerprint);
+  if (it != m_index.end()) {
+    it->second->second = std::move(keys);
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+  if (m_entries.size() == m_capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+  m_entries.emplace_front(fingerprint, std::move(keys));
+  m_index[fingerprint] = m_entries.begin();
+}
+}  // namespace ngraph::he
@@ -0,0 +1,91 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "seal/seal.h"
+
+namespace ngraph::he {
+/// \brief Keys a client uploaded to the server. The keys are not modified
+/// once cached, so sessions with the same client share them
+struct SealClientKeys {
+  std::shared_ptr<seal::PublicKey> public_key;
+  std::shared_ptr<seal::RelinKeys> relin_keys;
+  /// nullptr if the client uploaded no Galois keys
+  std::shared_ptr<seal::GaloisKeys> galois_keys;
+  /// Rotation steps for which galois_keys has keys
+  std::vector<int> galois_steps;
+};
+
+/// \brief Returns the fingerprint identifying a client's serialized keys
+/// \param[in] public_key Serialized public key
+/// \param[in] relin_keys Serialized relinearization keys
+/// \param[in] galois_keys Serialized Galois keys, or empty if there are none
+std::string client_key_fingerprint(const std::string& public_key,
+                                   const std::string& relin_keys,
+                                   const std::string& galois_keys);
+
+/// \brief Least-recently-used cache of deserialized client keys, indexed by
+/// their fingerprint. A returning client presents its fingerprint instead of
+/// uploading its keys again
+class SealClientKeyCache {
+ public:
+  /// \brief Constructs an empty cache
+  /// \param[in] capacity Maximum number of clients whose keys are cached. If
+  /// 0, no keys are cached
+  explicit SealClientKeyCache(size_t capacity = default_capacity())
+      : m_capacity(capacity) {}
+
+  /// \brief Returns the capacity specified by the CLIENT_KEY_CACHE_SIZE
+  /// environment variable, or 16 if not set
+  static size_t default_capacity();
+
+  /// \brief Returns the keys with the given fingerprint, or nullptr if they
+  /// are not cached. Found keys become the most recently used
+  /// \param[in] fingerprint Fingerprint of the keys
+  std::shared_ptr<const SealClientKeys> find(const std::string& fingerprint);
+
+  /// \brief Caches keys, evicting the least recently used keys if the cache
+  /// is full
+  /// \param[in] fingerprint Fingerprint of the keys
+  /// \param[in] keys Keys to cache
+  void insert(const std::string& fingerprint,
+              std::shared_ptr<const SealClientKeys> keys);
+
+  /// \brief Returns the number of cached keys
+  size_t size() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_entries.size();
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<const SealClientKeys>>;
+
+  mutable std::mutex m_mutex;
+  size_t m_capacity;
+  // Most recently used keys first
+  std::list<Entry> m_entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+};
+}  // namespace ngraph::he
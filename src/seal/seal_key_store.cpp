@@ -0,0 +1,264 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_key_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/log.hpp"
+
+namespace {
+// Identifies the key store format. Bump the version when the layout changes
+constexpr std::array<char, 8> key_store_magic{'N', 'G', 'H', 'E',
+                                              'K', 'E', 'Y', '2'};
+
+/// \brief Read-only memory mapping of a file, unmapped on destruction
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+      m_size = static_cast<size_t>(file_stat.st_size);
+      void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        m_data = static_cast<const std::byte*>(data);
+      }
+    }
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (m_data != nullptr) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+  }
+
+  const std::byte* data() const { return m_data; }
+  size_t size() const { return m_data == nullptr ? 0 : m_size; }
+
+ private:
+  const std::byte* m_data{nullptr};
+  size_t m_size{0};
+};
+
+/// \brief Reads consecutive fields from a serialized key store
+class KeyStoreReader {
+ public:
+  KeyStoreReader(const std::byte* data, size_t size)
+      : m_data(data), m_remaining(size) {}
+
+  template <typename T>
+  T read() {
+    T value;
+    std::memcpy(&value, next(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  /// \brief Returns the next section, prefixed by its size
+  std::pair<const std::byte*, size_t> read_section() {
+    auto size = read<std::uint64_t>();
+    return {next(size), size};
+  }
+
+ private:
+  const std::byte* next(size_t size) {
+    NGRAPH_CHECK(size <= m_remaining, "Key store is truncated");
+    const std::byte* field = m_data;
+    m_data += size;
+    m_remaining -= size;
+    return field;
+  }
+
+  const std::byte* m_data;
+  size_t m_remaining;
+};
+
+template <typename T>
+void append(std::vector<std::byte>& buffer, const T& value) {
+  size_t offset = buffer.size();
+  buffer.resize(offset + sizeof(T));
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <typename Key>
+void append_key(std::vector<std::byte>& buffer, const Key& key) {
+  auto max_size =
+      static_cast<size_t>(key.save_size(seal::compr_mode_type::none));
+  size_t size_offset = buffer.size();
+  append<std::uint64_t>(buffer, 0);
+  size_t key_offset = buffer.size();
+  buffer.resize(key_offset + max_size);
+  auto size = static_cast<std::uint64_t>(key.save(
+      buffer.data() + key_offset, max_size, seal::compr_mode_type::none));
+  buffer.resize(key_offset + size);
+  std::memcpy(buffer.data() + size_offset, &size, sizeof(size));
+}
+
+template <typename Key>
+std::shared_ptr<Key> load_key(
+    KeyStoreReader& reader, const std::shared_ptr<seal::SEALContext>& context) {
+  auto [data, size] = reader.read_section();
+  if (size == 0) {
+    return nullptr;
+  }
+  auto key = std::make_shared<Key>();
+  key->load(context, data, size);
+  return key;
+}
+}  // namespace
+
+namespace ngraph::he {
+std::uint64_t key_store_fingerprint(const HESealEncryptionParameters& parms) {
+  std::stringstream stream;
+  parms.save(stream);
+  // 64-bit FNV-1a hash
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (char c : stream.str()) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void save_key_store(const std::string& path,
+                    const HESealEncryptionParameters& parms,
+                    const SealKeys& keys) {
+  NGRAPH_CHECK(keys.secret_key != nullptr && keys.public_key != nullptr &&
+                   keys.relin_keys != nullptr,
+               "Key store requires secret, public, and relinearization keys");
+
+  std::vector<std::byte> buffer;
+  for (char c : key_store_magic) {
+    append(buffer, c);
+  }
+  append<std::uint64_t>(buffer, key_store_fingerprint(parms));
+  std::vector<int> galois_steps;
+  if (keys.galois_keys != nullptr) {
+    galois_steps = keys.galois_steps;
+  }
+  append<std::uint64_t>(buffer, galois_steps.size());
+  for (int step : galois_steps) {
+    append<std::int32_t>(buffer, step);
+  }
+  append_key(buffer, *keys.secret_key);
+  append_key(buffer, *keys.public_key);
+  append_key(buffer, *keys.relin_keys);
+  if (keys.galois_keys != nullptr) {
+    append_key(buffer, *keys.galois_keys);
+  } else {
+    append<std::uint64_t>(buffer, 0);
+  }
+  append<std::uint64_t>(buffer, keys.key_fingerprint.size());
+  size_t fingerprint_offset = buffer.size();
+  buffer.resize(fingerprint_offset + keys.key_fingerprint.size());
+  std::memcpy(buffer.data() + fingerprint_offset, keys.key_fingerprint.data(),
+              keys.key_fingerprint.size());
+
+  // Write to a temporary file first, so readers never see a partial store
+  std::string tmp_path = path + ".tmp";
+  int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  NGRAPH_CHECK(fd >= 0, "Cannot open key store ", tmp_path, " for writing");
+  size_t written = 0;
+  while (written < buffer.size()) {
+    ssize_t count =
+        ::write(fd, buffer.data() + written, buffer.size() - written);
+    if (count <= 0) {
+      ::close(fd);
+      std::remove(tmp_path.c_str());
+      NGRAPH_CHECK(false, "Error writing key store ", tmp_path);
+    }
+    written += static_cast<size_t>(count);
+  }
+  ::close(fd);
+  NGRAPH_CHECK(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+               "Cannot move key store to ", path);
+  NGRAPH_HE_LOG(3) << "Saved " << buffer.size() << " bytes of keys to "
+                   << path;
+}
+
+bool load_key_store(const std::string& path,
+                    const HESealEncryptionParameters& parms,
+                    const std::shared_ptr<seal::SEALContext>& context,
+                    SealKeys& keys) {
+  MappedFile file(path);
+  if (file.data() == nullptr) {
+    NGRAPH_HE_LOG(3) << "No key store at " << path;
+    return false;
+  }
+
+  try {
+    KeyStoreReader reader(file.data(), file.size());
+    for (char c : key_store_magic) {
+      if (reader.read<char>() != c) {
+        NGRAPH_WARN << "File " << path << " is not a key store";
+        return false;
+      }
+    }
+    if (reader.read<std::uint64_t>() != key_store_fingerprint(parms)) {
+      NGRAPH_HE_LOG(3) << "Key store " << path
+                       << " was saved with different encryption parameters";
+      return false;
+    }
+
+    SealKeys loaded;
+    auto step_count = reader.read<std::uint64_t>();
+    loaded.galois_steps.reserve(step_count);
+    for (std::uint64_t step_idx = 0; step_idx < step_count; ++step_idx) {
+      loaded.galois_steps.emplace_back(reader.read<std::int32_t>());
+    }
+    loaded.secret_key = load_key<seal::SecretKey>(reader, context);
+    loaded.public_key = load_key<seal::PublicKey>(reader, context);
+    loaded.relin_keys = load_key<seal::RelinKeys>(reader, context);
+    loaded.galois_keys = load_key<seal::GaloisKeys>(reader, context);
+    auto [fingerprint, fingerprint_size] = reader.read_section();
+    loaded.key_fingerprint.assign(reinterpret_cast<const char*>(fingerprint),
+                                  fingerprint_size);
+    NGRAPH_CHECK(loaded.secret_key != nullptr &&
+                     loaded.public_key != nullptr &&
+                     loaded.relin_keys != nullptr,
+                 "Key store is missing keys");
+    if (loaded.galois_keys == nullptr) {
+      loaded.galois_steps.clear();
+    }
+    keys = std::move(loaded);
+  } catch (const std::exception& e) {
+    NGRAPH_WARN << "Error loading key store " << path << ": " << e.what();
+    return false;
+  }
+  NGRAPH_HE_LOG(3) << "Loaded keys from " << path;
+  return true;
+}
+}  // namespace ngraph::he
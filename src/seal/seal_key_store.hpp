@@ -0,0 +1,69 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::he {
+/// \brief SEAL keys stored in a key store file
+struct SealKeys {
+  std::shared_ptr<seal::SecretKey> secret_key;
+  std::shared_ptr<seal::PublicKey> public_key;
+  std::shared_ptr<seal::RelinKeys> relin_keys;
+  /// May be nullptr if no Galois keys are stored
+  std::shared_ptr<seal::GaloisKeys> galois_keys;
+  /// Rotation steps for which galois_keys has keys
+  std::vector<int> galois_steps;
+  /// Fingerprint of the serialized public and evaluation keys, as presented
+  /// to servers. Empty if not yet computed
+  std::string key_fingerprint;
+};
+
+/// \brief Returns a fingerprint of the encryption parameters. Keys stored with
+/// one fingerprint are only loaded with encryption parameters of the same
+/// fingerprint
+/// \param[in] parms Encryption parameters
+std::uint64_t key_store_fingerprint(const HESealEncryptionParameters& parms);
+
+/// \brief Saves keys to a key store file, replacing the file atomically. The
+/// file is readable by the owner only, since it stores the secret key
+/// \param[in] path Path of the key store file
+/// \param[in] parms Encryption parameters the keys were generated for
+/// \param[in] keys Keys to save. The secret, public, and relinearization keys
+/// must be set
+void save_key_store(const std::string& path,
+                    const HESealEncryptionParameters& parms,
+                    const SealKeys& keys);
+
+/// \brief Loads keys from a key store file by mapping the file into memory
+/// \param[in] path Path of the key store file
+/// \param[in] parms Encryption parameters the keys should match
+/// \param[in] context SEAL context to validate the keys against
+/// \param[out] keys Loaded keys
+/// \returns True if the keys were loaded. False if the file does not exist,
+/// its fingerprint does not match parms, or it is not a valid key store
+bool load_key_store(const std::string& path,
+                    const HESealEncryptionParameters& parms,
+                    const std::shared_ptr<seal::SEALContext>& context,
+                    SealKeys& keys);
+}  // namespace ngraph::he
@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_plaintext_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "logging/ngraph_he_log.hpp"
+#include "seal/seal_util.hpp"
+#include "task_runtime.hpp"
+
+namespace ngraph::he {
+
+SealEncodedPlaintext::SealEncodedPlaintext(const HEPlaintext& plain,
+                                           seal::parms_id_type parms_id,
+                                           double scale,
+                                           const HESealBackend& he_seal_backend)
+    : m_parms_id(parms_id), m_scale(scale), m_is_scalar(plain.size() == 1) {
+  if (m_is_scalar) {
+    encode(plain[0], element::f32, scale, parms_id, m_scalar, he_seal_backend);
+  } else {
+    // Never complex-pack for multiplication
+    encode(m_plaintext, plain, *he_seal_backend.get_ckks_encoder(), parms_id,
+           element::f32, scale, false);
+  }
+}
+
+const std::vector<SealEncodedPlaintext>* SealPlaintextCache::get_encodings(
+    const std::vector<HEType>& values, const std::vector<HEType>& ciphers,
+    const HESealBackend& he_seal_backend) {
+  auto cipher_it = std::find_if(
+      ciphers.begin(), ciphers.end(),
+      [](const HEType& he_type) { return he_type.is_ciphertext(); });
+  if (cipher_it == ciphers.end()) {
+    return nullptr;
+  }
+  const SealCiphertextWrapper& cipher = *cipher_it->get_ciphertext();
+  const seal::parms_id_type parms_id = cipher.ciphertext().parms_id();
+  const double scale = cipher.scale();
+  const auto key = std::make_pair(parms_id, scale);
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_encodings.find(key);
+  if (it != m_encodings.end()) {
+    return &it->second;
+  }
+
+  NGRAPH_HE_LOG(3) << "Encoding " << values.size()
+                   << " cached plaintext values at chain index "
+                   << he_seal_backend.get_chain_index(cipher);
+  std::vector<SealEncodedPlaintext> encodings(values.size());
+  parallel_for(0, values.size(), [&](size_t i) {
+    if (!values[i].is_plaintext()) {
+      return;
+    }
+    const HEPlaintext& plain = values[i].get_plaintext();
+    // Multiplication by zero never uses an encoding
+    bool is_zero = std::all_of(plain.begin(), plain.end(),
+                               [](double f) { return std::abs(f) < 1e-5f; });
+    if (!is_zero) {
+      encodings[i] =
+          SealEncodedPlaintext(plain, parms_id, scale, he_seal_backend);
+    }
+  });
+  return &m_encodings.emplace(key, std::move(encodings)).first->second;
+}
+
+void SealPlaintextCache::clear() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_encodings.clear();
+}
+
+}  // namespace ngraph::he
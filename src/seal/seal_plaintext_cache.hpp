@@ -0,0 +1,101 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
+#include "seal/seal_plaintext_wrapper.hpp"
+
+namespace ngraph::he {
+/// \brief Plaintext values encoded at a fixed level and scale, ready to be
+/// multiplied with a ciphertext at the same level
+class SealEncodedPlaintext {
+ public:
+  /// \brief Constructs an empty encoding, which matches no ciphertext
+  SealEncodedPlaintext() = default;
+
+  /// \brief Encodes plaintext values for multiplication with a ciphertext.
+  /// Single values are stored as one CRT coefficient per coefficient modulus;
+  /// multiple values are encoded into an NTT-form plaintext
+  /// \param[in] plain Values to encode
+  /// \param[in] parms_id Seal parameter id to use in encoding
+  /// \param[in] scale Scale at which to encode the values
+  /// \param[in] he_seal_backend Backend whose context is used for encoding
+  SealEncodedPlaintext(const HEPlaintext& plain, seal::parms_id_type parms_id,
+                       double scale, const HESealBackend& he_seal_backend);
+
+  /// \brief Returns the parameter id at which the values are encoded
+  const seal::parms_id_type& parms_id() const { return m_parms_id; }
+
+  /// \brief Returns the scale at which the values are encoded
+  double scale() const { return m_scale; }
+
+  /// \brief Returns whether or not a single value is encoded
+  bool is_scalar() const { return m_is_scalar; }
+
+  /// \brief Returns the encoding of a single value in CRT form
+  const std::vector<std::uint64_t>& scalar() const { return m_scalar; }
+
+  /// \brief Returns the encoding of multiple values
+  const SealPlaintextWrapper& plaintext() const { return m_plaintext; }
+
+ private:
+  seal::parms_id_type m_parms_id{seal::parms_id_zero};
+  double m_scale{0};
+  bool m_is_scalar{false};
+  std::vector<std::uint64_t> m_scalar;
+  SealPlaintextWrapper m_plaintext;
+};
+
+/// \brief Cache of the encoded values of a plaintext tensor which does not
+/// change between calls, such as the output of a Constant node. Each value is
+/// encoded at most once per level and scale.
+class SealPlaintextCache {
+ public:
+  /// \brief Returns the encodings of the values at the level and scale of the
+  /// first ciphertext in ciphers, encoding the values on first use.
+  /// \param[in] values Plaintext values to encode. Ciphertext values get an
+  /// empty encoding
+  /// \param[in] ciphers Data the values will be multiplied with
+  /// \param[in] he_seal_backend Backend whose context is used for encoding
+  /// \returns Pointer to one encoding per value, or nullptr if ciphers contains
+  /// no ciphertext
+  const std::vector<SealEncodedPlaintext>* get_encodings(
+      const std::vector<HEType>& values, const std::vector<HEType>& ciphers,
+      const HESealBackend& he_seal_backend);
+
+  /// \brief Removes all cached encodings
+  void clear();
+
+ private:
+  std::mutex m_mutex;
+  // Encodings keyed by (parms_id, scale). The parms_id determines the chain
+  // index, and also distinguishes encryption parameters
+  std::map<std::pair<seal::parms_id_type, double>,
+           std::vector<SealEncodedPlaintext>>
+      m_encodings;
+};
+
+}  // namespace ngraph::he
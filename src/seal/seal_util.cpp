@@ -20,6 +20,7 @@
 
 #include <chrono>
 #include <limits>
+#include <sstream>
 #include <utility>
 
 #include "logging/ngraph_he_log.hpp"
@@ -28,6 +29,7 @@
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/uintarith.h"
+#include "task_runtime.hpp"
 
 namespace ngraph::he {
 void match_modulus_and_scale_inplace(SealCiphertextWrapper& arg0,
@@ -40,6 +42,9 @@ void match_modulus_and_scale_inplace(SealCiphertextWrapper& arg0,
   if (chain_ind0 == chain_ind1) {
     return;
   }
+  // Either ciphertext may be switched or rescaled in place
+  arg0.clear_seeded();
+  arg1.clear_seeded();
   bool rescale = !within_rescale_tolerance(arg0, arg1);
 
   if (chain_ind0 < chain_ind1) {
@@ -118,7 +123,18 @@ void add_plain_inplace(seal::Ciphertext& encrypted, double value,
 }
 
 void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
-                            const HESealBackend& he_seal_backend,
+                            double scale, const HESealBackend& he_seal_backend,
+                            const seal::MemoryPoolHandle& pool) {
+  std::vector<std::uint64_t> plaintext_vals;
+  encode(value, ngraph::element::f32, scale, encrypted.parms_id(),
+         plaintext_vals, he_seal_backend, pool);
+  multiply_plain_inplace(encrypted, plaintext_vals, scale, he_seal_backend,
+                         pool);
+}
+
+void multiply_plain_inplace(seal::Ciphertext& encrypted,
+                            const std::vector<std::uint64_t>& plaintext_vals,
+                            double scale, const HESealBackend& he_seal_backend,
                             const seal::MemoryPoolHandle& pool) {
   // Verify parameters.
   auto context = he_seal_backend.get_context();
@@ -149,13 +165,10 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
     throw ngraph_error("invalid parameters");
   }
 
-  std::vector<std::uint64_t> plaintext_vals(coeff_mod_count, 0);
-  // TODO(fboemer): explore using different scales! Smaller scales might reduce
-  // # of rescalings
-  double scale = encrypted.scale();
-  encode(value, ngraph::element::f32, scale, encrypted.parms_id(),
-         plaintext_vals, he_seal_backend);
-  double new_scale = scale * scale;
+  NGRAPH_CHECK(plaintext_vals.size() == coeff_mod_count,
+               "Encoded value has ", plaintext_vals.size(),
+               " coefficients, expected ", coeff_mod_count);
+  double new_scale = encrypted.scale() * scale;
   // Check that scale is positive and not too large
   if (new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
                          context_data.total_coeff_modulus_bit_count())) {
@@ -243,25 +256,86 @@ size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
                    << smallest_chain_ind.second;
 
   // TODO(fboemer): loop over only ciphertext indices?
-  auto smallest_cipher = *he_types[smallest_chain_ind.first].get_ciphertext();
-#pragma omp parallel for
-  for (size_t idx = 0; idx < num_elements; ++idx) {
-    if (he_types[idx].is_ciphertext()) {
-      auto& cipher = *he_types[idx].get_ciphertext();
-      if (idx != smallest_chain_ind.second) {
-        match_modulus_and_scale_inplace(smallest_cipher, cipher,
-                                        he_seal_backend);
+  const auto& smallest_cipher =
+      *he_types[smallest_chain_ind.first].get_ciphertext();
+  auto match_range = [&](size_t range_begin, size_t range_end) {
+    // Matching may update the scale of the reference, so each chunk matches
+    // against its own copy
+    SealCiphertextWrapper reference(smallest_cipher);
+    for (size_t idx = range_begin; idx < range_end; ++idx) {
+      if (he_types[idx].is_ciphertext() && idx != smallest_chain_ind.first) {
+        auto& cipher = *he_types[idx].get_ciphertext();
+        match_modulus_and_scale_inplace(reference, cipher, he_seal_backend);
         size_t chain_ind = he_seal_backend.get_chain_index(cipher);
         NGRAPH_CHECK(chain_ind == smallest_chain_ind.second, "chain_ind",
                      chain_ind, " does not match smallest ",
                      smallest_chain_ind.second);
       }
     }
-  }
+  };
+  parallel_for_ranges(0, num_elements, match_range,
+                      TaskRuntime::global().default_grain(num_elements));
 
   return smallest_chain_ind.second;
 }
 
+seal::parms_id_type parms_id_at_chain_index(const seal::SEALContext& context,
+                                            size_t chain_index) {
+  auto context_data = context.first_context_data();
+  NGRAPH_CHECK(chain_index <= context_data->chain_index(), "Chain index ",
+               chain_index, " exceeds first chain index ",
+               context_data->chain_index());
+  while (context_data->chain_index() > chain_index) {
+    context_data = context_data->next_context_data();
+  }
+  return context_data->parms_id();
+}
+
+size_t lowest_decryptable_chain_index(const SealCiphertextWrapper& cipher,
+                                      const HESealBackend& he_seal_backend) {
+  const auto& context = *he_seal_backend.get_context();
+  double headroom_bits =
+      context.last_context_data()->total_coeff_modulus_bit_count() -
+      std::log2(he_seal_backend.get_scale());
+  double cipher_scale_bits = std::log2(cipher.scale());
+
+  auto context_data = context.get_context_data(cipher.ciphertext().parms_id());
+  NGRAPH_CHECK(context_data != nullptr, "Ciphertext is not valid for context");
+  auto next_data = context_data->next_context_data();
+  while (next_data != nullptr &&
+         next_data->total_coeff_modulus_bit_count() - cipher_scale_bits >=
+             headroom_bits) {
+    context_data = next_data;
+    next_data = context_data->next_context_data();
+  }
+  return context_data->chain_index();
+}
+
+std::shared_ptr<SealCiphertextWrapper> mod_switch_to_lowest_level(
+    const SealCiphertextWrapper& cipher, const HESealBackend& he_seal_backend) {
+  auto switched = std::make_shared<SealCiphertextWrapper>(cipher.ciphertext());
+  size_t chain_index = lowest_decryptable_chain_index(cipher, he_seal_backend);
+  if (chain_index < he_seal_backend.get_chain_index(cipher)) {
+    he_seal_backend.get_evaluator()->mod_switch_to_inplace(
+        switched->ciphertext(),
+        parms_id_at_chain_index(*he_seal_backend.get_context(), chain_index));
+  }
+  return switched;
+}
+
+void mod_switch_to_lowest_level(std::vector<HEType>& he_types,
+                                const HESealBackend& he_seal_backend) {
+  parallel_for(0, he_types.size(), [&](size_t idx) {
+    HEType& he_type = he_types[idx];
+    if (he_type.is_ciphertext()) {
+      auto switched = mod_switch_to_lowest_level(*he_type.get_ciphertext(),
+                                                 he_seal_backend);
+      he_type =
+          HEType(switched, he_type.complex_packing(), he_type.batch_size());
+    }
+  });
+}
+
 void encode(double value, const ngraph::element::Type& element_type,
             double scale, seal::parms_id_type parms_id,
             std::vector<std::uint64_t>& destination,
@@ -494,11 +568,26 @@ void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
              const HEPlaintext& input, seal::parms_id_type parms_id,
              const ngraph::element::Type& element_type, double scale,
              seal::CKKSEncoder& ckks_encoder, const seal::Encryptor& encryptor,
-             bool complex_packing) {
+             bool complex_packing,
+             const std::shared_ptr<seal::SEALContext>& seeded_context) {
   auto plaintext = SealPlaintextWrapper(complex_packing);
   encode(plaintext, input, ckks_encoder, parms_id, element_type, scale,
          complex_packing);
-  encryptor.encrypt(plaintext.plaintext(), output->ciphertext());
+  if (seeded_context == nullptr) {
+    output->clear_seeded();
+    encryptor.encrypt(plaintext.plaintext(), output->ciphertext());
+    return;
+  }
+  // The seeded form can only be serialized, so is loaded to expand the
+  // ciphertext, and kept for sending
+  std::stringstream stream;
+  encryptor.encrypt_symmetric_save(plaintext.plaintext(), stream,
+                                   seal::compr_mode_type::none);
+  std::string seeded_ciphertext = stream.str();
+  ngraph::he::load(output->ciphertext(), seeded_context,
+                   reinterpret_cast<const std::byte*>(seeded_ciphertext.data()),
+                   seeded_ciphertext.size());
+  output->set_seeded(std::move(seeded_ciphertext));
 }
 
 void decode(HEPlaintext& output, const SealPlaintextWrapper& input,
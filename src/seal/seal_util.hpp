@@ -74,6 +74,38 @@ inline seal::sec_level_type seal_security_level(size_t bits) {
 size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
                                      const HESealBackend& he_seal_backend);
 
+/// \brief Returns the parms_id at a given chain index
+/// \param[in] context SEAL context whose modulus switching chain to search
+/// \param[in] chain_index Chain index, at most that of the first parms_id
+/// \throws ngraph_error if there is no data level at chain_index
+seal::parms_id_type parms_id_at_chain_index(const seal::SEALContext& context,
+                                            size_t chain_index);
+
+/// \brief Returns the lowest chain index to which a ciphertext can be
+/// mod-switched while still decrypting correctly. The ciphertext keeps at
+/// least as many bits of headroom above its scale as the encryption
+/// parameters provide at chain index 0 for a ciphertext at the encoding scale
+/// \param[in] cipher Ciphertext to mod-switch
+/// \param[in] he_seal_backend Backend whose context and scale to use
+size_t lowest_decryptable_chain_index(const SealCiphertextWrapper& cipher,
+                                      const HESealBackend& he_seal_backend);
+
+/// \brief Returns a copy of the ciphertext mod-switched to the lowest chain
+/// index at which it still decrypts correctly, such that it can be sent with
+/// fewer primes. See lowest_decryptable_chain_index()
+/// \param[in] cipher Ciphertext to mod-switch
+/// \param[in] he_seal_backend Backend used to mod-switch the ciphertext
+std::shared_ptr<SealCiphertextWrapper> mod_switch_to_lowest_level(
+    const SealCiphertextWrapper& cipher, const HESealBackend& he_seal_backend);
+
+/// \brief Replaces each ciphertext with a copy mod-switched to the lowest
+/// chain index at which it still decrypts correctly. The replaced
+/// ciphertexts, which may be shared, are not modified
+/// \param[in,out] he_types Vector of HE data to mod-switch
+/// \param[in] he_seal_backend Backend used to mod-switch the ciphertexts
+void mod_switch_to_lowest_level(std::vector<HEType>& he_types,
+                                const HESealBackend& he_seal_backend);
+
 /// \brief Returns whether or not two cipher/plaintexts have a similar scale
 /// \param[in] arg0 Ciphertext or plaintext
 /// \param[in] arg1 Ciphertext or plaintext
@@ -198,14 +230,44 @@ inline void add_poly_scalar_coeffmod(const std::uint64_t* poly,
 /// \brief Multiplies a ciphertext with a scalar in every slot
 /// \param[in,out] encrypted Ciphertext to multply
 /// \param[in] value Multiplicand multiplied with the ciphertext
+/// \param[in] scale Scale at which to encode the multiplicand. The resulting
+/// ciphertext has scale encrypted.scale() * scale
 /// \param[in] he_seal_backend Backend whose context is used for encoding and
 /// multiplication
 /// \param[in] pool Memory pool used for new memory allocation
 void multiply_plain_inplace(
-    seal::Ciphertext& encrypted, double value,
+    seal::Ciphertext& encrypted, double value, double scale,
+    const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
+/// \brief Multiplies a ciphertext with an already encoded scalar in every slot
+/// \param[in,out] encrypted Ciphertext to multply
+/// \param[in] plaintext_vals Multiplicand in CRT form, as computed by encode()
+/// at the parms_id of the ciphertext
+/// \param[in] scale Scale at which the multiplicand was encoded
+/// \param[in] he_seal_backend Backend whose context is used for multiplication
+/// \param[in] pool Memory pool used for new memory allocation
+void multiply_plain_inplace(
+    seal::Ciphertext& encrypted,
+    const std::vector<std::uint64_t>& plaintext_vals, double scale,
     const HESealBackend& he_seal_backend,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
 
+/// \brief Multiplies a ciphertext with a scalar in every slot. The scalar is
+/// encoded at the scale of the ciphertext
+/// \param[in,out] encrypted Ciphertext to multply
+/// \param[in] value Multiplicand multiplied with the ciphertext
+/// \param[in] he_seal_backend Backend whose context is used for encoding and
+/// multiplication
+/// \param[in] pool Memory pool used for new memory allocation
+inline void multiply_plain_inplace(
+    seal::Ciphertext& encrypted, double value,
+    const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool()) {
+  multiply_plain_inplace(encrypted, value, encrypted.scale(), he_seal_backend,
+                         pool);
+}
+
 /// \brief Multiplies a ciphertext with a scalar in every slot
 /// \param[in] encrypted Ciphertext to multply
 /// \param[in] value Value to multiply the ciphertext by
@@ -259,11 +321,15 @@ void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
 /// \param[in] encryptor Used for encrypting
 /// \param[in] complex_packing Whether or not to use complex packing during
 /// encoding
-void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
-             const HEPlaintext& input, seal::parms_id_type parms_id,
-             const ngraph::element::Type& element_type, double scale,
-             seal::CKKSEncoder& ckks_encoder, const seal::Encryptor& encryptor,
-             bool complex_packing);
+/// \param[in] seeded_context If not nullptr, the plaintext is encrypted with
+/// the encryptor's secret key, and output stores the seeded serialization for
+/// sending. The context is used to expand the seeded ciphertext
+void encrypt(
+    std::shared_ptr<SealCiphertextWrapper>& output, const HEPlaintext& input,
+    seal::parms_id_type parms_id, const ngraph::element::Type& element_type,
+    double scale, seal::CKKSEncoder& ckks_encoder,
+    const seal::Encryptor& encryptor, bool complex_packing,
+    const std::shared_ptr<seal::SEALContext>& seeded_context = nullptr);
 
 /// \brief Decode SEAL plaintext into plaintext values
 /// \param[out] output Decoded values
@@ -0,0 +1,299 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "task_runtime.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+namespace ngraph::he {
+
+namespace {
+thread_local size_t t_thread_budget = 0;
+}  // namespace
+
+struct TaskRuntime::Job {
+  /// \brief Iterations not yet run by one participating thread
+  struct Range {
+    std::mutex mutex;
+    size_t begin{0};
+    size_t end{0};
+  };
+
+  Job(const RangeFunction& function, size_t begin, size_t end,
+      size_t chunk_grain, size_t job_slot_count, size_t job_thread_budget)
+      : range_function(function),
+        grain(chunk_grain),
+        slot_count(job_slot_count),
+        thread_budget(job_thread_budget),
+        ranges(job_slot_count),
+        pending(end - begin) {
+    // Split the iterations evenly, on chunk boundaries
+    size_t chunk_count = (end - begin + grain - 1) / grain;
+    for (size_t slot = 0; slot < slot_count; ++slot) {
+      ranges[slot].begin =
+          std::min(end, begin + chunk_count * slot / slot_count * grain);
+      ranges[slot].end =
+          std::min(end, begin + chunk_count * (slot + 1) / slot_count * grain);
+    }
+  }
+
+  /// \brief Takes the next chunk of the given slot, stealing from other slots
+  /// once the slot's range is empty. Returns false once all iterations have
+  /// been taken
+  bool next_chunk(size_t slot, size_t& chunk_begin, size_t& chunk_end) {
+    Range& own = ranges[slot];
+    {
+      std::lock_guard<std::mutex> guard(own.mutex);
+      if (own.begin < own.end) {
+        chunk_begin = own.begin;
+        chunk_end = std::min(own.end, own.begin + grain);
+        own.begin = chunk_end;
+        return true;
+      }
+    }
+
+    while (true) {
+      // Steal from the slot with the most remaining iterations
+      size_t victim = slot_count;
+      size_t most_remaining = 0;
+      for (size_t other = 0; other < slot_count; ++other) {
+        if (other == slot) {
+          continue;
+        }
+        std::lock_guard<std::mutex> guard(ranges[other].mutex);
+        size_t remaining = ranges[other].end - ranges[other].begin;
+        if (remaining > most_remaining) {
+          most_remaining = remaining;
+          victim = other;
+        }
+      }
+      if (victim == slot_count) {
+        return false;
+      }
+
+      size_t stolen_begin;
+      size_t stolen_end;
+      {
+        std::lock_guard<std::mutex> guard(ranges[victim].mutex);
+        size_t remaining = ranges[victim].end - ranges[victim].begin;
+        if (remaining == 0) {
+          continue;
+        }
+        // Take the back half, leaving the victim's next chunk in place
+        size_t stolen = remaining > grain ? remaining / 2 : remaining;
+        stolen_end = ranges[victim].end;
+        stolen_begin = stolen_end - stolen;
+        ranges[victim].end = stolen_begin;
+      }
+
+      std::lock_guard<std::mutex> guard(own.mutex);
+      chunk_begin = stolen_begin;
+      chunk_end = std::min(stolen_end, stolen_begin + grain);
+      own.begin = chunk_end;
+      own.end = stolen_end;
+      return true;
+    }
+  }
+
+  /// \brief Runs chunks until all iterations have been taken
+  void participate(size_t slot) {
+    ThreadBudgetScope budget_scope(thread_budget);
+    size_t chunk_begin;
+    size_t chunk_end;
+    while (next_chunk(slot, chunk_begin, chunk_end)) {
+      if (!failed) {
+        try {
+          range_function(chunk_begin, chunk_end);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          failed = true;
+        }
+      }
+      size_t chunk_size = chunk_end - chunk_begin;
+      if (pending.fetch_sub(chunk_size) == chunk_size) {
+        std::lock_guard<std::mutex> guard(mutex);
+        done_cond.notify_all();
+      }
+    }
+  }
+
+  const RangeFunction& range_function;
+  const size_t grain;
+  const size_t slot_count;
+  const size_t thread_budget;
+  // Guarded by the runtime mutex. Slot 0 belongs to the calling thread
+  size_t next_slot{1};
+  std::vector<Range> ranges;
+
+  std::atomic<size_t> pending;
+  std::atomic<bool> failed{false};
+  std::mutex mutex;
+  std::condition_variable done_cond;
+  std::exception_ptr error;
+};
+
+TaskRuntime::TaskRuntime(size_t thread_count) {
+  size_t worker_count = thread_count > 1 ? thread_count - 1 : 0;
+  m_workers.reserve(worker_count);
+  for (size_t thread_idx = 0; thread_idx < worker_count; ++thread_idx) {
+    m_workers.emplace_back([this]() { work(); });
+  }
+}
+
+TaskRuntime::~TaskRuntime() {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stop = true;
+  }
+  m_job_cond.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+TaskRuntime& TaskRuntime::global() {
+  static TaskRuntime runtime;
+  return runtime;
+}
+
+size_t TaskRuntime::default_thread_count() {
+  const char* thread_count = std::getenv("OMP_NUM_THREADS");
+  if (thread_count != nullptr) {
+    return std::max(std::stoul(thread_count), 1UL);
+  }
+  return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+size_t TaskRuntime::default_grain(size_t iteration_count) const {
+  constexpr size_t chunks_per_thread = 4;
+  size_t thread_count = thread_budget();
+  if (thread_count == 0 || thread_count > this->thread_count()) {
+    thread_count = this->thread_count();
+  }
+  return std::max(iteration_count / (chunks_per_thread * thread_count), 1UL);
+}
+
+size_t TaskRuntime::thread_budget() { return t_thread_budget; }
+
+TaskRuntime::ThreadBudgetScope::ThreadBudgetScope(size_t thread_budget)
+    : m_previous_budget(t_thread_budget) {
+  t_thread_budget = thread_budget;
+}
+
+TaskRuntime::ThreadBudgetScope::~ThreadBudgetScope() {
+  t_thread_budget = m_previous_budget;
+}
+
+void TaskRuntime::parallel_for(size_t begin, size_t end,
+                               const RangeFunction& range_function,
+                               size_t grain, size_t max_threads) {
+  if (begin >= end) {
+    return;
+  }
+  grain = std::max(grain, 1UL);
+  if (max_threads == 0) {
+    max_threads = thread_budget();
+  }
+  if (max_threads == 0) {
+    max_threads = thread_count();
+  }
+  size_t chunk_count = (end - begin + grain - 1) / grain;
+  size_t slot_count = std::min({max_threads, thread_count(), chunk_count});
+
+  if (slot_count <= 1) {
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain) {
+      range_function(chunk_begin, std::min(end, chunk_begin + grain));
+    }
+    return;
+  }
+
+  auto job = std::make_shared<Job>(range_function, begin, end, grain,
+                                   slot_count, max_threads);
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_jobs.emplace_back(job);
+  }
+  m_job_cond.notify_all();
+
+  job->participate(0);
+
+  // Busy workers may never claim the remaining slots, whose iterations have
+  // been stolen by now
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+    if (it != m_jobs.end()) {
+      m_jobs.erase(it);
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done_cond.wait(lock, [&]() { return job->pending == 0; });
+  }
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+
+void TaskRuntime::post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_tasks.emplace_back(std::move(task));
+  }
+  m_job_cond.notify_one();
+}
+
+void TaskRuntime::work() {
+  while (true) {
+    std::shared_ptr<Job> job;
+    size_t slot = 0;
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_job_cond.wait(lock, [this]() {
+        return m_stop || !m_jobs.empty() || !m_tasks.empty();
+      });
+      if (m_stop) {
+        return;
+      }
+      // Loops are awaited by their calling threads, so run before tasks
+      if (m_jobs.empty()) {
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      } else {
+        job = m_jobs.front();
+        slot = job->next_slot++;
+        if (job->next_slot == job->slot_count) {
+          m_jobs.pop_front();
+        }
+      }
+    }
+    if (task) {
+      task();
+    } else {
+      job->participate(slot);
+    }
+  }
+}
+
+}  // namespace ngraph::he
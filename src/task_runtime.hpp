@@ -0,0 +1,183 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ngraph::he {
+/// \brief Pool of worker threads running data-parallel loops.
+///
+/// A loop's iterations are split into one range per participating thread.
+/// Each thread runs chunks of grain iterations from the front of its range,
+/// and once its range is empty, steals the back half of the largest remaining
+/// range. Uneven iterations are thereby balanced across threads. The calling
+/// thread always participates in its own loop, so loops may be nested, and
+/// complete even if every worker is busy. Workers without a loop to join run
+/// posted tasks.
+class TaskRuntime {
+ public:
+  /// \brief Function running the iterations [range_begin, range_end)
+  using RangeFunction = std::function<void(size_t, size_t)>;
+
+  /// \brief Constructs a runtime
+  /// \param[in] thread_count Number of threads running loops, including the
+  /// calling thread. At least 1
+  explicit TaskRuntime(size_t thread_count = default_thread_count());
+
+  TaskRuntime(const TaskRuntime&) = delete;
+  TaskRuntime& operator=(const TaskRuntime&) = delete;
+
+  ~TaskRuntime();
+
+  /// \brief Returns the runtime shared by all executables in the process
+  static TaskRuntime& global();
+
+  /// \brief Returns the number of threads specified by the OMP_NUM_THREADS
+  /// environment variable, or the number of hardware threads if not set
+  static size_t default_thread_count();
+
+  /// \brief Returns the number of threads running loops, including the
+  /// calling thread
+  size_t thread_count() const { return m_workers.size() + 1; }
+
+  /// \brief Returns a grain which splits a loop into a few chunks per thread
+  /// available to the calling thread. Kernels sharing scratch space across a
+  /// chunk use this to amortize the scratch space, while leaving enough chunks
+  /// to balance load
+  /// \param[in] iteration_count Number of iterations in the loop
+  size_t default_grain(size_t iteration_count) const;
+
+  /// \brief Runs a loop, returning once every iteration has run. If an
+  /// iteration throws, remaining chunks are skipped, and the first exception
+  /// is rethrown
+  /// \param[in] begin First iteration
+  /// \param[in] end One past the last iteration
+  /// \param[in] range_function Function run on chunks of iterations
+  /// \param[in] grain Maximum number of iterations per chunk
+  /// \param[in] max_threads Maximum number of threads running the loop. If 0,
+  /// the thread budget of the calling thread is used
+  void parallel_for(size_t begin, size_t end,
+                    const RangeFunction& range_function, size_t grain = 1,
+                    size_t max_threads = 0);
+
+  /// \brief Runs a task on the next worker without a loop to join, and
+  /// returns without waiting for it. Tasks not yet started when the runtime
+  /// is destroyed are dropped, and a runtime without workers never runs them,
+  /// so callers must not wait on a posted task they could not run themselves
+  /// \param[in] task Task to run. Must not throw
+  void post(std::function<void()> task);
+
+  /// \brief Returns the maximum number of threads running loops started by
+  /// the calling thread. 0 means all threads of the runtime
+  static size_t thread_budget();
+
+  /// \brief Limits the number of threads running loops started by the calling
+  /// thread, until the scope is destroyed
+  class ThreadBudgetScope {
+   public:
+    /// \brief Sets the thread budget of the calling thread
+    /// \param[in] thread_budget Maximum number of threads. 0 means all
+    explicit ThreadBudgetScope(size_t thread_budget);
+
+    ThreadBudgetScope(const ThreadBudgetScope&) = delete;
+    ThreadBudgetScope& operator=(const ThreadBudgetScope&) = delete;
+
+    ~ThreadBudgetScope();
+
+   private:
+    size_t m_previous_budget;
+  };
+
+ private:
+  struct Job;
+
+  void work();
+
+  std::mutex m_mutex;
+  std::condition_variable m_job_cond;
+  std::deque<std::shared_ptr<Job>> m_jobs;
+  std::deque<std::function<void()>> m_tasks;
+  bool m_stop{false};
+  std::vector<std::thread> m_workers;
+};
+
+/// \brief Runs function(i) for each i in [begin, end) on the global runtime
+/// \param[in] begin First iteration
+/// \param[in] end One past the last iteration
+/// \param[in] function Function run on each iteration
+/// \param[in] grain Maximum number of iterations per chunk
+template <typename Function>
+void parallel_for(size_t begin, size_t end, Function&& function,
+                  size_t grain = 1) {
+  TaskRuntime::global().parallel_for(
+      begin, end,
+      [&function](size_t range_begin, size_t range_end) {
+        for (size_t i = range_begin; i < range_end; ++i) {
+          function(i);
+        }
+      },
+      grain);
+}
+
+/// \brief Runs function(range_begin, range_end) on chunks of [begin, end) on
+/// the global runtime. Useful to share scratch space across a chunk
+/// \param[in] begin First iteration
+/// \param[in] end One past the last iteration
+/// \param[in] range_function Function run on each chunk
+/// \param[in] grain Maximum number of iterations per chunk
+template <typename RangeFunction>
+void parallel_for_ranges(size_t begin, size_t end,
+                         RangeFunction&& range_function, size_t grain = 1) {
+  TaskRuntime::global().parallel_for(begin, end, range_function, grain);
+}
+
+/// \brief Reduces [begin, end) on the global runtime. Each chunk is reduced
+/// by range_function, and the chunk results are combined in an unspecified
+/// order, so combine should be associative and commutative
+/// \param[in] begin First iteration
+/// \param[in] end One past the last iteration
+/// \param[in] identity Identity of combine
+/// \param[in] range_function Function returning the reduction of a chunk,
+/// given range_begin, range_end and identity
+/// \param[in] combine Function combining two partial reductions
+/// \param[in] grain Maximum number of iterations per chunk
+template <typename T, typename RangeFunction, typename Combine>
+T parallel_reduce(size_t begin, size_t end, const T& identity,
+                  RangeFunction&& range_function, Combine&& combine,
+                  size_t grain = 1) {
+  std::mutex result_mutex;
+  T result = identity;
+  TaskRuntime::global().parallel_for(
+      begin, end,
+      [&](size_t range_begin, size_t range_end) {
+        T partial = range_function(range_begin, range_end, identity);
+        std::lock_guard<std::mutex> guard(result_mutex);
+        result = combine(std::move(result), std::move(partial));
+      },
+      grain);
+  return result;
+}
+
+}  // namespace ngraph::he
@@ -26,6 +26,7 @@
 
 #include "logging/ngraph_he_log.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_decoder.hpp"
 
 namespace ngraph::he {
 /// \brief Class representing a Client over a TCP connection
@@ -37,32 +38,47 @@ class TCPClient {
   /// \brief Connects client to hostname:port and reads message
   /// \param[in] io_context Boost context for I/O functionality
   /// \param[in] endpoints Socket to connect to
-  /// \param[in] message_handler Function to handle responses from the server
+  /// \param[in] message_handler Function to handle responses from the server.
+  /// Called from a decoder thread, in the order in which messages are received
   TCPClient(boost::asio::io_context& io_context,
             const boost::asio::ip::tcp::resolver::results_type& endpoints,
             std::function<void(const TCPMessage&)> message_handler)
       : m_io_context(io_context),
         m_socket(io_context),
         m_first_connect(true),
-        m_message_callback(std::bind(message_handler, std::placeholders::_1)) {
+        m_decoder(std::move(message_handler)) {
+    m_decoder.set_error_handler([this](const std::string&) { close(); });
     do_connect(endpoints);
   }
 
+  /// \brief Sets the SEAL context used to receive ciphertexts
+  /// \param[in] context SEAL context
+  void set_context(const std::shared_ptr<seal::SEALContext>& context) {
+    m_decoder.set_context(context);
+    boost::asio::post(m_io_context, [this, context]() { m_context = context; });
+  }
+
   /// \brief Closes the socket
   void close() {
     NGRAPH_HE_LOG(1) << "Closing socket";
-    m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
-    boost::asio::post(m_io_context, [this]() { m_socket.close(); });
+    boost::asio::post(m_io_context, [this]() {
+      m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
+      m_socket.close();
+    });
   }
 
-  /// \brief Asynchronously writes the message
+  /// \brief Asynchronously writes the message. Since messages are handled
+  /// off the I/O thread, the message is queued on the I/O thread
   /// \param[in,out] message Message to write
-  void write_message(const TCPMessage&& message) {
-    bool write_in_progress = !m_message_queue.empty();
-    m_message_queue.push_back(std::move(message));
-    if (!write_in_progress) {
-      boost::asio::post(m_io_context, [this]() { do_write(); });
-    }
+  void write_message(TCPMessage&& message) {
+    boost::asio::post(m_io_context,
+                      [this, message = std::move(message)]() mutable {
+                        bool write_in_progress = !m_message_queue.empty();
+                        m_message_queue.push_back(std::move(message));
+                        if (!write_in_progress) {
+                          do_write();
+                        }
+                      });
   }
 
  private:
@@ -116,9 +132,15 @@ class TCPClient {
         boost::asio::buffer(&m_read_buffer[header_length], body_length),
         [this](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
-            m_read_message.unpack(m_read_buffer);
-            m_message_callback(m_read_message);
-            do_read_header();
+            if (TCPMessage::decode_has_ciphertexts(m_read_buffer)) {
+              // Ciphertext metadata is needed to read attached ciphertexts
+              m_read_message.unpack(m_read_buffer);
+              do_read_ciphertexts();
+            } else {
+              // Unpacking is left to the decoder
+              m_decoder.push(std::move(m_read_buffer));
+              do_read_header();
+            }
           } else {
             if (ec.message() != s_expected_teardown_message.c_str()) {
               NGRAPH_ERR << "Client error reading body: " << ec.message();
@@ -127,14 +149,31 @@ class TCPClient {
         });
   }
 
+  void do_read_ciphertexts() {
+    boost::asio::async_read(
+        m_socket, m_read_message.allocate_ciphertexts(m_context),
+        [this](boost::system::error_code ec, std::size_t length) {
+          if (!ec) {
+            m_decoder.push(std::move(m_read_message));
+            do_read_header();
+          } else {
+            if (ec.message() != s_expected_teardown_message.c_str()) {
+              NGRAPH_ERR << "Client error reading ciphertexts: "
+                         << ec.message();
+            }
+          }
+        });
+  }
+
   void do_write() {
     auto message = m_message_queue.front();
     message.pack(m_write_buffer);
     NGRAPH_HE_LOG(4) << "Client writing message size " << m_write_buffer.size()
                      << " bytes";
 
+    // Attached ciphertexts are written directly from ciphertext storage
     boost::asio::async_write(
-        m_socket, boost::asio::buffer(m_write_buffer),
+        m_socket, message.write_buffers(m_write_buffer),
         [this](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
             m_message_queue.pop_front();
@@ -149,6 +188,7 @@ class TCPClient {
 
   boost::asio::io_context& m_io_context;
   boost::asio::ip::tcp::socket m_socket;
+  std::shared_ptr<seal::SEALContext> m_context;
 
   data_buffer m_read_buffer;
   data_buffer m_write_buffer;
@@ -158,6 +198,7 @@ class TCPClient {
   inline static std::string s_expected_teardown_message{"End of file"};
 
   bool m_first_connect;
-  std::function<void(const TCPMessage&)> m_message_callback;
+  // Declared last, so that decoding stops before other members are destroyed
+  TCPMessageDecoder m_decoder;
 };
 }  // namespace ngraph::he
@@ -16,23 +16,40 @@
 
 #pragma once
 
+#include <boost/asio.hpp>
 #include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ngraph/check.hpp"
 #include "ngraph/log.hpp"
 #include "ngraph/util.hpp"
 #include "protos/message.pb.h"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
 
 namespace ngraph::he {
 /// \brief Represents a message. A wrapper around pb::TCPMessage
+///
+/// On the wire, a message consists of a header storing the length of the
+/// serialized protobuf message, followed by the protobuf message. Ciphertexts
+/// may also be attached to a message. Attached ciphertexts are described by
+/// the message's ciphertext headers, and their polynomial data is sent
+/// directly from, and received directly into, seal::Ciphertext storage after
+/// the protobuf message. The highest bit of the header indicates whether or
+/// not ciphertexts are attached.
 class TCPMessage {
  public:
   enum { header_length = sizeof(size_t) };
   using data_buffer = std::vector<char>;
+  using ciphertext_list = std::vector<std::shared_ptr<SealCiphertextWrapper>>;
+
+  /// \brief Header bit set if ciphertexts are attached to the message
+  static constexpr size_t ciphertexts_flag = size_t{1}
+                                             << (8 * header_length - 1);
 
   /// \brief Creates empty message
   TCPMessage() = default;
@@ -50,6 +67,22 @@ class TCPMessage {
   explicit TCPMessage(std::shared_ptr<pb::TCPMessage> proto_message)
       : m_proto_message(std::move(proto_message)) {}
 
+  /// \brief Creates message from given protobuf message with attached
+  /// ciphertexts. The ciphertexts must not be modified until the message is
+  /// written.
+  /// \param[in,out] proto_message Protobuf message to populate TCPMessage
+  /// \param[in] ciphertexts Ciphertexts to attach, referenced by the
+  /// attachment_index of the message's HETypes
+  TCPMessage(pb::TCPMessage&& proto_message, ciphertext_list ciphertexts)
+      : m_proto_message(
+            std::make_shared<pb::TCPMessage>(std::move(proto_message))),
+        m_ciphertexts(std::move(ciphertexts)) {
+    m_proto_message->clear_ciphertext_headers();
+    for (const auto& cipher : m_ciphertexts) {
+      cipher->save_header(*m_proto_message->add_ciphertext_headers());
+    }
+  }
+
   /// \brief Returns pointer to udnerlying protobuf message
   std::shared_ptr<pb::TCPMessage> proto_message() { return m_proto_message; }
 
@@ -58,14 +91,36 @@ class TCPMessage {
     return m_proto_message;
   }
 
+  /// \brief Returns the attached ciphertexts
+  const ciphertext_list& ciphertexts() const { return m_ciphertexts; }
+
   /// \brief Stores a size in the buffer header
   /// \param[in,out] buffer Buffer to write size to
   /// \param[in] size Size to write into buffer
-  static void encode_header(data_buffer& buffer, size_t size) {
+  /// \param[in] has_ciphertexts Whether or not ciphertexts are attached
+  static void encode_header(data_buffer& buffer, size_t size,
+                            bool has_ciphertexts = false) {
     NGRAPH_CHECK(buffer.size() >= header_length, "Buffer too small");
+    NGRAPH_CHECK((size & ciphertexts_flag) == 0, "Message size ", size,
+                 " too large");
+    if (has_ciphertexts) {
+      size |= ciphertexts_flag;
+    }
     std::memcpy(&buffer[0], &size, header_length);
   }
 
+  /// \brief Given a buffer storing a message header, returns whether or not
+  /// ciphertexts are attached to the message
+  /// \param[in] buffer Buffer storing a message
+  static bool decode_has_ciphertexts(const data_buffer& buffer) {
+    if (buffer.size() < header_length) {
+      return false;
+    }
+    size_t header = 0;
+    std::memcpy(&header, &buffer[0], header_length);
+    return (header & ciphertexts_flag) != 0;
+  }
+
   /// \brief Given a buffer storing a message with the length in the first
   /// header_length bytes, returns the size of the stored buffer \param[in]
   /// buffer Buffer storing a message \returns size of message stored in buffer
@@ -75,7 +130,7 @@ class TCPMessage {
     }
     size_t body_length = 0;
     std::memcpy(&body_length, &buffer[0], header_length);
-    return body_length;
+    return body_length & ~ciphertexts_flag;
   }
 
   /// \brief Writes the message to a buffer
@@ -86,10 +141,25 @@ class TCPMessage {
     NGRAPH_CHECK(m_proto_message != nullptr, "Can't pack empty proto message");
     size_t msg_size = m_proto_message->ByteSize();
     buffer.resize(header_length + msg_size);
-    encode_header(buffer, msg_size);
+    encode_header(buffer, msg_size, !m_ciphertexts.empty());
     return m_proto_message->SerializeToArray(&buffer[header_length], msg_size);
   }
 
+  /// \brief Returns the buffers to write to send the message: the packed
+  /// buffer, followed by the data of each attached ciphertext
+  /// \param[in] buffer Buffer storing the packed message
+  std::vector<boost::asio::const_buffer> write_buffers(
+      const data_buffer& buffer) const {
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(1 + m_ciphertexts.size());
+    buffers.emplace_back(boost::asio::buffer(buffer));
+    for (const auto& cipher : m_ciphertexts) {
+      buffers.emplace_back(boost::asio::buffer(cipher->ciphertext().data(),
+                                               cipher->data_size()));
+    }
+    return buffers;
+  }
+
   /// \brief Writes a given buffer to the message
   /// \param[in] buffer Buffer to read the message from
   /// \returns Whether or not the operation was successful
@@ -97,11 +167,86 @@ class TCPMessage {
     if (!m_proto_message) {
       m_proto_message = std::make_shared<pb::TCPMessage>();
     }
+    m_ciphertexts.clear();
     return m_proto_message->ParseFromArray(&buffer[header_length],
                                            buffer.size() - header_length);
   }
 
+  /// \brief Allocates the ciphertexts described by the unpacked message's
+  /// ciphertext headers
+  /// \param[in] context SEAL context to allocate the ciphertexts with
+  /// \returns Buffers into which to read the ciphertext data
+  std::vector<boost::asio::mutable_buffer> allocate_ciphertexts(
+      const std::shared_ptr<seal::SEALContext>& context) {
+    NGRAPH_CHECK(m_proto_message != nullptr,
+                 "Can't allocate ciphertexts for empty proto message");
+    NGRAPH_CHECK(context != nullptr,
+                 "Can't receive attached ciphertexts without SEAL context");
+    size_t cipher_count = m_proto_message->ciphertext_headers_size();
+    m_ciphertexts.resize(cipher_count);
+    std::vector<boost::asio::mutable_buffer> buffers;
+    buffers.reserve(cipher_count);
+    for (size_t cipher_idx = 0; cipher_idx < cipher_count; ++cipher_idx) {
+      m_ciphertexts[cipher_idx] = std::make_shared<SealCiphertextWrapper>();
+      SealCiphertextWrapper& cipher = *m_ciphertexts[cipher_idx];
+      SealCiphertextWrapper::allocate(
+          cipher, m_proto_message->ciphertext_headers(cipher_idx), context);
+      buffers.emplace_back(
+          boost::asio::buffer(cipher.ciphertext().data(), cipher.data_size()));
+    }
+    return buffers;
+  }
+
+  /// \brief Loads the ciphertexts serialized in the message's tensors, and
+  /// attaches them to the message, such that message handlers need not
+  /// deserialize them. Ciphertexts already attached are validated.
+  /// \param[in] context SEAL context to load the ciphertexts with
+  void decode_ciphertexts(const std::shared_ptr<seal::SEALContext>& context) {
+    NGRAPH_CHECK(m_proto_message != nullptr,
+                 "Can't decode ciphertexts of empty proto message");
+    std::vector<pb::HEType*> serialized;
+    for (auto& proto_tensor : *m_proto_message->mutable_he_tensors()) {
+      for (auto& proto_he_type : *proto_tensor.mutable_data()) {
+        if (!proto_he_type.is_plaintext() && !proto_he_type.is_attached()) {
+          serialized.emplace_back(&proto_he_type);
+        }
+      }
+    }
+    if (serialized.empty() && m_ciphertexts.empty()) {
+      return;
+    }
+    NGRAPH_CHECK(context != nullptr,
+                 "Can't decode ciphertexts without SEAL context");
+    validate_ciphertexts(context);
+
+    size_t first_index = m_ciphertexts.size();
+    m_ciphertexts.resize(first_index + serialized.size());
+#pragma omp parallel for
+    for (size_t cipher_idx = 0; cipher_idx < serialized.size(); ++cipher_idx) {
+      pb::HEType& proto_he_type = *serialized[cipher_idx];
+      auto cipher = std::make_shared<SealCiphertextWrapper>();
+      SealCiphertextWrapper::load(*cipher, proto_he_type, context);
+      m_ciphertexts[first_index + cipher_idx] = cipher;
+
+      proto_he_type.clear_ciphertext();
+      proto_he_type.set_is_attached(true);
+      proto_he_type.set_attachment_index(first_index + cipher_idx);
+    }
+  }
+
+  /// \brief Checks the received ciphertexts are valid for a context
+  /// \param[in] context SEAL context to validate the ciphertexts against
+  /// \throws ngraph_error if a ciphertext is invalid
+  void validate_ciphertexts(
+      const std::shared_ptr<seal::SEALContext>& context) const {
+    for (const auto& cipher : m_ciphertexts) {
+      NGRAPH_CHECK(seal::is_valid_for(cipher->ciphertext(), context),
+                   "Received ciphertext is not valid for context");
+    }
+  }
+
  private:
   std::shared_ptr<pb::TCPMessage> m_proto_message;
+  ciphertext_list m_ciphertexts;
 };
 }  // namespace ngraph::he
@@ -0,0 +1,249 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/log.hpp"
+#include "seal/seal.h"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::he {
+/// \brief Decodes received messages on a bounded pool of worker threads.
+///
+/// Decoding a message parses the protobuf message and loads its serialized
+/// ciphertexts, which are then attached to the message. Messages are decoded
+/// concurrently, but are passed to the message handler one at a time, in the
+/// order in which they were received. This lets the I/O thread keep reading
+/// from the socket while earlier messages are decoded.
+class TCPMessageDecoder {
+ public:
+  using data_buffer = TCPMessage::data_buffer;
+
+  /// \brief Constructs a decoder
+  /// \param[in] message_handler Function to handle decoded messages
+  /// \param[in] context SEAL context used to load ciphertexts
+  /// \param[in] thread_count Number of worker threads. If 0, messages are
+  /// decoded and handled on the calling thread
+  /// \param[in] max_pending Maximum number of received messages which have not
+  /// yet been handled. push blocks while this many messages are pending
+  TCPMessageDecoder(std::function<void(const TCPMessage&)> message_handler,
+                    std::shared_ptr<seal::SEALContext> context = nullptr,
+                    size_t thread_count = default_thread_count(),
+                    size_t max_pending = 0)
+      : m_message_handler(std::move(message_handler)),
+        m_context(std::move(context)),
+        m_max_pending(max_pending == 0 ? 2 * thread_count : max_pending) {
+    m_workers.reserve(thread_count);
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      m_workers.emplace_back([this]() { work(); });
+    }
+  }
+
+  TCPMessageDecoder(const TCPMessageDecoder&) = delete;
+  TCPMessageDecoder& operator=(const TCPMessageDecoder&) = delete;
+
+  ~TCPMessageDecoder() {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stop = true;
+    }
+    m_job_cond.notify_all();
+    for (auto& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  /// \brief Returns the number of worker threads specified by the
+  /// MESSAGE_DECODE_THREADS environment variable, or 2 if not set
+  static size_t default_thread_count() {
+    const char* thread_count = std::getenv("MESSAGE_DECODE_THREADS");
+    if (thread_count == nullptr) {
+      return 2;
+    }
+    return std::stoul(thread_count);
+  }
+
+  /// \brief Sets the function called when a message fails to decode or to be
+  /// handled. Messages received after a failure are dropped
+  /// \param[in] error_handler Function called with the error message
+  void set_error_handler(
+      std::function<void(const std::string&)> error_handler) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_error_handler = std::move(error_handler);
+  }
+
+  /// \brief Sets the SEAL context used to load ciphertexts
+  /// \param[in] context SEAL context
+  void set_context(std::shared_ptr<seal::SEALContext> context) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_context = std::move(context);
+  }
+
+  /// \brief Enqueues a received message which has not yet been unpacked
+  /// \param[in,out] buffer Buffer storing the packed message
+  void push(data_buffer&& buffer) {
+    Job job;
+    job.buffer = std::move(buffer);
+    job.packed = true;
+    push(std::move(job));
+  }
+
+  /// \brief Enqueues a received message which has been unpacked
+  /// \param[in,out] message Unpacked message
+  void push(TCPMessage&& message) {
+    Job job;
+    job.message = std::move(message);
+    job.packed = false;
+    push(std::move(job));
+  }
+
+ private:
+  struct Job {
+    size_t sequence{0};
+    bool packed{false};
+    data_buffer buffer;
+    TCPMessage message;
+  };
+
+  void push(Job&& job) {
+    if (m_workers.empty()) {
+      std::string error = decode(job);
+      deliver(job, std::move(error));
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_space_cond.wait(lock, [this]() {
+        return m_next_sequence - m_next_delivery < m_max_pending;
+      });
+      job.sequence = m_next_sequence++;
+      m_jobs.emplace_back(std::move(job));
+    }
+    m_job_cond.notify_one();
+  }
+
+  /// \brief Decodes a message, returning the error message if this fails
+  std::string decode(Job& job) {
+    try {
+      if (job.packed) {
+        NGRAPH_CHECK(job.message.unpack(job.buffer), "Error unpacking message");
+        job.buffer = data_buffer();
+      }
+      std::shared_ptr<seal::SEALContext> context;
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        context = m_context;
+      }
+      job.message.decode_ciphertexts(context);
+    } catch (const std::exception& e) {
+      return std::string("Error decoding message: ") + e.what();
+    }
+    return std::string();
+  }
+
+  /// \brief Passes a decoded message to the message handler, unless decoding
+  /// or an earlier message failed. Failures are reported to the error handler
+  /// rather than thrown, since they would otherwise terminate the worker
+  void deliver(const Job& job, std::string error) {
+    if (m_failed) {
+      return;
+    }
+    if (error.empty()) {
+      try {
+        m_message_handler(job.message);
+      } catch (const std::exception& e) {
+        error = std::string("Error handling message: ") + e.what();
+      }
+    }
+    if (error.empty()) {
+      return;
+    }
+    NGRAPH_ERR << error;
+    m_failed = true;
+    std::function<void(const std::string&)> error_handler;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      error_handler = m_error_handler;
+    }
+    if (error_handler) {
+      error_handler(error);
+    }
+  }
+
+  void work() {
+    while (true) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job_cond.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+          return;
+        }
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+
+      std::string error = decode(job);
+
+      // Hand off messages in the order they were received
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_delivery_cond.wait(
+            lock, [&]() { return m_next_delivery == job.sequence; });
+      }
+      // Later messages are released even if this one fails
+      deliver(job, std::move(error));
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_next_delivery;
+      }
+      m_delivery_cond.notify_all();
+      m_space_cond.notify_all();
+    }
+  }
+
+  std::function<void(const TCPMessage&)> m_message_handler;
+  std::function<void(const std::string&)> m_error_handler;
+  std::shared_ptr<seal::SEALContext> m_context;
+  size_t m_max_pending;
+
+  std::mutex m_mutex;
+  std::condition_variable m_job_cond;
+  std::condition_variable m_delivery_cond;
+  std::condition_variable m_space_cond;
+  std::deque<Job> m_jobs;
+  size_t m_next_sequence{0};
+  size_t m_next_delivery{0};
+  bool m_stop{false};
+  // Only accessed by the thread delivering the next message
+  bool m_failed{false};
+
+  std::vector<std::thread> m_workers;
+};
+}  // namespace ngraph::he
@@ -16,14 +16,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/asio.hpp>
+#include <condition_variable>
 #include <deque>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #include "logging/ngraph_he_log.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_decoder.hpp"
 
 namespace ngraph::he {
 /// \brief Class representing a session over TCP
@@ -33,10 +38,18 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
 
  public:
   /// \brief Constructs a session with a given message handler
+  /// \param[in] socket Socket of the session
+  /// \param[in] message_handler Function to handle received messages. Called
+  /// from a decoder thread, in the order in which messages are received
+  /// \param[in] context SEAL context used to receive attached ciphertexts
   TCPSession(boost::asio::ip::tcp::socket socket,
-             std::function<void(const TCPMessage&)> message_handler)
+             std::function<void(const TCPMessage&)> message_handler,
+             std::shared_ptr<seal::SEALContext> context = nullptr)
       : m_socket(std::move(socket)),
-        m_message_callback(std::bind(message_handler, std::placeholders::_1)) {}
+        m_context(std::move(context)),
+        m_decoder(std::move(message_handler), m_context) {
+    m_decoder.set_error_handler([this](const std::string&) { close(); });
+  }
 
   /// \brief Start the session
   void start() { do_read_header(); }
@@ -72,9 +85,15 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
         boost::asio::buffer(&m_read_buffer[header_length], body_length),
         [this, self](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
-            m_read_message.unpack(m_read_buffer);
-            m_message_callback(m_read_message);
-            do_read_header();
+            if (TCPMessage::decode_has_ciphertexts(m_read_buffer)) {
+              // Ciphertext metadata is needed to read attached ciphertexts
+              m_read_message.unpack(m_read_buffer);
+              do_read_ciphertexts();
+            } else {
+              // Unpacking is left to the decoder
+              m_decoder.push(std::move(m_read_buffer));
+              do_read_header();
+            }
           } else {
             NGRAPH_ERR << "Server error reading message: " << ec.message();
             throw std::runtime_error("Server error reading message");
@@ -82,45 +101,113 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
         });
   }
 
-  /// \brief Adds a message to the message-writing queue
+  /// \brief Reads the ciphertexts attached to the last read message directly
+  /// into ciphertext storage
+  void do_read_ciphertexts() {
+    auto self(shared_from_this());
+    boost::asio::async_read(
+        m_socket, m_read_message.allocate_ciphertexts(m_context),
+        [this, self](boost::system::error_code ec, std::size_t length) {
+          if (!ec) {
+            m_decoder.push(std::move(m_read_message));
+            do_read_header();
+          } else {
+            NGRAPH_ERR << "Server error reading ciphertexts: " << ec.message();
+            throw std::runtime_error("Server error reading ciphertexts");
+          }
+        });
+  }
+
+  /// \brief Adds a message to the message-writing queue. Since messages are
+  /// handled off the I/O thread, the message is queued on the I/O thread
   /// \param[in,out] message Message to write
   void write_message(TCPMessage&& message) {
-    bool write_in_progress = is_writing();
-    m_message_queue.emplace_back(std::move(message));
-    if (!write_in_progress) {
-      do_write();
+    {
+      std::lock_guard<std::mutex> lock(m_write_mtx);
+      ++m_pending_writes;
     }
+    auto self(shared_from_this());
+    boost::asio::post(m_socket.get_executor(),
+                      [this, self, message = std::move(message)]() mutable {
+                        bool write_in_progress = !m_message_queue.empty();
+                        m_message_queue.emplace_back(std::move(message));
+                        if (!write_in_progress) {
+                          do_write();
+                        }
+                      });
+  }
+
+  /// \brief Closes the session, for instance once a received message fails
+  /// to be handled
+  void close() {
+    // Called from decoder threads, which may outlive the last reference
+    std::weak_ptr<TCPSession> weak_self = weak_from_this();
+    boost::asio::post(m_socket.get_executor(), [weak_self]() {
+      if (auto self = weak_self.lock()) {
+        boost::system::error_code ec;
+        self->m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both,
+                                ec);
+        self->m_socket.close(ec);
+        self->finish_writes();
+      }
+    });
+  }
+
+  /// \brief Stops reading messages, so the message handler is no longer
+  /// called. Queued messages are still written
+  void stop_reading() {
+    auto self(shared_from_this());
+    boost::asio::post(m_socket.get_executor(), [this, self]() {
+      boost::system::error_code ec;
+      m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_receive, ec);
+    });
   }
 
   /// \brief Returns whether or not a message is queued to be written
-  bool is_writing() const { return !m_message_queue.empty(); }
+  bool is_writing() const {
+    std::lock_guard<std::mutex> lock(m_write_mtx);
+    return m_pending_writes != 0;
+  }
 
-  /// \brief Returns a condition variable notified when the session is done
-  /// writing a message
-  std::condition_variable& is_writing_cond() { return m_is_writing; }
+  /// \brief Blocks until every queued message is written, or fails to be
+  /// written
+  void wait_for_writes() {
+    std::unique_lock<std::mutex> lock(m_write_mtx);
+    m_is_writing.wait(lock, [this]() { return m_pending_writes == 0; });
+  }
 
  private:
-  void do_write() {
-    std::lock_guard<std::mutex> lock(m_write_mtx);
+  /// \brief Marks the queued messages as done, on the I/O thread
+  void finish_writes(size_t count = std::numeric_limits<size_t>::max()) {
+    {
+      std::lock_guard<std::mutex> lock(m_write_mtx);
+      m_pending_writes -= std::min(count, m_pending_writes);
+    }
     m_is_writing.notify_all();
+  }
+
+  void do_write() {
     auto self(shared_from_this());
     auto message = m_message_queue.front();
     message.pack(m_write_buffer);
     NGRAPH_HE_LOG(4) << "Server writing message size " << m_write_buffer.size()
                      << " bytes";
 
+    // Attached ciphertexts are written directly from ciphertext storage
     boost::asio::async_write(
-        m_socket, boost::asio::buffer(m_write_buffer),
+        m_socket, message.write_buffers(m_write_buffer),
         [this, self](boost::system::error_code ec, std::size_t length) {
           if (!ec) {
             m_message_queue.pop_front();
+            finish_writes(1);
             if (!m_message_queue.empty()) {
               do_write();
-            } else {
-              m_is_writing.notify_all();
             }
           } else {
             NGRAPH_ERR << "Server error writing message: " << ec.message();
+            // Waiters are released, since the queued messages are never sent
+            m_message_queue.clear();
+            finish_writes();
           }
         });
   }
@@ -132,11 +219,15 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
   data_buffer m_read_buffer;
   data_buffer m_write_buffer;
   boost::asio::ip::tcp::socket m_socket;
+  std::shared_ptr<seal::SEALContext> m_context;
   std::condition_variable m_is_writing;
-  std::mutex m_write_mtx;
+  mutable std::mutex m_write_mtx;
+  // Number of messages passed to write_message which are not yet written
+  size_t m_pending_writes{0};
 
   inline static std::string s_expected_teardown_message{"End of file"};
 
-  std::function<void(const TCPMessage&)> m_message_callback;
+  // Declared last, so that decoding stops before other members are destroyed
+  TCPMessageDecoder m_decoder;
 };
 }  // namespace ngraph::he
@@ -17,6 +17,9 @@
 #include "util.hpp"
 
 #include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -47,6 +50,39 @@ bool flag_to_bool(const char* flag, bool default_value) {
   throw ngraph_error("Unknown flag value " + std::string(flag));
 }
 
+std::string env_string(const char* env_var) {
+  const char* value = std::getenv(env_var);
+  return value == nullptr ? std::string() : std::string(value);
+}
+
+std::string pack_doubles(const std::vector<double>& values) {
+  std::string packed(values.size() * sizeof(uint64_t), '\0');
+  for (size_t i = 0; i < values.size(); ++i) {
+    uint64_t bits;
+    std::memcpy(&bits, &values[i], sizeof(bits));
+    for (size_t byte_idx = 0; byte_idx < sizeof(bits); ++byte_idx) {
+      packed[i * sizeof(bits) + byte_idx] =
+          static_cast<char>((bits >> (8 * byte_idx)) & 0xff);
+    }
+  }
+  return packed;
+}
+
+void unpack_doubles(std::vector<double>& values, const std::string& packed) {
+  NGRAPH_CHECK(packed.size() % sizeof(uint64_t) == 0, "Packed doubles size ",
+               packed.size(), " is not a multiple of ", sizeof(uint64_t));
+  values.resize(packed.size() / sizeof(uint64_t));
+  for (size_t i = 0; i < values.size(); ++i) {
+    uint64_t bits = 0;
+    for (size_t byte_idx = 0; byte_idx < sizeof(bits); ++byte_idx) {
+      auto byte = static_cast<unsigned char>(
+          packed[i * sizeof(bits) + byte_idx]);
+      bits |= static_cast<uint64_t>(byte) << (8 * byte_idx);
+    }
+    std::memcpy(&values[i], &bits, sizeof(bits));
+  }
+}
+
 double type_to_double(const void* src, const element::Type& element_type) {
   switch (element_type.get_type_enum()) {
     case element::Type_t::f32: {
@@ -89,6 +89,22 @@ map_to_double_map(
 /// \returns True if flag represents a True value, False otherwise
 bool flag_to_bool(const char* flag, bool default_value = false);
 
+/// \brief Returns the value of an environment variable
+/// \param[in] env_var Name of the environment variable
+/// \returns The value, or an empty string if the variable is not set
+std::string env_string(const char* env_var);
+
+/// \brief Serializes values as packed little-endian doubles
+/// \param[in] values Values to serialize
+/// \returns String storing 8 bytes per value
+std::string pack_doubles(const std::vector<double>& values);
+
+/// \brief De-serializes values written by pack_doubles
+/// \param[out] values De-serialized values
+/// \param[in] packed Packed little-endian doubles
+/// \throws ngraph_error if the size of packed is not a multiple of 8
+void unpack_doubles(std::vector<double>& values, const std::string& packed);
+
 /// \brief Converts a type to a double using static_cast
 /// Note, this means a reduction of range in int64 and uint64 values.
 /// \param[in] src Source from which to read
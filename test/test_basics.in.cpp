@@ -14,12 +14,19 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "he_tensor.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_executable.hpp"
+#include "seal/seal_ciphertext_pool.hpp"
+#include "seal/seal_ciphertext_slab.hpp"
+#include "seal/seal_util.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -229,3 +236,285 @@ NGRAPH_TEST(${BACKEND_NAME}, unsupported_op_type) {
     EXPECT_THROW({ backend->compile(f); }, ngraph::CheckFailure);
   }
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, mod_switch_to_lowest_level) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  auto context = he_backend->get_context();
+  size_t first_chain_index = context->first_context_data()->chain_index();
+  EXPECT_EQ(
+      ngraph::he::parms_id_at_chain_index(*context, first_chain_index),
+      context->first_parms_id());
+  EXPECT_EQ(ngraph::he::parms_id_at_chain_index(*context, 0),
+            context->last_parms_id());
+
+  ngraph::he::HEPlaintext input{-1.5, 0.25, 2};
+  auto cipher = ngraph::he::HESealBackend::create_empty_ciphertext();
+  he_backend->encrypt(cipher, input, ngraph::element::f32, false);
+  EXPECT_EQ(he_backend->get_chain_index(*cipher), first_chain_index);
+
+  // A ciphertext at the encoding scale decrypts at the lowest level
+  auto switched = ngraph::he::mod_switch_to_lowest_level(*cipher, *he_backend);
+  EXPECT_EQ(he_backend->get_chain_index(*cipher), first_chain_index);
+  EXPECT_EQ(he_backend->get_chain_index(*switched), 0U);
+
+  ngraph::he::HEPlaintext output;
+  he_backend->decrypt(output, *switched, false);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      std::vector<double>(output.begin(), output.begin() + input.size()),
+      std::vector<double>(input.begin(), input.end()), 1e-3));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, client_aided_chain_index) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  std::string error_str;
+  he_backend->set_config(
+      std::map<std::string, std::string>{{"enable_client", "true"}}, error_str);
+  size_t first_chain_index =
+      he_backend->get_context()->first_context_data()->chain_index();
+
+  ngraph::Shape shape_a{1, 3};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32,
+                                                   shape_a);
+  ngraph::Shape shape_b{3, 2};
+  auto b = ngraph::op::Constant::create(ngraph::element::f32, shape_b,
+                                        {1, 2, 3, 4, 5, 6});
+  auto relu_a = std::make_shared<ngraph::op::Relu>(a);
+  auto dot = std::make_shared<ngraph::op::Dot>(relu_a, b);
+  auto relu_dot = std::make_shared<ngraph::op::Relu>(dot);
+  auto f =
+      std::make_shared<ngraph::Function>(relu_dot, ngraph::ParameterVector{a});
+
+  auto handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+
+  // The Dot needs one level to rescale to
+  EXPECT_EQ(handle->client_aided_chain_index(*relu_a),
+            std::min<size_t>(1, first_chain_index));
+  // The result is only decrypted
+  EXPECT_EQ(handle->client_aided_chain_index(*relu_dot), 0U);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, recycle_intermediate_ciphertexts) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{2, 3};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto b = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto sum = std::make_shared<ngraph::op::Add>(a, b);
+  auto t = std::make_shared<ngraph::op::Add>(sum, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+  b->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, false, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                 false);
+  auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape, false,
+                                                 false);
+  auto t_result = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                      false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  copy_data(t_b, std::vector<float>{1, -1, 1, -1, 1, -1});
+
+  auto handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+      backend->compile(f));
+  EXPECT_EQ(handle->ciphertext_pool().size(), 0);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  // The intermediate sum is freed once the second sum is computed
+  EXPECT_GT(handle->ciphertext_pool().size(), 0);
+
+  // Recycled ciphertexts are overwritten by later calls
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<float>(t_result),
+      std::vector<float>{3, 0, 5, 2, 7, 4}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, slab_tensor_storage) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{2, 3};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto b = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto sum = std::make_shared<ngraph::op::Add>(a, b);
+  auto t = std::make_shared<ngraph::op::Add>(sum, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+  b->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, false, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                 false);
+  auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape, false,
+                                                 false);
+  auto t_result = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                      false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  copy_data(t_b, std::vector<float>{1, -1, 1, -1, 1, -1});
+
+  std::shared_ptr<ngraph::runtime::Executable> handle;
+  {
+    ngraph::test::he::ScopedEnv slab_env("SLAB_TENSOR_STORAGE", "1");
+    handle = backend->compile(f);
+  }
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<float>(t_result),
+      std::vector<float>{3, 0, 5, 2, 7, 4}, 1e-3f));
+
+  // The result holds the ciphertexts of the last Add's output, which are
+  // stored in a slab
+  const auto& he_result =
+      dynamic_cast<const ngraph::he::HETensor&>(*t_result);
+  for (const auto& he_type : he_result.data()) {
+    ASSERT_TRUE(he_type.is_ciphertext());
+    seal::util::MemoryPool& pool =
+        he_type.get_ciphertext()->ciphertext().pool();
+    const auto* slab = dynamic_cast<ngraph::he::SealCiphertextSlab*>(&pool);
+    ASSERT_NE(slab, nullptr);
+    EXPECT_TRUE(slab->contains(he_type.get_ciphertext()->ciphertext().data()));
+  }
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, inter_op_threads) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // The sum and product are independent, so may be computed concurrently
+  ngraph::Shape shape{2, 3};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto b = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto sum = std::make_shared<ngraph::op::Add>(a, b);
+  auto prod = std::make_shared<ngraph::op::Multiply>(a, b);
+  auto t = std::make_shared<ngraph::op::Subtract>(sum, prod);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+  b->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, false, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                 false);
+  auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape, false,
+                                                 false);
+  auto t_result = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                      false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  copy_data(t_b, std::vector<float>{2, -1, 2, -1, 2, -1});
+
+  std::shared_ptr<ngraph::runtime::Executable> handle;
+  {
+    ngraph::test::he::ScopedEnv inter_op_threads("INTER_OP_THREADS", "4");
+    handle = backend->compile(f);
+  }
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<float>(t_result),
+      std::vector<float>{1, 3, -1, 7, -3, 11}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, index_plans_reused_across_calls) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{2, 3};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+  auto transpose = std::make_shared<ngraph::op::Reshape>(
+      a, ngraph::AxisVector{1, 0}, ngraph::Shape{3, 2});
+  auto slice = std::make_shared<ngraph::op::Slice>(
+      transpose, ngraph::Coordinate{1, 0}, ngraph::Coordinate{3, 2});
+  auto t = std::make_shared<ngraph::op::Reverse>(slice, ngraph::AxisSet{1});
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                 false);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, ngraph::Shape{2, 2}, true, false);
+
+  auto handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+      backend->compile(f));
+  size_t build_count = handle->index_plan_build_count();
+  // Plans of the Reshape, Slice and Reverse
+  EXPECT_GE(build_count, 3U);
+
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(t_result),
+                                          std::vector<float>{5, 2, 6, 3},
+                                          1e-3f));
+  EXPECT_EQ(handle->index_plan_build_count(), build_count);
+
+  copy_data(t_a, std::vector<float>{10, 20, 30, 40, 50, 60});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(t_result),
+                                          std::vector<float>{50, 20, 60, 30},
+                                          1e-3f));
+  EXPECT_EQ(handle->index_plan_build_count(), build_count);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, tensor_views) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Views and copies compute the same result
+  for (const char* tensor_views : {"1", "0"}) {
+    ngraph::Shape shape{2, 3};
+    auto a =
+        std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+    auto b =
+        std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape);
+    auto concat =
+        std::make_shared<ngraph::op::Concat>(ngraph::NodeVector{a, b}, 1);
+    auto transpose = std::make_shared<ngraph::op::Reshape>(
+        concat, ngraph::AxisVector{1, 0}, ngraph::Shape{6, 2});
+    auto slice = std::make_shared<ngraph::op::Slice>(
+        transpose, ngraph::Coordinate{2, 0}, ngraph::Coordinate{5, 2});
+    auto reverse =
+        std::make_shared<ngraph::op::Reverse>(slice, ngraph::AxisSet{0});
+    auto t = std::make_shared<ngraph::op::Add>(reverse, reverse);
+    auto f =
+        std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+    a->set_op_annotations(
+        ngraph::test::he::annotation_from_flags(false, true, false));
+    b->set_op_annotations(
+        ngraph::test::he::annotation_from_flags(false, false, false));
+
+    auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape, true,
+                                                   false);
+    auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape, false,
+                                                   false);
+    auto t_result = ngraph::test::he::tensor_from_flags(
+        *he_backend, ngraph::Shape{3, 2}, true, false);
+    copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+    copy_data(t_b, std::vector<float>{7, 8, 9, 10, 11, 12});
+
+    std::shared_ptr<ngraph::he::HESealExecutable> handle;
+    {
+      ngraph::test::he::ScopedEnv views_env("TENSOR_VIEWS", tensor_views);
+      handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+          backend->compile(f));
+    }
+    handle->call_with_validate({t_result}, {t_a, t_b});
+    EXPECT_TRUE(ngraph::test::he::all_close(
+        read_vector<float>(t_result),
+        std::vector<float>{16, 22, 14, 20, 6, 12}, 1e-3f));
+    if (std::string(tensor_views) == "1") {
+      EXPECT_GT(handle->output_view_count(), 0U);
+    } else {
+      EXPECT_EQ(handle->output_view_count(), 0U);
+    }
+  }
+}
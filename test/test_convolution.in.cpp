@@ -17,6 +17,8 @@
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/convolution_packed_image_seal.hpp"
+#include "seal/kernel/rescale_seal.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -969,3 +971,216 @@ NGRAPH_TEST(${BACKEND_NAME},
           0.0f,   0.0f,   0.0f,   0.0f,   0.0f,   0.0f},
       true, true, false, false);
 }
+
+auto conv_packed_image_test = [](const ngraph::Shape& image_shape,
+                                 const ngraph::Shape& filter_shape,
+                                 const ngraph::CoordinateDiff& padding_below,
+                                 const ngraph::CoordinateDiff& padding_above,
+                                 size_t row_stride,
+                                 const std::vector<double>& image,
+                                 const std::vector<double>& filter,
+                                 const std::vector<float>& output) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Each channel is packed into a single ciphertext, one row per row_stride
+  // slots
+  size_t rows = image_shape[1];
+  size_t cols = image_shape[2];
+  std::vector<ngraph::he::HEType> arg0;
+  for (size_t channel = 0; channel < image_shape[0]; ++channel) {
+    ngraph::he::HEPlaintext plane(rows * row_stride, 0);
+    for (size_t row = 0; row < rows; ++row) {
+      for (size_t col = 0; col < cols; ++col) {
+        plane[row * row_stride + col] =
+            image[(channel * rows + row) * cols + col];
+      }
+    }
+    auto cipher = ngraph::he::HESealBackend::create_empty_ciphertext();
+    he_backend->encrypt(cipher, plane, ngraph::element::f32, false);
+    arg0.emplace_back(cipher, false, plane.size());
+  }
+
+  std::vector<ngraph::he::HEType> arg1;
+  for (double weight : filter) {
+    arg1.emplace_back(ngraph::he::HEPlaintext({weight}), false);
+  }
+
+  std::vector<ngraph::he::HEType> out(
+      filter_shape[0], ngraph::he::HEType(ngraph::he::HEPlaintext(), false));
+  he_backend->generate_galois_keys(
+      ngraph::he::convolution_packed_image_rotation_steps(
+          filter_shape, padding_below, row_stride));
+  ngraph::he::convolution_packed_image_seal(arg0, arg1, out, image_shape,
+                                            filter_shape, padding_below,
+                                            padding_above, row_stride,
+                                            *he_backend);
+  ngraph::he::rescale_seal(out, *he_backend, false);
+
+  size_t out_rows =
+      rows + padding_below[0] + padding_above[0] - filter_shape[2] + 1;
+  size_t out_cols =
+      cols + padding_below[1] + padding_above[1] - filter_shape[3] + 1;
+  std::vector<float> result;
+  for (auto& out_channel : out) {
+    ngraph::he::HEPlaintext plain;
+    he_backend->decrypt(plain, *out_channel.get_ciphertext(), false);
+    for (size_t row = 0; row < out_rows; ++row) {
+      for (size_t col = 0; col < out_cols; ++col) {
+        result.emplace_back(plain[row * row_stride + col]);
+      }
+    }
+  }
+  EXPECT_TRUE(ngraph::test::he::all_close(result, output, 1e-3f));
+};
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_packed_image_valid) {
+  conv_packed_image_test(
+      ngraph::Shape{2, 3, 3}, ngraph::Shape{1, 2, 2, 2},
+      ngraph::CoordinateDiff{0, 0}, ngraph::CoordinateDiff{0, 0}, 3,
+      std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+      std::vector<double>{1, 2, 0, 0, 1, 1, 1, 1},
+      std::vector<float>{9, 12, 18, 21});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_packed_image_same) {
+  conv_packed_image_test(
+      ngraph::Shape{1, 3, 3}, ngraph::Shape{2, 1, 3, 3},
+      ngraph::CoordinateDiff{1, 1}, ngraph::CoordinateDiff{1, 1}, 4,
+      std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8, 9},
+      std::vector<double>{1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 2, 0, 0, 0,
+                          0},
+      std::vector<float>{12, 21, 16, 27, 45, 33, 24, 39, 28, 2, 4, 6, 8, 10,
+                         12, 14, 16, 18});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_packed_image_parameter) {
+  ngraph::test::he::ScopedEnv packed_image("PACKED_IMAGE_CONVOLUTION", "1");
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{1, 2, 3, 3};
+  auto a =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_a);
+  auto b = ngraph::op::Constant::create(ngraph::element::f32,
+                                        ngraph::Shape{1, 2, 2, 2},
+                                        {1, 2, 0, 0, 1, 1, 1, 1});
+  auto c = ngraph::op::Constant::create(ngraph::element::f32,
+                                        ngraph::Shape{1, 1, 1, 1}, {2});
+  // The output of the first convolution stays image packed
+  auto t = std::make_shared<ngraph::op::Convolution>(
+      std::make_shared<ngraph::op::Convolution>(a, b), c);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+
+  auto t_a =
+      ngraph::test::he::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, t->get_shape(), true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 1, 1, 1, 1, 1,
+                                    1, 1, 1, 1});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(std::static_pointer_cast<ngraph::he::HETensor>(t_result)
+                  ->is_image_packed());
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(t_result),
+                                          std::vector<float>{18, 24, 36, 42},
+                                          1e-3f));
+}
+
+auto conv_accumulate_test = [](const std::vector<float>& input_a,
+                               const std::vector<float>& input_b,
+                               const bool arg1_encrypted,
+                               const bool arg2_encrypted,
+                               const bool mixed_levels) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{1, 1, 3, 3};
+  ngraph::Shape shape_b{1, 1, 2, 2};
+  auto a =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_a);
+  auto b =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_b);
+  auto t = std::make_shared<ngraph::op::Convolution>(a, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, arg1_encrypted, false));
+  b->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, arg2_encrypted, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape_a,
+                                                 arg1_encrypted, false);
+  auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape_b,
+                                                 arg2_encrypted, false);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, t->get_shape(), arg1_encrypted || arg2_encrypted, false);
+
+  copy_data(t_a, input_a);
+  copy_data(t_b, input_b);
+  if (mixed_levels) {
+    ngraph::test::he::mod_switch_alternate_ciphertexts(*t_a, *he_backend);
+  }
+
+  // Plaintext reference
+  std::vector<float> expected(4, 0.0f);
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 2; ++j) {
+      for (size_t di = 0; di < 2; ++di) {
+        for (size_t dj = 0; dj < 2; ++dj) {
+          expected[i * 2 + j] +=
+              input_a[(i + di) * 3 + j + dj] * input_b[di * 2 + dj];
+        }
+      }
+    }
+  }
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(t_result),
+                                          expected, 1e-3f));
+  EXPECT_TRUE(ngraph::test::he::all_ciphertexts_relinearized(*t_result));
+};
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_accumulate_cipher_cipher) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{2, -1, 0.5, 3}, true, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_accumulate_cipher_plain) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{2, -1, 0.5, 3}, true, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME},
+            convolution_accumulate_mixed_levels_cipher_cipher) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{2, -1, 0.5, 3}, true, true, true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_accumulate_mixed_levels_cipher_plain) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{2, -1, 0.5, 3}, true, false, true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME},
+            convolution_accumulate_zero_weights_cipher_cipher) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{0, 0, 0, 0}, true, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_accumulate_zero_weights_cipher_plain) {
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{0, 0, 0, 0}, true, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_accumulate_without_index_plan) {
+  // Every convolution computes its index plan on the fly
+  ngraph::test::he::ScopedEnv plan_env("CONVOLUTION_PLAN_MAX_ENTRIES", "0");
+  conv_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1, 2, 0, -3},
+                       std::vector<float>{2, -1, 0.5, 3}, true, false, false);
+}
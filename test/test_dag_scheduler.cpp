@@ -0,0 +1,132 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "dag_scheduler.hpp"
+#include "gtest/gtest.h"
+#include "task_runtime.hpp"
+
+TEST(dag_scheduler, runs_in_order_on_one_thread) {
+  ngraph::he::DAGScheduler scheduler(5);
+  scheduler.add_dependency(3, 0);
+  scheduler.add_dependency(4, 1);
+
+  std::vector<size_t> order;
+  scheduler.run([&](size_t task_idx) { order.emplace_back(task_idx); }, 1);
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(dag_scheduler, respects_dependencies) {
+  // Diamond: 0 -> {1, 2} -> 3, with 4 independent
+  ngraph::he::DAGScheduler scheduler(5);
+  scheduler.add_dependency(1, 0);
+  scheduler.add_dependency(2, 0);
+  scheduler.add_dependency(3, 1);
+  scheduler.add_dependency(3, 2);
+  EXPECT_ANY_THROW(scheduler.add_dependency(0, 3));
+
+  std::mutex mutex;
+  std::vector<size_t> order;
+  std::atomic<size_t> running{0};
+  std::atomic<size_t> max_running{0};
+  ngraph::he::TaskRuntime runtime(4);
+  scheduler.run(
+      [&](size_t task_idx) {
+        size_t now_running = ++running;
+        size_t prev_max = max_running.load();
+        while (now_running > prev_max &&
+               !max_running.compare_exchange_weak(prev_max, now_running)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          order.emplace_back(task_idx);
+        }
+        --running;
+      },
+      4, runtime);
+
+  ASSERT_EQ(order.size(), 5);
+  auto position = [&](size_t task_idx) {
+    return std::find(order.begin(), order.end(), task_idx) - order.begin();
+  };
+  EXPECT_LT(position(0), position(1));
+  EXPECT_LT(position(0), position(2));
+  EXPECT_LT(position(1), position(3));
+  EXPECT_LT(position(2), position(3));
+  EXPECT_GT(max_running.load(), 1);
+}
+
+TEST(dag_scheduler, serializes_exclusive_tasks) {
+  ngraph::he::DAGScheduler scheduler(6);
+  for (size_t task_idx = 0; task_idx < 6; task_idx += 2) {
+    scheduler.set_exclusive(task_idx);
+  }
+
+  std::atomic<size_t> exclusive_running{0};
+  std::atomic<bool> overlapped{false};
+  scheduler.run(
+      [&](size_t task_idx) {
+        if (task_idx % 2 != 0) {
+          return;
+        }
+        if (++exclusive_running > 1) {
+          overlapped = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --exclusive_running;
+      },
+      4);
+  EXPECT_FALSE(overlapped.load());
+}
+
+TEST(dag_scheduler, runs_without_idle_workers) {
+  ngraph::he::DAGScheduler scheduler(4);
+  scheduler.add_dependency(3, 0);
+
+  // Ready tasks posted to a runtime without workers are run by the caller
+  ngraph::he::TaskRuntime runtime(1);
+  std::vector<size_t> order;
+  scheduler.run([&](size_t task_idx) { order.emplace_back(task_idx); }, 4,
+                runtime);
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST(dag_scheduler, rethrows_task_errors) {
+  ngraph::he::DAGScheduler scheduler(3);
+  scheduler.add_dependency(2, 1);
+
+  std::atomic<bool> dependent_ran{false};
+  EXPECT_THROW(scheduler.run(
+                   [&](size_t task_idx) {
+                     if (task_idx == 1) {
+                       throw std::runtime_error("task failed");
+                     }
+                     if (task_idx == 2) {
+                       dependent_ran = true;
+                     }
+                   },
+                   2),
+               std::runtime_error);
+  EXPECT_FALSE(dependent_ran.load());
+}
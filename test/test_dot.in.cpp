@@ -17,6 +17,7 @@
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/dot_diagonal_seal.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -277,3 +278,181 @@ NGRAPH_TEST(${BACKEND_NAME}, dot_scalar_cipher_cipher_complex_unpacked) {
            std::vector<float>{6}, std::vector<float>{48}, false, false, false,
            false);
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_cipher_constant_repeated_call) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{2, 3};
+  ngraph::Shape shape_b{3, 2};
+  auto a =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_a);
+  auto b = ngraph::op::Constant::create(ngraph::element::f32, shape_b,
+                                        {1, 2, 3, 4, 5, 6});
+  auto t = std::make_shared<ngraph::op::Dot>(a, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape_a, true,
+                                                 false);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, t->get_shape(), true, false);
+
+  auto handle = backend->compile(f);
+
+  // The second call re-uses the encodings of the constant from the first call
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<float>(t_result), std::vector<float>{22, 28, 49, 64}, 1e-3f));
+
+  copy_data(t_a, std::vector<float>{-1, 0, 2, 1, 1, 1});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<float>(t_result), std::vector<float>{9, 10, 9, 12}, 1e-3f));
+}
+
+auto dot_packed_vector_test = [](const ngraph::Shape& shape_b,
+                                 const std::vector<float>& input_a,
+                                 const std::vector<float>& input_b,
+                                 const std::vector<float>& output) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{shape_b[0]};
+  auto a =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_a);
+  auto b = ngraph::op::Constant::create(ngraph::element::f32, shape_b, input_b);
+  auto t = std::make_shared<ngraph::op::Dot>(a, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  // The vector is packed into a single ciphertext
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, true, true));
+
+  auto t_a =
+      ngraph::test::he::tensor_from_flags(*he_backend, shape_a, true, true);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, t->get_shape(), true, true);
+
+  copy_data(t_a, input_a);
+
+  // Galois keys are only generated for the rotations the Dot uses
+  auto handle = backend->compile(f);
+  EXPECT_TRUE(he_backend->has_galois_keys(
+      ngraph::he::dot_diagonal_rotation_steps(shape_b[0], shape_b[1])));
+  EXPECT_FALSE(he_backend->has_galois_keys(std::vector<int>{-1}));
+
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(
+      ngraph::test::he::all_close(read_vector<float>(t_result), output, 1e-3f));
+};
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_packed_vector_square) {
+  dot_packed_vector_test(
+      ngraph::Shape{4, 4}, std::vector<float>{1, 2, 3, 4},
+      std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16},
+      std::vector<float>{90, 100, 110, 120});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_packed_vector_narrow) {
+  dot_packed_vector_test(
+      ngraph::Shape{4, 3}, std::vector<float>{1, 2, 3, 4},
+      std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12},
+      std::vector<float>{70, 80, 90});
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_packed_vector_wide) {
+  dot_packed_vector_test(
+      ngraph::Shape{2, 5}, std::vector<float>{1, -2},
+      std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
+      std::vector<float>{-11, -12, -13, -14, -15});
+}
+
+auto dot_accumulate_test = [](const std::vector<float>& input_a,
+                              const std::vector<float>& input_b,
+                              const bool arg1_encrypted,
+                              const bool arg2_encrypted,
+                              const bool mixed_levels) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{2, 3};
+  ngraph::Shape shape_b{3, 2};
+  auto a =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_a);
+  auto b =
+      std::make_shared<ngraph::op::Parameter>(ngraph::element::f32, shape_b);
+  auto t = std::make_shared<ngraph::op::Dot>(a, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a, b});
+
+  a->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, arg1_encrypted, false));
+  b->set_op_annotations(
+      ngraph::test::he::annotation_from_flags(false, arg2_encrypted, false));
+
+  auto t_a = ngraph::test::he::tensor_from_flags(*he_backend, shape_a,
+                                                 arg1_encrypted, false);
+  auto t_b = ngraph::test::he::tensor_from_flags(*he_backend, shape_b,
+                                                 arg2_encrypted, false);
+  auto t_result = ngraph::test::he::tensor_from_flags(
+      *he_backend, t->get_shape(), arg1_encrypted || arg2_encrypted, false);
+
+  copy_data(t_a, input_a);
+  copy_data(t_b, input_b);
+  if (mixed_levels) {
+    ngraph::test::he::mod_switch_alternate_ciphertexts(*t_a, *he_backend);
+  }
+
+  // Plaintext reference
+  std::vector<float> expected(4, 0.0f);
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 2; ++j) {
+      for (size_t k = 0; k < 3; ++k) {
+        expected[i * 2 + j] += input_a[i * 3 + k] * input_b[k * 2 + j];
+      }
+    }
+  }
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(t_result),
+                                          expected, 1e-3f));
+  EXPECT_TRUE(ngraph::test::he::all_ciphertexts_relinearized(*t_result));
+};
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_cipher_cipher) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{2, -1, 0.5, 3, -2, 1}, true, true,
+                      false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_cipher_plain) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{2, -1, 0.5, 3, -2, 1}, true, false,
+                      false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_mixed_levels_cipher_cipher) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{2, -1, 0.5, 3, -2, 1}, true, true,
+                      true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_mixed_levels_cipher_plain) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{2, -1, 0.5, 3, -2, 1}, true, false,
+                      true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_zero_weights_cipher_cipher) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{0, 0, 0, 0, 0, 0}, true, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_accumulate_zero_weights_cipher_plain) {
+  dot_accumulate_test(std::vector<float>{1, -2, 3, 0.5, 4, -1},
+                      std::vector<float>{0, 0, 0, 0, 0, 0}, true, false, false);
+}
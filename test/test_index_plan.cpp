@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index_plan.hpp"
+#include "ngraph/ngraph.hpp"
+#include "seal/kernel/convolution_seal.hpp"
+#include "seal/kernel/pad_seal.hpp"
+#include "seal/kernel/reshape_seal.hpp"
+#include "seal/kernel/slice_seal.hpp"
+
+TEST(index_plan, entries) {
+  ngraph::he::IndexPlan plan({ngraph::Shape{4}, ngraph::Shape{2}},
+                             ngraph::Shape{2});
+  EXPECT_EQ(plan.output_count(), 0U);
+  plan.add_entry(0, 1);
+  plan.add_entry(3, 0);
+  plan.end_output();
+  plan.end_output();
+  EXPECT_EQ(plan.output_count(), 2);
+  EXPECT_EQ(plan.entry_begin(0), 0U);
+  EXPECT_EQ(plan.entry_end(0), 2U);
+  EXPECT_EQ(plan.arg_index(1), 3U);
+  EXPECT_EQ(plan.filter_index(1), 0U);
+  EXPECT_EQ(plan.entry_begin(1), plan.entry_end(1));
+
+  EXPECT_TRUE(plan.matches({ngraph::Shape{4}, ngraph::Shape{2}},
+                           ngraph::Shape{2}));
+  EXPECT_FALSE(plan.matches({ngraph::Shape{4}}, ngraph::Shape{2}));
+  EXPECT_FALSE(plan.matches({ngraph::Shape{4}, ngraph::Shape{2}},
+                            ngraph::Shape{1, 2}));
+  EXPECT_GT(plan.byte_count(), 0U);
+
+  EXPECT_ANY_THROW(plan.add_entry(ngraph::he::IndexPlan::padding_index, 0));
+}
+
+TEST(index_plan, reshape) {
+  // Transposes a 2x3 matrix
+  ngraph::he::IndexPlan plan = ngraph::he::reshape_seal_index_plan(
+      ngraph::Shape{2, 3}, ngraph::AxisVector{1, 0}, ngraph::Shape{3, 2});
+  ASSERT_EQ(plan.output_count(), 6U);
+  std::vector<uint32_t> gather;
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    gather.emplace_back(plan.gather_index(out_idx));
+  }
+  EXPECT_EQ(gather, (std::vector<uint32_t>{0, 3, 1, 4, 2, 5}));
+}
+
+TEST(index_plan, slice) {
+  ngraph::he::IndexPlan plan = ngraph::he::slice_seal_index_plan(
+      ngraph::Shape{6}, ngraph::Coordinate{1}, ngraph::Coordinate{6},
+      ngraph::Strides{2}, ngraph::Shape{3});
+  ASSERT_EQ(plan.output_count(), 3U);
+  EXPECT_EQ(plan.gather_index(0), 1U);
+  EXPECT_EQ(plan.gather_index(1), 3U);
+  EXPECT_EQ(plan.gather_index(2), 5U);
+}
+
+TEST(index_plan, pad) {
+  ngraph::he::IndexPlan plan = ngraph::he::pad_seal_index_plan(
+      ngraph::Shape{2}, ngraph::Shape{5}, ngraph::CoordinateDiff{1},
+      ngraph::CoordinateDiff{2}, ngraph::op::PadMode::CONSTANT);
+  ASSERT_EQ(plan.output_count(), 5U);
+  const uint32_t pad = ngraph::he::IndexPlan::padding_index;
+  std::vector<uint32_t> gather;
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    gather.emplace_back(plan.gather_index(out_idx));
+  }
+  EXPECT_EQ(gather, (std::vector<uint32_t>{pad, 0, 1, pad, pad}));
+
+  plan = ngraph::he::pad_seal_index_plan(
+      ngraph::Shape{2}, ngraph::Shape{5}, ngraph::CoordinateDiff{1},
+      ngraph::CoordinateDiff{2}, ngraph::op::PadMode::EDGE);
+  gather.clear();
+  for (size_t out_idx = 0; out_idx < plan.output_count(); ++out_idx) {
+    gather.emplace_back(plan.gather_index(out_idx));
+  }
+  EXPECT_EQ(gather, (std::vector<uint32_t>{0, 0, 1, 1, 1}));
+}
+
+TEST(index_plan, convolution_output_range) {
+  ngraph::Shape arg0_shape{1, 2, 4, 4};
+  ngraph::Shape arg1_shape{3, 2, 2, 2};
+  ngraph::Shape out_shape{1, 3, 3, 3};
+  EXPECT_EQ(ngraph::he::convolution_seal_plan_entry_count(arg1_shape,
+                                                          out_shape),
+            27U * 8U);
+
+  auto build_plan = [&](size_t out_begin, size_t out_end) {
+    return ngraph::he::convolution_seal_index_plan(
+        arg0_shape, arg1_shape, out_shape, ngraph::Strides{1, 1},
+        ngraph::Strides{1, 1}, ngraph::CoordinateDiff{0, 0},
+        ngraph::CoordinateDiff{0, 0}, ngraph::Strides{1, 1}, 0, 1, 1, 0, 0, 1,
+        false, out_begin, out_end);
+  };
+  ngraph::he::IndexPlan plan = build_plan(0, 27);
+  ASSERT_EQ(plan.output_count(), 27U);
+
+  // A plan of a range of outputs holds the same entries
+  ngraph::he::IndexPlan range_plan = build_plan(10, 20);
+  ASSERT_EQ(range_plan.output_count(), 10U);
+  for (size_t out_idx = 0; out_idx < range_plan.output_count(); ++out_idx) {
+    size_t entry_count =
+        range_plan.entry_end(out_idx) - range_plan.entry_begin(out_idx);
+    ASSERT_EQ(entry_count,
+              plan.entry_end(out_idx + 10) - plan.entry_begin(out_idx + 10));
+    for (size_t entry = 0; entry < entry_count; ++entry) {
+      size_t range_entry = range_plan.entry_begin(out_idx) + entry;
+      size_t full_entry = plan.entry_begin(out_idx + 10) + entry;
+      EXPECT_EQ(range_plan.arg_index(range_entry), plan.arg_index(full_entry));
+      EXPECT_EQ(range_plan.filter_index(range_entry),
+                plan.filter_index(full_entry));
+    }
+  }
+}
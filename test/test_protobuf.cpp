@@ -16,15 +16,24 @@
 
 #include <google/protobuf/util/message_differencer.h>
 
+#include <boost/asio.hpp>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "he_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/tcp_message_decoder.hpp"
 #include "util/test_tools.hpp"
 
 TEST(protobuf, trivial) { EXPECT_EQ(1, 1); }
@@ -88,3 +97,209 @@ TEST(tcp_message, pack_unpack) {
   EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
       *message1.proto_message(), *message2.proto_message()));
 }
+
+TEST(tcp_message, pack_unpack_attached_ciphertexts) {
+  using data_buffer = std::vector<char>;
+
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 8192;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {60, 40, 40, 60}));
+  auto context = seal::SEALContext::Create(parms);
+
+  seal::KeyGenerator keygen(context);
+  seal::Encryptor encryptor(context, keygen.public_key());
+  seal::Decryptor decryptor(context, keygen.secret_key());
+  seal::Evaluator evaluator(context);
+  seal::CKKSEncoder encoder(context);
+
+  std::vector<double> input{0.0, 1.1, 2.2, 3.3};
+  seal::Plaintext plain;
+  encoder.encode(input, pow(2.0, 40), plain);
+
+  // Attach ciphertexts at different levels
+  seal::Ciphertext cipher0;
+  encryptor.encrypt(plain, cipher0);
+  seal::Ciphertext cipher1 = cipher0;
+  evaluator.mod_switch_to_next_inplace(cipher1);
+  ngraph::he::TCPMessage::ciphertext_list ciphertexts{
+      std::make_shared<ngraph::he::SealCiphertextWrapper>(cipher0),
+      std::make_shared<ngraph::he::SealCiphertextWrapper>(cipher1)};
+
+  ngraph::he::pb::TCPMessage proto_msg;
+  proto_msg.set_type(ngraph::he::pb::TCPMessage_Type_RESPONSE);
+  ngraph::he::TCPMessage message1(std::move(proto_msg), ciphertexts);
+  EXPECT_EQ(message1.proto_message()->ciphertext_headers_size(), 2);
+
+  // Gather the written buffers into a single stream
+  data_buffer buffer;
+  message1.pack(buffer);
+  data_buffer stream;
+  for (const auto& write_buffer : message1.write_buffers(buffer)) {
+    const auto* data = static_cast<const char*>(write_buffer.data());
+    stream.insert(stream.end(), data, data + write_buffer.size());
+  }
+
+  data_buffer read_buffer(stream.begin(), stream.begin() + buffer.size());
+  EXPECT_TRUE(ngraph::he::TCPMessage::decode_has_ciphertexts(read_buffer));
+  EXPECT_EQ(ngraph::he::TCPMessage::decode_header(read_buffer),
+            buffer.size() - ngraph::he::TCPMessage::header_length);
+
+  ngraph::he::TCPMessage message2;
+  message2.unpack(read_buffer);
+  size_t offset = buffer.size();
+  for (const auto& read_cipher_buffer :
+       message2.allocate_ciphertexts(context)) {
+    std::memcpy(read_cipher_buffer.data(), &stream[offset],
+                read_cipher_buffer.size());
+    offset += read_cipher_buffer.size();
+  }
+  EXPECT_EQ(offset, stream.size());
+  message2.validate_ciphertexts(context);
+
+  ASSERT_EQ(message2.ciphertexts().size(), ciphertexts.size());
+  for (size_t cipher_idx = 0; cipher_idx < ciphertexts.size(); ++cipher_idx) {
+    const auto& cipher = ciphertexts[cipher_idx]->ciphertext();
+    const auto& cipher_load = message2.ciphertexts()[cipher_idx]->ciphertext();
+    EXPECT_EQ(cipher_load.parms_id(), cipher.parms_id());
+    EXPECT_EQ(cipher_load.is_ntt_form(), cipher.is_ntt_form());
+    EXPECT_EQ(cipher_load.size(), cipher.size());
+    EXPECT_EQ(cipher_load.scale(), cipher.scale());
+    EXPECT_EQ(0, std::memcmp(cipher_load.data(), cipher.data(),
+                             ciphertexts[cipher_idx]->data_size()));
+  }
+
+  // Messages without attachments leave the header flag unset
+  ngraph::he::TCPMessage message3(ngraph::he::pb::TCPMessage{});
+  message3.pack(buffer);
+  EXPECT_FALSE(ngraph::he::TCPMessage::decode_has_ciphertexts(buffer));
+}
+
+TEST(tcp_message_decoder, in_order) {
+  using data_buffer = std::vector<char>;
+
+  std::vector<std::string> handled;
+  {
+    ngraph::he::TCPMessageDecoder decoder(
+        [&](const ngraph::he::TCPMessage& message) {
+          handled.emplace_back(message.proto_message()->function().function());
+        },
+        nullptr, 4, 3);
+
+    for (size_t msg_idx = 0; msg_idx < 100; ++msg_idx) {
+      ngraph::he::pb::TCPMessage proto_msg;
+      proto_msg.mutable_function()->set_function(std::to_string(msg_idx));
+      ngraph::he::TCPMessage message(std::move(proto_msg));
+
+      data_buffer buffer;
+      message.pack(buffer);
+      decoder.push(std::move(buffer));
+    }
+  }
+
+  ASSERT_EQ(handled.size(), 100);
+  for (size_t msg_idx = 0; msg_idx < handled.size(); ++msg_idx) {
+    EXPECT_EQ(handled[msg_idx], std::to_string(msg_idx));
+  }
+}
+
+TEST(tcp_message_decoder, handler_error) {
+  using data_buffer = std::vector<char>;
+
+  std::vector<std::string> handled;
+  std::vector<std::string> errors;
+  {
+    ngraph::he::TCPMessageDecoder decoder(
+        [&](const ngraph::he::TCPMessage& message) {
+          const auto& function = message.proto_message()->function().function();
+          if (function == "5") {
+            throw std::runtime_error("bad message");
+          }
+          handled.emplace_back(function);
+        },
+        nullptr, 4, 3);
+    decoder.set_error_handler(
+        [&](const std::string& error) { errors.emplace_back(error); });
+
+    // Pushing blocks once too many messages are pending, so this only
+    // finishes if failed messages still release later ones
+    for (size_t msg_idx = 0; msg_idx < 20; ++msg_idx) {
+      ngraph::he::pb::TCPMessage proto_msg;
+      proto_msg.mutable_function()->set_function(std::to_string(msg_idx));
+      ngraph::he::TCPMessage message(std::move(proto_msg));
+
+      data_buffer buffer;
+      message.pack(buffer);
+      decoder.push(std::move(buffer));
+    }
+    // Malformed messages are dropped too, rather than ending the worker
+    decoder.push(data_buffer(ngraph::he::TCPMessage::header_length + 4, 'x'));
+  }
+
+  // Messages after the failure are dropped
+  EXPECT_EQ(handled, (std::vector<std::string>{"0", "1", "2", "3", "4"}));
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_NE(errors[0].find("bad message"), std::string::npos);
+}
+
+TEST(protobuf, serialize_plaintext_doubles) {
+  // Plaintexts are sent as doubles, so values survive the round trip exactly
+  ngraph::he::HEPlaintext input{0.1, -1.0 / 3.0, 1e300, 2.5};
+  ngraph::he::pb::HEType proto_type;
+  ngraph::he::HEType(input, false).save(proto_type);
+  EXPECT_TRUE(proto_type.plain().empty());
+
+  auto loaded = ngraph::he::HEType::load(proto_type, nullptr);
+  ASSERT_TRUE(loaded.is_plaintext());
+  ASSERT_EQ(loaded.get_plaintext().size(), input.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(loaded.get_plaintext()[i], input[i]);
+  }
+
+  // Plaintexts serialized as floats are still loaded
+  ngraph::he::pb::HEType proto_float;
+  proto_float.set_is_plaintext(true);
+  proto_float.add_plain(2.5f);
+  auto loaded_float = ngraph::he::HEType::load(proto_float, nullptr);
+  ASSERT_TRUE(loaded_float.is_plaintext());
+  EXPECT_EQ(loaded_float.get_plaintext()[0], 2.5);
+}
+
+TEST(tcp_message, decode_ciphertexts) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  auto cipher = ngraph::he::HESealBackend::create_empty_ciphertext();
+  ngraph::he::encrypt(cipher, ngraph::he::HEPlaintext({1.5}),
+                      he_backend->get_context()->first_parms_id(),
+                      ngraph::element::f32, he_backend->get_scale(),
+                      *he_backend->get_ckks_encoder(),
+                      *he_backend->get_encryptor(), false);
+
+  ngraph::he::pb::TCPMessage proto_msg;
+  auto* proto_tensor = proto_msg.add_he_tensors();
+  ngraph::he::HEType(ngraph::he::HEPlaintext({2.5}), false)
+      .save(*proto_tensor->add_data());
+  ngraph::he::HEType(cipher, false, 1).save(*proto_tensor->add_data());
+
+  ngraph::he::TCPMessage message(std::move(proto_msg));
+  message.decode_ciphertexts(he_backend->get_context());
+
+  // Only the ciphertext is attached to the message
+  ASSERT_EQ(message.ciphertexts().size(), 1);
+  const auto& decoded_tensor = message.proto_message()->he_tensors(0);
+  EXPECT_FALSE(decoded_tensor.data(0).is_attached());
+  EXPECT_TRUE(decoded_tensor.data(1).is_attached());
+  EXPECT_EQ(decoded_tensor.data(1).attachment_index(), 0);
+  EXPECT_TRUE(decoded_tensor.data(1).ciphertext().empty());
+
+  auto loaded = ngraph::he::HEType::load(
+      decoded_tensor.data(1), he_backend->get_context(), message.ciphertexts());
+  ASSERT_TRUE(loaded.is_ciphertext());
+  ngraph::he::HEPlaintext plain;
+  ngraph::he::decrypt(plain, *loaded.get_ciphertext(), false,
+                      *he_backend->get_decryptor(),
+                      *he_backend->get_ckks_encoder());
+  EXPECT_NEAR(plain[0], 1.5, 1e-3);
+}
@@ -14,12 +14,22 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <cstdint>
+#include <cstdio>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "he_plaintext.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/seal.h"
+#include "seal/seal_ciphertext_codec.hpp"
+#include "seal/seal_ciphertext_pool.hpp"
+#include "seal/seal_ciphertext_slab.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_client_key_cache.hpp"
+#include "seal/seal_key_store.hpp"
 #include "seal/seal_util.hpp"
 #include "tcp/tcp_message.hpp"
 #include "util/all_close.hpp"
@@ -177,3 +187,379 @@ TEST(seal_util, save) {
   }
   ngraph::ngraph_free(buffer);
 }
+
+TEST(seal_util, encrypt_seeded) {
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 8192;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {60, 40, 40, 60}));
+  auto context = seal::SEALContext::Create(parms);
+
+  seal::KeyGenerator keygen(context);
+  seal::Encryptor encryptor(context, keygen.public_key(), keygen.secret_key());
+  seal::Decryptor decryptor(context, keygen.secret_key());
+  seal::CKKSEncoder encoder(context);
+
+  ngraph::he::HEPlaintext input{0.0, 1.1, 2.2, 3.3};
+  double scale = pow(2.0, 40);
+  auto cipher = std::make_shared<ngraph::he::SealCiphertextWrapper>();
+  auto seeded_cipher = std::make_shared<ngraph::he::SealCiphertextWrapper>();
+  ngraph::he::encrypt(cipher, input, context->first_parms_id(),
+                      ngraph::element::f64, scale, encoder, encryptor, false);
+  ngraph::he::encrypt(seeded_cipher, input, context->first_parms_id(),
+                      ngraph::element::f64, scale, encoder, encryptor, false,
+                      context);
+  EXPECT_FALSE(cipher->is_seeded());
+  EXPECT_TRUE(seeded_cipher->is_seeded());
+
+  ngraph::he::pb::HEType proto_cipher;
+  ngraph::he::pb::HEType proto_seeded_cipher;
+  cipher->save(proto_cipher);
+  seeded_cipher->save(proto_seeded_cipher);
+  EXPECT_FALSE(proto_cipher.is_seeded());
+  EXPECT_TRUE(proto_seeded_cipher.is_seeded());
+  EXPECT_LT(proto_seeded_cipher.ciphertext().size(),
+            proto_cipher.ciphertext().size() * 3 / 4);
+
+  ngraph::he::SealCiphertextWrapper loaded;
+  ngraph::he::SealCiphertextWrapper::load(loaded, proto_seeded_cipher,
+                                          context);
+  EXPECT_EQ(loaded.size(), 2U);
+  EXPECT_EQ(loaded.ciphertext().parms_id(), context->first_parms_id());
+
+  ngraph::he::HEPlaintext output;
+  ngraph::he::decrypt(output, loaded, false, decryptor, encoder);
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_NEAR(output[i], input[i], 1e-3);
+  }
+
+  // Modifying the ciphertext discards the seeded serialization
+  seeded_cipher->ciphertext();
+  EXPECT_FALSE(seeded_cipher->is_seeded());
+}
+
+TEST(seal_ciphertext_codec, save_load) {
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 8192;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {60, 40, 40, 60}));
+  auto context = seal::SEALContext::Create(parms);
+
+  seal::KeyGenerator keygen(context);
+  seal::Encryptor encryptor(context, keygen.public_key());
+  seal::Decryptor decryptor(context, keygen.secret_key());
+  seal::CKKSEncoder encoder(context);
+
+  ngraph::he::HEPlaintext input{0.0, 1.1, 2.2, 3.3};
+  double scale = pow(2.0, 40);
+  auto cipher = std::make_shared<ngraph::he::SealCiphertextWrapper>();
+  ngraph::he::encrypt(cipher, input, context->first_parms_id(),
+                      ngraph::element::f64, scale, encoder, encryptor, false);
+
+  ngraph::he::pb::HEType proto_none;
+  cipher->save(proto_none);
+  EXPECT_EQ(proto_none.codec(), ngraph::he::pb::HEType::NONE);
+
+  for (auto codec : ngraph::he::supported_ciphertext_codecs()) {
+    ngraph::he::pb::HEType proto_cipher;
+    cipher->save(proto_cipher, codec);
+    EXPECT_EQ(proto_cipher.codec(), codec);
+    if (codec == ngraph::he::pb::HEType::BIT_PACKED) {
+      // Limbs use at most 60, 40 and 40 of their 64 bits
+      EXPECT_LT(proto_cipher.ciphertext().size(),
+                proto_none.ciphertext().size() * 4 / 5);
+    }
+
+    ngraph::he::SealCiphertextWrapper loaded;
+    ngraph::he::SealCiphertextWrapper::load(loaded, proto_cipher, context);
+    EXPECT_EQ(loaded.ciphertext().parms_id(), context->first_parms_id());
+    EXPECT_EQ(loaded.scale(), scale);
+
+    ngraph::he::HEPlaintext output;
+    ngraph::he::decrypt(output, loaded, false, decryptor, encoder);
+    for (size_t i = 0; i < input.size(); ++i) {
+      EXPECT_NEAR(output[i], input[i], 1e-3);
+    }
+  }
+
+  // Truncated ciphertexts are rejected
+  ngraph::he::pb::HEType proto_cipher;
+  cipher->save(proto_cipher, ngraph::he::pb::HEType::BIT_PACKED);
+  proto_cipher.mutable_ciphertext()->resize(proto_cipher.ciphertext().size() /
+                                            2);
+  ngraph::he::SealCiphertextWrapper loaded;
+  EXPECT_ANY_THROW(ngraph::he::SealCiphertextWrapper::load(
+      loaded, proto_cipher, context));
+}
+
+TEST(seal_ciphertext_codec, negotiate) {
+  google::protobuf::RepeatedField<int> peer_codecs;
+  peer_codecs.Add(ngraph::he::pb::HEType::NONE);
+  EXPECT_EQ(ngraph::he::negotiate_ciphertext_codec(
+                ngraph::he::pb::HEType::BIT_PACKED, peer_codecs),
+            ngraph::he::pb::HEType::NONE);
+  peer_codecs.Add(ngraph::he::pb::HEType::BIT_PACKED);
+  EXPECT_EQ(ngraph::he::negotiate_ciphertext_codec(
+                ngraph::he::pb::HEType::BIT_PACKED, peer_codecs),
+            ngraph::he::pb::HEType::BIT_PACKED);
+
+  EXPECT_EQ(ngraph::he::ciphertext_codec_from_string("bit_packed"),
+            ngraph::he::pb::HEType::BIT_PACKED);
+  EXPECT_ANY_THROW(ngraph::he::ciphertext_codec_from_string("zstd"));
+}
+
+TEST(seal_ciphertext_pool, acquire_release) {
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {40, 30, 40}));
+  auto context = seal::SEALContext::Create(parms);
+  auto first_parms_id = context->first_parms_id();
+  auto last_parms_id = context->last_parms_id();
+
+  auto make_cipher = [&](seal::parms_id_type parms_id) {
+    seal::Ciphertext cipher(context, parms_id);
+    cipher.resize(2);
+    return ngraph::he::HEType(
+        std::make_shared<ngraph::he::SealCiphertextWrapper>(std::move(cipher)),
+        false, 1);
+  };
+  // Two polynomials with two coefficient moduli at the first level
+  size_t cipher_bytes = 2 * poly_modulus_degree * 2 * sizeof(std::uint64_t);
+
+  ngraph::he::SealCiphertextPool pool(3 * cipher_bytes);
+  std::vector<ngraph::he::HEType> freed{
+      make_cipher(first_parms_id), make_cipher(first_parms_id),
+      make_cipher(first_parms_id), make_cipher(first_parms_id),
+      ngraph::he::HEType(ngraph::he::HEPlaintext{1.0}, false),
+      ngraph::he::HEType(ngraph::he::HESealBackend::create_empty_ciphertext(),
+                         false, 1)};
+  auto shared_cipher = freed[0].get_ciphertext();
+
+  // Shared, empty and plaintext values are not pooled, nor values beyond the
+  // maximum size
+  EXPECT_EQ(pool.release(freed), 2);
+  EXPECT_EQ(pool.size(), 2);
+  EXPECT_EQ(pool.byte_count(), 2 * cipher_bytes);
+
+  std::vector<ngraph::he::HEType> outputs{
+      make_cipher(first_parms_id),
+      ngraph::he::HEType(ngraph::he::HEPlaintext{1.0}, false)};
+  auto* new_cipher = outputs[0].get_ciphertext().get();
+  EXPECT_EQ(pool.acquire(outputs, first_parms_id, 2, *context), 1);
+  EXPECT_NE(outputs[0].get_ciphertext().get(), new_cipher);
+  EXPECT_TRUE(outputs[1].is_plaintext());
+  EXPECT_EQ(pool.size(), 1);
+
+  // Ciphertexts at a higher level have the capacity for lower levels
+  std::vector<ngraph::he::HEType> lower_outputs{make_cipher(last_parms_id),
+                                                make_cipher(last_parms_id)};
+  EXPECT_EQ(pool.acquire(lower_outputs, last_parms_id, 2, *context), 1);
+  EXPECT_EQ(pool.size(), 0);
+  EXPECT_EQ(pool.byte_count(), 0);
+
+  // Pooled storage is reused when overwritten
+  auto& reused = lower_outputs[0].get_ciphertext()->ciphertext();
+  const std::uint64_t* reused_data = reused.data();
+  seal::Ciphertext result(context, last_parms_id);
+  result.resize(2);
+  reused = result;
+  EXPECT_EQ(reused.parms_id(), last_parms_id);
+  EXPECT_EQ(reused.data(), reused_data);
+
+  // Ciphertexts of other classes with enough capacity are used, even behind
+  // ones without
+  auto large_capacity = make_cipher(first_parms_id);
+  seal::Ciphertext lower(context, last_parms_id);
+  lower.resize(2);
+  large_capacity.get_ciphertext()->ciphertext() = lower;
+  std::vector<ngraph::he::HEType> lower_freed{large_capacity,
+                                              make_cipher(last_parms_id)};
+  large_capacity = ngraph::he::HEType(ngraph::he::HEPlaintext{1.0}, false);
+  EXPECT_EQ(pool.release(lower_freed), 2);
+  std::vector<ngraph::he::HEType> first_outputs{make_cipher(first_parms_id),
+                                                make_cipher(first_parms_id)};
+  EXPECT_EQ(pool.acquire(first_outputs, first_parms_id, 2, *context), 1);
+  EXPECT_EQ(pool.size(), 1);
+  pool.clear();
+
+  // Nothing is pooled if the maximum size is 0
+  ngraph::he::SealCiphertextPool disabled_pool(0);
+  std::vector<ngraph::he::HEType> unpooled{make_cipher(first_parms_id)};
+  EXPECT_EQ(disabled_pool.release(unpooled), 0);
+  EXPECT_EQ(disabled_pool.size(), 0);
+}
+
+TEST(seal_ciphertext_slab, allocate) {
+  seal::EncryptionParameters parms(seal::scheme_type::CKKS);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {40, 30, 40}));
+  auto context = seal::SEALContext::Create(parms);
+
+  seal::KeyGenerator keygen(context);
+  seal::Encryptor encryptor(context, keygen.public_key());
+  seal::Decryptor decryptor(context, keygen.secret_key());
+  seal::CKKSEncoder encoder(context);
+
+  // Room for two ciphertexts of two polynomials at the first level
+  size_t cipher_byte_count =
+      2 * poly_modulus_degree * 2 * sizeof(std::uint64_t);
+  auto slab =
+      std::make_shared<ngraph::he::SealCiphertextSlab>(cipher_byte_count, 2);
+  seal::MemoryPoolHandle slab_pool(slab);
+  EXPECT_EQ(slab->alloc_byte_count(), 2 * cipher_byte_count);
+  EXPECT_EQ(slab->free_count(), 2);
+
+  std::vector<double> input{0.5, 1.5, 2.5};
+  seal::Plaintext plain;
+  encoder.encode(input, pow(2.0, 30), plain);
+  {
+    std::vector<seal::Ciphertext> ciphers(3, seal::Ciphertext(slab_pool));
+    for (auto& cipher : ciphers) {
+      encryptor.encrypt(plain, cipher);
+    }
+    // Ciphertexts beyond the slab are allocated from the global memory pool
+    EXPECT_TRUE(slab->contains(ciphers[0].data()));
+    EXPECT_TRUE(slab->contains(ciphers[1].data()));
+    EXPECT_FALSE(slab->contains(ciphers[2].data()));
+    EXPECT_EQ(ciphers[1].data() - ciphers[0].data(),
+              static_cast<std::ptrdiff_t>(cipher_byte_count /
+                                          sizeof(std::uint64_t)));
+    EXPECT_EQ(slab->free_count(), 0);
+
+    seal::Plaintext decrypted;
+    std::vector<double> output;
+    decryptor.decrypt(ciphers[1], decrypted);
+    encoder.decode(decrypted, output);
+    for (size_t i = 0; i < input.size(); ++i) {
+      EXPECT_NEAR(output[i], input[i], 1e-3);
+    }
+  }
+  // Items are returned to the slab when the ciphertexts are destroyed
+  EXPECT_EQ(slab->free_count(), 2);
+
+  // Smaller ciphertexts, e.g. at lower levels, also use items of the slab
+  {
+    seal::Ciphertext lower(slab_pool);
+    lower.resize(context,
+                 context->first_context_data()->next_context_data()->parms_id(),
+                 2);
+    EXPECT_TRUE(slab->contains(lower.data()));
+    EXPECT_EQ(slab->free_count(), 1);
+  }
+  EXPECT_EQ(slab->free_count(), 2);
+}
+
+TEST(seal_key_store, save_load) {
+  auto parms =
+      ngraph::he::HESealEncryptionParameters::default_real_packing_parms();
+  auto context = seal::SEALContext::Create(
+      parms.seal_encryption_parameters(), true,
+      ngraph::he::seal_security_level(parms.security_level()));
+
+  seal::KeyGenerator keygen(context);
+  ngraph::he::SealKeys keys;
+  keys.secret_key = std::make_shared<seal::SecretKey>(keygen.secret_key());
+  keys.public_key = std::make_shared<seal::PublicKey>(keygen.public_key());
+  keys.relin_keys = std::make_shared<seal::RelinKeys>(keygen.relin_keys());
+  keys.galois_steps = {0, 1};
+  keys.galois_keys =
+      std::make_shared<seal::GaloisKeys>(keygen.galois_keys(keys.galois_steps));
+  keys.key_fingerprint = ngraph::he::client_key_fingerprint("pk", "rk", "g");
+
+  std::string path = testing::TempDir() + "seal_key_store_save_load";
+  ngraph::he::save_key_store(path, parms, keys);
+
+  ngraph::he::SealKeys loaded;
+  ASSERT_TRUE(ngraph::he::load_key_store(path, parms, context, loaded));
+  EXPECT_EQ(loaded.galois_steps, keys.galois_steps);
+  ASSERT_NE(loaded.galois_keys, nullptr);
+  EXPECT_EQ(loaded.galois_keys->size(), keys.galois_keys->size());
+  EXPECT_EQ(loaded.key_fingerprint, keys.key_fingerprint);
+
+  // Ciphertexts encrypted with the loaded public key decrypt with the
+  // original secret key
+  seal::Encryptor encryptor(context, *loaded.public_key);
+  seal::Decryptor decryptor(context, *keys.secret_key);
+  seal::Decryptor loaded_decryptor(context, *loaded.secret_key);
+  seal::CKKSEncoder encoder(context);
+  seal::Plaintext plain;
+  encoder.encode(std::vector<double>{1.5, -2}, parms.scale(), plain);
+  seal::Ciphertext cipher;
+  encryptor.encrypt(plain, cipher);
+
+  for (auto* dec : {&decryptor, &loaded_decryptor}) {
+    seal::Plaintext decrypted;
+    dec->decrypt(cipher, decrypted);
+    std::vector<double> values;
+    encoder.decode(decrypted, values);
+    EXPECT_NEAR(values[0], 1.5, 1e-3);
+    EXPECT_NEAR(values[1], -2, 1e-3);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(seal_key_store, fingerprint_mismatch) {
+  auto parms =
+      ngraph::he::HESealEncryptionParameters::default_real_packing_parms();
+  auto context = seal::SEALContext::Create(
+      parms.seal_encryption_parameters(), true,
+      ngraph::he::seal_security_level(parms.security_level()));
+
+  seal::KeyGenerator keygen(context);
+  ngraph::he::SealKeys keys;
+  keys.secret_key = std::make_shared<seal::SecretKey>(keygen.secret_key());
+  keys.public_key = std::make_shared<seal::PublicKey>(keygen.public_key());
+  keys.relin_keys = std::make_shared<seal::RelinKeys>(keygen.relin_keys());
+
+  std::string path = testing::TempDir() + "seal_key_store_mismatch";
+  ngraph::he::save_key_store(path, parms, keys);
+
+  // Keys are not loaded for different encryption parameters
+  auto other_parms = parms;
+  other_parms.scale() *= 2;
+  EXPECT_NE(ngraph::he::key_store_fingerprint(parms),
+            ngraph::he::key_store_fingerprint(other_parms));
+  ngraph::he::SealKeys loaded;
+  EXPECT_FALSE(ngraph::he::load_key_store(path, other_parms, context, loaded));
+  EXPECT_EQ(loaded.secret_key, nullptr);
+
+  // Nor from a missing file
+  std::remove(path.c_str());
+  EXPECT_FALSE(ngraph::he::load_key_store(path, parms, context, loaded));
+}
+
+TEST(seal_client_key_cache, evicts_least_recently_used) {
+  ngraph::he::SealClientKeyCache cache(2);
+  auto keys_a = std::make_shared<ngraph::he::SealClientKeys>();
+  auto keys_b = std::make_shared<ngraph::he::SealClientKeys>();
+  auto keys_c = std::make_shared<ngraph::he::SealClientKeys>();
+
+  cache.insert("a", keys_a);
+  cache.insert("b", keys_b);
+  EXPECT_EQ(cache.find("a"), keys_a);
+
+  // "b" is now the least recently used
+  cache.insert("c", keys_c);
+  EXPECT_EQ(cache.size(), 2U);
+  EXPECT_EQ(cache.find("b"), nullptr);
+  EXPECT_EQ(cache.find("a"), keys_a);
+  EXPECT_EQ(cache.find("c"), keys_c);
+
+  ngraph::he::SealClientKeyCache disabled_cache(0);
+  disabled_cache.insert("a", keys_a);
+  EXPECT_EQ(disabled_cache.find("a"), nullptr);
+}
+
+TEST(seal_client_key_cache, fingerprint) {
+  auto fingerprint = ngraph::he::client_key_fingerprint("pk", "rk", "");
+  EXPECT_EQ(fingerprint, ngraph::he::client_key_fingerprint("pk", "rk", ""));
+  EXPECT_NE(fingerprint, ngraph::he::client_key_fingerprint("pk", "rk", "g"));
+  // Key boundaries are part of the fingerprint
+  EXPECT_NE(fingerprint, ngraph::he::client_key_fingerprint("pkr", "k", ""));
+}
@@ -16,7 +16,10 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -27,6 +30,7 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_client.hpp"
 #include "seal/he_seal_executable.hpp"
+#include "seal/kernel/rescale_seal.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -731,6 +735,17 @@ NGRAPH_TEST(${BACKEND_NAME},
       false);
 }
 
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_max_pool_1d_1channel_1image_windows_in_flight) {
+  // Responses to earlier windows must arrive before later windows are sent
+  ngraph::test::he::ScopedEnv windows_env("MAX_POOL_WINDOWS_IN_FLIGHT", "5");
+  server_client_maxpool_test(
+      ngraph::Shape{1, 1, 14}, ngraph::Shape{3},
+      std::vector<float>{0, 1, 0, 2, 1, 0, 3, 2, 0, 0, 2, 0, 0, 0},
+      std::vector<float>{1, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 0}, true, false,
+      false);
+}
+
 NGRAPH_TEST(${BACKEND_NAME},
             server_client_max_pool_1d_1channel_2image_encrypted_real_packed) {
   server_client_maxpool_test(
@@ -868,3 +883,215 @@ NGRAPH_TEST(${BACKEND_NAME},
           .get_vector(),
       1e-3f));
 }
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_dot_streamed) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Dot is computed on the Relu results as they arrive
+  auto run = ngraph::test::he::run_relu_dot_server_client(
+      *he_backend, {{-1, 0.5, 2}}, {{"STREAM_RELU", "1"}});
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+
+  // Both fused ops have their own timer entry
+  size_t timed_ops = 0;
+  for (const auto& counter : run.handle->get_performance_data()) {
+    const std::string& description = counter.get_node()->description();
+    if (description == "Relu" || description == "Dot") {
+      EXPECT_EQ(counter.call_count(), 1U);
+      ++timed_ops;
+    }
+  }
+  EXPECT_EQ(timed_ops, 2U);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_zero_copy_tcp) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Both the server and the client send ciphertexts out-of-band
+  auto run = ngraph::test::he::run_relu_dot_server_client(
+      *he_backend, {{-1, 0.5, 2}}, {{"ZERO_COPY_TCP", "1"}});
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_multiple_clients) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Each client has its own keys and inputs
+  auto run = ngraph::test::he::run_relu_dot_server_client(
+      *he_backend, {{-1, 0.5, 2}, {1, -2, 3}}, {{"CLIENT_SESSIONS", "2"}});
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[1], std::vector<float>{16, 20}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_client_keys_only) {
+  std::shared_ptr<ngraph::runtime::Backend> backend;
+  {
+    // The server generates no keys of its own
+    ngraph::test::he::ScopedEnv keys_env("CLIENT_KEYS_ONLY", "1");
+    backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  }
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  EXPECT_EQ(he_backend->get_secret_key(), nullptr);
+  EXPECT_EQ(he_backend->get_decryptor(), nullptr);
+
+  auto run =
+      ngraph::test::he::run_relu_dot_server_client(*he_backend, {{-1, 0.5, 2}});
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_seeded_encryption) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape_a{1, 3};
+  std::vector<float> input_a{-1, 0.5, 2};
+  bool seeded_encryption = false;
+  auto run = ngraph::test::he::run_relu_dot_server_client(
+      *he_backend, {input_a}, {{"SEEDED_ENCRYPTION", "1"}},
+      [&](ngraph::he::HESealClient& he_client) {
+        seeded_encryption = he_client.seeded_encryption();
+      });
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_TRUE(seeded_encryption);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+
+  // Seeded encryption requires the secret key, as on the client
+  auto secret_key_encryptor = std::make_shared<seal::Encryptor>(
+      he_backend->get_context(), *he_backend->get_public_key(),
+      *he_backend->get_secret_key());
+  auto serialize = [&](bool seeded) {
+    auto tensor = std::make_shared<ngraph::he::HETensor>(
+        ngraph::element::f32, shape_a, false, false, true,
+        *he_backend->get_ckks_encoder(), he_backend->get_context(),
+        secret_key_encryptor, he_backend->get_decryptor(),
+        he_backend->get_encryption_parameters());
+    tensor->set_seeded_encryption(seeded);
+    copy_data(tensor, input_a);
+    std::vector<ngraph::he::pb::HETensor> protos;
+    tensor->write_to_protos(protos);
+    return std::make_pair(tensor, protos);
+  };
+  auto [seeded_tensor, seeded_protos] = serialize(true);
+  auto [full_tensor, full_protos] = serialize(false);
+  ASSERT_EQ(seeded_protos.size(), 1);
+  ASSERT_EQ(full_protos.size(), 1);
+  for (const auto& proto_he_type : seeded_protos[0].data()) {
+    EXPECT_TRUE(proto_he_type.is_seeded());
+  }
+  for (const auto& proto_he_type : full_protos[0].data()) {
+    EXPECT_FALSE(proto_he_type.is_seeded());
+  }
+  EXPECT_LT(seeded_protos[0].ByteSizeLong(),
+            full_protos[0].ByteSizeLong() * 3 / 4);
+
+  // Reading the ciphertext keeps the seeded form, but modifying it drops it
+  auto& cipher = seeded_tensor->data(0).get_ciphertext();
+  EXPECT_EQ(cipher->ciphertext().size(), 2);
+  EXPECT_TRUE(cipher->is_seeded());
+  ngraph::he::rescale_seal(seeded_tensor->data(), *he_backend, false);
+  EXPECT_FALSE(cipher->is_seeded());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_bit_packed) {
+  // Both the server and the client prefer the bit-packed codec
+  ngraph::test::he::ScopedEnv codec_env("CIPHERTEXT_CODEC", "bit_packed");
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::he::CiphertextCodec client_codec = ngraph::he::pb::HEType::NONE;
+  auto run = ngraph::test::he::run_relu_dot_server_client(
+      *he_backend, {{-1, 0.5, 2}}, {},
+      [&](ngraph::he::HESealClient& he_client) {
+        client_codec = he_client.ciphertext_codec();
+      });
+  EXPECT_TRUE(run.call_succeeded);
+  EXPECT_EQ(client_codec, ngraph::he::pb::HEType::BIT_PACKED);
+  EXPECT_EQ(run.handle->ciphertext_codec(),
+            ngraph::he::pb::HEType::BIT_PACKED);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      run.results[0], std::vector<float>{11.5, 14}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_resume_session) {
+  auto backend = ngraph::runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  std::string error_str;
+  he_backend->set_config(
+      std::map<std::string, std::string>{{"enable_client", "true"}}, error_str);
+
+  size_t batch_size = 1;
+
+  ngraph::Shape shape_a{batch_size, 3};
+  ngraph::Shape shape_b{3, 2};
+  ngraph::Shape shape_r{batch_size, 2};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32,
+                                                   shape_a);
+  auto b = ngraph::op::Constant::create(ngraph::element::f32, shape_b,
+                                        {1, 2, 3, 4, 5, 6});
+  auto relu = std::make_shared<ngraph::op::Relu>(a);
+  auto t = std::make_shared<ngraph::op::Dot>(relu, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  a->set_op_annotations(
+      ngraph::he::HEOpAnnotations::client_ciphertext_unpacked_annotation());
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(ngraph::element::f32, shape_a);
+  auto t_result =
+      he_backend->create_cipher_tensor(ngraph::element::f32, shape_r);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>(shape_size(shape_a), dummy_float));
+
+  // The same client connects twice, reusing its keys from the key store. The
+  // first session uploads the keys, and the second resumes with them
+  std::string key_store = testing::TempDir() + "resume_session_client_keys";
+  std::remove(key_store.c_str());
+  ngraph::test::he::ScopedEnv key_cache_env("NGRAPH_HE_CLIENT_KEY_CACHE",
+                                            key_store.c_str());
+  ngraph::test::he::ScopedEnv resume_env("RESUME_SESSION", "1");
+  ngraph::test::he::ScopedEnv sessions_env("CLIENT_SESSIONS", "2");
+  // The second client only connects once the first has its results
+  ngraph::test::he::ScopedEnv idle_env("CLIENT_SESSION_IDLE_MS", "30000");
+  std::vector<std::vector<float>> inputs{{-1, 0.5, 2}, {1, -2, 3}};
+  std::vector<std::vector<float>> results(inputs.size());
+  auto client_thread = std::thread([&]() {
+    for (size_t client_idx = 0; client_idx < inputs.size(); ++client_idx) {
+      auto he_client = ngraph::he::HESealClient(
+          "localhost", 34000, batch_size,
+          ngraph::he::HETensorConfigMap<float>{
+              {a->get_name(), make_pair("encrypt", inputs[client_idx])}});
+
+      auto double_results = he_client.get_results();
+      results[client_idx] =
+          std::vector<float>(double_results.begin(), double_results.end());
+    }
+  });
+
+  auto handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend->compile(f));
+  EXPECT_TRUE(handle->call_with_validate({t_result}, {t_dummy}));
+
+  client_thread.join();
+  std::remove(key_store.c_str());
+
+  EXPECT_EQ(he_backend->client_key_cache().size(), 1U);
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      results[0], std::vector<float>{11.5, 14}, 1e-3f));
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      results[1], std::vector<float>{16, 20}, 1e-3f));
+}
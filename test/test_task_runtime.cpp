@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2018-2019 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "task_runtime.hpp"
+
+TEST(task_runtime, runs_every_iteration_once) {
+  ngraph::he::TaskRuntime runtime(4);
+  EXPECT_EQ(runtime.thread_count(), 4);
+
+  for (size_t grain : {1, 3, 64, 1000}) {
+    std::vector<std::atomic<size_t>> hits(257);
+    runtime.parallel_for(
+        5, hits.size(),
+        [&](size_t range_begin, size_t range_end) {
+          EXPECT_LE(range_end - range_begin, grain);
+          for (size_t i = range_begin; i < range_end; ++i) {
+            ++hits[i];
+          }
+        },
+        grain);
+    for (size_t i = 0; i < hits.size(); ++i) {
+      EXPECT_EQ(hits[i], i < 5 ? 0 : 1);
+    }
+  }
+
+  // Empty loops return immediately
+  runtime.parallel_for(3, 3, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(task_runtime, balances_uneven_work) {
+  ngraph::he::TaskRuntime runtime(4);
+  std::mutex mutex;
+  std::set<std::thread::id> slow_thread_ids;
+  // The first range holds all the slow iterations, which the other threads
+  // steal once their own ranges are done
+  runtime.parallel_for(0, 64, [&](size_t range_begin, size_t range_end) {
+    for (size_t i = range_begin; i < range_end; ++i) {
+      if (i < 16) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::lock_guard<std::mutex> guard(mutex);
+        slow_thread_ids.insert(std::this_thread::get_id());
+      }
+    }
+  });
+  EXPECT_GT(slow_thread_ids.size(), 1);
+  EXPECT_LE(slow_thread_ids.size(), 4);
+}
+
+TEST(task_runtime, nested_loops) {
+  std::vector<std::atomic<size_t>> hits(32 * 16);
+  ngraph::he::parallel_for(0, 32, [&](size_t outer) {
+    ngraph::he::parallel_for(0, 16,
+                             [&](size_t inner) { ++hits[outer * 16 + inner]; });
+  });
+  for (const auto& hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+}
+
+TEST(task_runtime, parallel_reduce) {
+  size_t sum = ngraph::he::parallel_reduce(
+      0, 1000, size_t(0),
+      [](size_t range_begin, size_t range_end, size_t partial) {
+        for (size_t i = range_begin; i < range_end; ++i) {
+          partial += i;
+        }
+        return partial;
+      },
+      [](size_t lhs, size_t rhs) { return lhs + rhs; }, 7);
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+}
+
+TEST(task_runtime, rethrows_exception) {
+  std::atomic<size_t> run_count{0};
+  EXPECT_THROW(ngraph::he::parallel_for(0, 100,
+                                        [&](size_t i) {
+                                          ++run_count;
+                                          if (i == 10) {
+                                            throw std::runtime_error("fail");
+                                          }
+                                        }),
+               std::runtime_error);
+  EXPECT_GE(run_count, 1);
+
+  // The runtime is still usable
+  std::atomic<size_t> hits{0};
+  ngraph::he::parallel_for(0, 100, [&](size_t) { ++hits; });
+  EXPECT_EQ(hits, 100);
+}
+
+TEST(task_runtime, thread_budget) {
+  ngraph::he::TaskRuntime runtime(4);
+  EXPECT_EQ(ngraph::he::TaskRuntime::thread_budget(), 0);
+  {
+    ngraph::he::TaskRuntime::ThreadBudgetScope budget_scope(1);
+    EXPECT_EQ(ngraph::he::TaskRuntime::thread_budget(), 1);
+    EXPECT_EQ(runtime.default_grain(40), 10);
+
+    // A budget of one thread runs the loop on the calling thread
+    std::thread::id caller_id = std::this_thread::get_id();
+    runtime.parallel_for(0, 100, [&](size_t, size_t) {
+      EXPECT_EQ(std::this_thread::get_id(), caller_id);
+    });
+  }
+  EXPECT_EQ(ngraph::he::TaskRuntime::thread_budget(), 0);
+  EXPECT_EQ(runtime.default_grain(40), 2);
+  EXPECT_EQ(runtime.default_grain(3), 1);
+}
@@ -23,6 +23,8 @@
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_executable.hpp"
 #include "test_util.hpp"
+#include "util.hpp"
+#include "util/all_close.hpp"
 #include "util/test_tools.hpp"
 
 TEST(he_tensor, pack) {
@@ -86,6 +88,52 @@ TEST(he_tensor, unpack) {
   EXPECT_EQ(plain.data(3).get_plaintext()[0], 3);
 }
 
+TEST(he_tensor, image_packing) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{1, 2, 2, 3};
+  auto tensor = std::static_pointer_cast<ngraph::he::HETensor>(
+      he_backend->create_cipher_tensor(ngraph::element::f32, shape));
+  tensor->use_image_packing(4);
+
+  EXPECT_TRUE(tensor->is_image_packed());
+  EXPECT_EQ(tensor->image_row_stride(), 4);
+  EXPECT_EQ(tensor->get_packed_shape(), (ngraph::Shape{1, 2, 1, 1}));
+  EXPECT_EQ(tensor->get_batched_element_count(), 2);
+
+  std::vector<float> tensor_data{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  copy_data(tensor, tensor_data);
+  ASSERT_EQ(tensor->data().size(), 2);
+  EXPECT_TRUE(tensor->done_loading());
+
+  // Element (1, 0) of the second channel is stored in slot 4
+  ngraph::he::HEPlaintext plain;
+  he_backend->decrypt(plain, *tensor->data(1).get_ciphertext(), false);
+  EXPECT_NEAR(plain[4], 10, 1e-3);
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<float>(tensor),
+                                          tensor_data, 1e-3f));
+
+  std::vector<ngraph::he::pb::HETensor> protos;
+  tensor->write_to_protos(protos);
+  ASSERT_EQ(protos.size(), 1);
+  EXPECT_EQ(protos[0].image_row_stride(), 4);
+  auto loaded = ngraph::he::HETensor::load_from_proto_tensors(
+      protos, *he_backend->get_ckks_encoder(), he_backend->get_context(),
+      he_backend->get_encryptor(), he_backend->get_decryptor(),
+      he_backend->get_encryption_parameters());
+  EXPECT_TRUE(loaded->is_image_packed());
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<double>(loaded),
+      std::vector<double>(tensor_data.begin(), tensor_data.end()), 1e-3));
+
+  // Only batch-1 images are image packed
+  auto batch = std::static_pointer_cast<ngraph::he::HETensor>(
+      he_backend->create_cipher_tensor(ngraph::element::f32,
+                                       ngraph::Shape{2, 2, 2, 3}));
+  EXPECT_ANY_THROW(batch->use_image_packing(4));
+}
+
 TEST(he_tensor, save) {
   auto backend = ngraph::runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
@@ -119,9 +167,186 @@ TEST(he_tensor, save) {
   for (size_t i = 0; i < he_tensor->data().size(); ++i) {
     EXPECT_TRUE(proto.data(i).is_plaintext());
 
-    std::vector<float> plain = {proto.data(i).plain().begin(),
-                                proto.data(i).plain().end()};
+    std::vector<double> plain;
+    ngraph::he::unpack_doubles(plain, proto.data(i).packed_plain());
     EXPECT_EQ(plain.size(), 1);
     EXPECT_FLOAT_EQ(plain[0], tensor_data[i]);
   }
 }
+
+TEST(he_tensor, save_load_chunks) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+  auto parms =
+      ngraph::he::HESealEncryptionParameters::default_real_packing_parms();
+  he_backend->update_encryption_parameters(parms);
+
+  ngraph::Shape shape{2, 3};
+
+  auto tensor = he_backend->create_cipher_tensor(ngraph::element::f32, shape);
+  std::vector<float> tensor_data({1, 2, 3, 4, 5, 6});
+  copy_data(tensor, tensor_data);
+  auto he_tensor = std::static_pointer_cast<ngraph::he::HETensor>(tensor);
+
+  // Bound the chunk size, such that each chunk stores one ciphertext
+  std::vector<ngraph::he::pb::HETensor> protos;
+  he_tensor->write_to_protos(protos, 1);
+
+  size_t data_size = he_tensor->data().size();
+  EXPECT_EQ(protos.size(), data_size);
+  for (size_t chunk_idx = 0; chunk_idx < protos.size(); ++chunk_idx) {
+    EXPECT_EQ(protos[chunk_idx].chunk_index(), chunk_idx);
+    EXPECT_EQ(protos[chunk_idx].chunk_count(), data_size);
+    EXPECT_EQ(protos[chunk_idx].offset(), chunk_idx);
+    EXPECT_EQ(protos[chunk_idx].data_size(), 1);
+  }
+
+  // Load the chunks in reverse order
+  std::vector<ngraph::he::pb::HETensor> reversed_protos(protos.rbegin(),
+                                                        protos.rend());
+  auto loaded = ngraph::he::HETensor::load_from_proto_tensors(
+      reversed_protos, *he_backend->get_ckks_encoder(),
+      he_backend->get_context(), he_backend->get_encryptor(),
+      he_backend->get_decryptor(), he_backend->get_encryption_parameters());
+  EXPECT_TRUE(loaded->done_loading());
+  EXPECT_TRUE(ngraph::test::he::all_close(
+      read_vector<double>(loaded),
+      std::vector<double>(tensor_data.begin(), tensor_data.end()), 1e-3));
+
+  // Chunks are loaded on their own
+  auto chunk = ngraph::he::HETensor::load_proto_chunk(
+      protos[1], he_backend->get_context());
+  ASSERT_EQ(chunk.size(), 1);
+  EXPECT_TRUE(chunk[0].is_ciphertext());
+
+  // Chunks beyond the tensor are rejected
+  protos[0].set_offset(data_size);
+  EXPECT_ANY_THROW(ngraph::he::HETensor::load_from_proto_tensor(
+      loaded, protos[0], he_backend->get_context()));
+}
+
+TEST(he_tensor, load_unchunked_protos) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  // Protos written without chunking have no chunk index or count
+  ngraph::Shape shape{2};
+  auto tensor = he_backend->create_plain_tensor(ngraph::element::f32, shape);
+  copy_data(tensor, std::vector<float>{1, 2});
+  std::vector<ngraph::he::pb::HETensor> protos;
+  std::static_pointer_cast<ngraph::he::HETensor>(tensor)->write_to_protos(
+      protos);
+  ASSERT_EQ(protos.size(), 1);
+  protos[0].clear_chunk_index();
+  protos[0].clear_chunk_count();
+
+  auto loaded = ngraph::he::HETensor::load_from_proto_tensors(
+      protos, *he_backend->get_ckks_encoder(), he_backend->get_context(),
+      he_backend->get_encryptor(), he_backend->get_decryptor(),
+      he_backend->get_encryption_parameters());
+  EXPECT_TRUE(loaded->done_loading());
+  EXPECT_TRUE(ngraph::test::he::all_close(read_vector<double>(loaded),
+                                          std::vector<double>{1, 2}, 1e-3));
+
+  // Empty tensors are written as a single empty chunk
+  auto empty = he_backend->create_cipher_tensor(ngraph::element::f32,
+                                                ngraph::Shape{0, 3});
+  std::static_pointer_cast<ngraph::he::HETensor>(empty)->write_to_protos(
+      protos);
+  ASSERT_EQ(protos.size(), 1);
+  protos[0].clear_chunk_index();
+  protos[0].clear_chunk_count();
+  auto loaded_empty = ngraph::he::HETensor::load_from_proto_tensors(
+      protos, *he_backend->get_ckks_encoder(), he_backend->get_context(),
+      he_backend->get_encryptor(), he_backend->get_decryptor(),
+      he_backend->get_encryption_parameters());
+  EXPECT_TRUE(loaded_empty->done_loading());
+  EXPECT_TRUE(loaded_empty->data().empty());
+}
+
+TEST(he_tensor, view) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{4};
+  auto source = std::make_shared<ngraph::he::HETensor>(
+      ngraph::element::f32, shape, false, false, false, *he_backend);
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    source->data(i).set_plaintext(
+        ngraph::he::HEPlaintext({static_cast<double>(i)}));
+  }
+
+  // Reverses the source
+  auto reverse_plan =
+      std::make_shared<ngraph::he::IndexPlan>(std::vector{shape}, shape);
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    reverse_plan->add_entry(shape_size(shape) - 1 - i);
+    reverse_plan->end_output();
+  }
+  auto reversed = std::make_shared<ngraph::he::HETensor>(
+      std::vector{source}, reverse_plan, ngraph::element::f32, shape,
+      "reversed");
+  EXPECT_TRUE(reversed->is_view());
+
+  // Takes the first two elements of the reversed source
+  ngraph::Shape slice_shape{2};
+  auto slice_plan =
+      std::make_shared<ngraph::he::IndexPlan>(std::vector{shape}, slice_shape);
+  for (size_t i = 0; i < shape_size(slice_shape); ++i) {
+    slice_plan->add_entry(i);
+    slice_plan->end_output();
+  }
+  auto sliced = std::make_shared<ngraph::he::HETensor>(
+      std::vector{reversed}, slice_plan, ngraph::element::f32, slice_shape,
+      "sliced");
+  EXPECT_TRUE(sliced->is_view());
+
+  // Views of views gather from the underlying tensor, without materializing
+  // the intermediate view
+  EXPECT_EQ(sliced->data().size(), 2);
+  EXPECT_FALSE(sliced->is_view());
+  EXPECT_TRUE(reversed->is_view());
+  EXPECT_EQ(sliced->data(0).get_plaintext()[0], 3);
+  EXPECT_EQ(sliced->data(1).get_plaintext()[0], 2);
+
+  EXPECT_EQ(reversed->data().size(), 4);
+  EXPECT_FALSE(reversed->is_view());
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    EXPECT_EQ(reversed->data(i).get_plaintext()[0], static_cast<double>(3 - i));
+  }
+}
+
+TEST(he_tensor, view_of_several_tensors) {
+  auto backend = ngraph::runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<ngraph::he::HESealBackend*>(backend.get());
+
+  ngraph::Shape shape{2};
+  std::vector<std::shared_ptr<ngraph::he::HETensor>> sources;
+  for (size_t source_idx = 0; source_idx < 2; ++source_idx) {
+    sources.emplace_back(std::make_shared<ngraph::he::HETensor>(
+        ngraph::element::f32, shape, false, false, false, *he_backend));
+    for (size_t i = 0; i < shape_size(shape); ++i) {
+      sources.back()->data(i).set_plaintext(ngraph::he::HEPlaintext(
+          {static_cast<double>(10 * source_idx + i)}));
+    }
+  }
+
+  // Interleaves the sources
+  ngraph::Shape out_shape{4};
+  auto plan = std::make_shared<ngraph::he::IndexPlan>(
+      std::vector{shape, shape}, out_shape);
+  for (size_t i = 0; i < shape_size(out_shape); ++i) {
+    plan->add_gather_entry(i / 2, i % 2);
+    plan->end_output();
+  }
+  ngraph::he::HETensor view(sources, plan, ngraph::element::f32, out_shape,
+                            "view");
+  EXPECT_TRUE(view.is_view());
+
+  std::vector<double> values;
+  for (const auto& he_type : view.data()) {
+    values.emplace_back(he_type.get_plaintext()[0]);
+  }
+  EXPECT_EQ(values, (std::vector<double>{0, 10, 1, 11}));
+  EXPECT_FALSE(view.is_view());
+}
@@ -17,7 +17,12 @@
 #pragma once
 
 #include <complex>
+#include <cstdlib>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "he_op_annotations.hpp"
@@ -25,10 +30,13 @@
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/descriptor/layout/tensor_layout.hpp"
 #include "ngraph/file_util.hpp"
+#include "ngraph/ngraph.hpp"
 #include "ngraph/node.hpp"
 #include "ngraph/runtime/tensor.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_client.hpp"
+#include "seal/he_seal_executable.hpp"
 
 namespace ngraph {
 namespace test {
@@ -97,6 +105,155 @@ inline std::shared_ptr<ngraph::runtime::Tensor> tensor_from_flags(
   throw ngraph_error("Logic error");
 };
 
+/// \brief Sets an environment variable, and restores its previous value when
+/// the scope exits, even if a test assertion fails
+class ScopedEnv {
+ public:
+  ScopedEnv(const char* name, const char* value) : m_name(name) {
+    const char* previous = std::getenv(name);
+    if (previous != nullptr) {
+      m_previous = previous;
+      m_was_set = true;
+    }
+    setenv(name, value, 1);
+  }
+
+  ScopedEnv(const ScopedEnv&) = delete;
+  ScopedEnv& operator=(const ScopedEnv&) = delete;
+
+  ~ScopedEnv() {
+    if (m_was_set) {
+      setenv(m_name.c_str(), m_previous.c_str(), 1);
+    } else {
+      unsetenv(m_name.c_str());
+    }
+  }
+
+ private:
+  std::string m_name;
+  std::string m_previous;
+  bool m_was_set{false};
+};
+
+/// \brief Environment variables, as name / value pairs
+using EnvSettings = std::vector<std::pair<std::string, std::string>>;
+
+/// \brief Outcome of run_relu_dot_server_client
+struct ServerClientRun {
+  std::shared_ptr<ngraph::he::HESealExecutable> handle;
+  bool call_succeeded{false};
+  /// \brief Results decrypted by each client, in the order of the inputs
+  std::vector<std::vector<float>> results;
+};
+
+/// \brief Serves Dot(Relu(a), b), with b = {{1, 2}, {3, 4}, {5, 6}}, to one
+/// client per input, each encrypting its {1, 3} input a. Clients connect
+/// concurrently on port 34000
+/// \param[in] he_backend Backend compiling and calling the function. The
+/// client is enabled on it
+/// \param[in] inputs Input of each client
+/// \param[in] env Environment variables set on both the server and the
+/// clients until the run finishes
+/// \param[in] inspect_client Called with each client once it has its
+/// results, concurrently for concurrent clients
+inline ServerClientRun run_relu_dot_server_client(
+    ngraph::he::HESealBackend& he_backend,
+    const std::vector<std::vector<float>>& inputs, const EnvSettings& env = {},
+    const std::function<void(ngraph::he::HESealClient&)>& inspect_client =
+        nullptr) {
+  std::vector<std::unique_ptr<ScopedEnv>> scoped_env;
+  for (const auto& setting : env) {
+    scoped_env.emplace_back(
+        new ScopedEnv(setting.first.c_str(), setting.second.c_str()));
+  }
+
+  std::string error_str;
+  he_backend.set_config(
+      std::map<std::string, std::string>{{"enable_client", "true"}}, error_str);
+
+  size_t batch_size = 1;
+
+  ngraph::Shape shape_a{batch_size, 3};
+  ngraph::Shape shape_b{3, 2};
+  ngraph::Shape shape_r{batch_size, 2};
+  auto a = std::make_shared<ngraph::op::Parameter>(ngraph::element::f32,
+                                                   shape_a);
+  auto b = ngraph::op::Constant::create(ngraph::element::f32, shape_b,
+                                        {1, 2, 3, 4, 5, 6});
+  auto relu = std::make_shared<ngraph::op::Relu>(a);
+  auto t = std::make_shared<ngraph::op::Dot>(relu, b);
+  auto f = std::make_shared<ngraph::Function>(t, ngraph::ParameterVector{a});
+
+  a->set_op_annotations(
+      ngraph::he::HEOpAnnotations::client_ciphertext_unpacked_annotation());
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend.create_plain_tensor(ngraph::element::f32, shape_a);
+  auto t_result =
+      he_backend.create_cipher_tensor(ngraph::element::f32, shape_r);
+
+  std::vector<float> dummy_input(shape_size(shape_a), 99);
+  t_dummy->write(dummy_input.data(), dummy_input.size() * sizeof(float));
+
+  ServerClientRun run;
+  run.results.resize(inputs.size());
+  std::vector<std::thread> client_threads;
+  for (size_t client_idx = 0; client_idx < inputs.size(); ++client_idx) {
+    client_threads.emplace_back([&, client_idx]() {
+      auto he_client = ngraph::he::HESealClient(
+          "localhost", 34000, batch_size,
+          ngraph::he::HETensorConfigMap<float>{
+              {a->get_name(), make_pair("encrypt", inputs[client_idx])}});
+
+      auto double_results = he_client.get_results();
+      run.results[client_idx] =
+          std::vector<float>(double_results.begin(), double_results.end());
+      if (inspect_client) {
+        inspect_client(he_client);
+      }
+    });
+  }
+
+  run.handle = std::static_pointer_cast<ngraph::he::HESealExecutable>(
+      he_backend.compile(f));
+  run.call_succeeded = run.handle->call_with_validate({t_result}, {t_dummy});
+
+  for (auto& client_thread : client_threads) {
+    client_thread.join();
+  }
+  return run;
+}
+
+/// \brief Switches every other ciphertext in the tensor down to the next
+/// level, so kernels see arguments at mixed levels
+inline void mod_switch_alternate_ciphertexts(
+    ngraph::runtime::Tensor& tensor,
+    const ngraph::he::HESealBackend& he_seal_backend) {
+  auto& he_tensor = dynamic_cast<ngraph::he::HETensor&>(tensor);
+  for (size_t i = 0; i < he_tensor.data().size(); i += 2) {
+    auto& he_type = he_tensor.data(i);
+    if (he_type.is_ciphertext()) {
+      auto& cipher = he_type.get_ciphertext();
+      cipher->clear_seeded();
+      he_seal_backend.get_evaluator()->mod_switch_to_next_inplace(
+          cipher->ciphertext());
+    }
+  }
+}
+
+/// \brief Returns true if every ciphertext in the tensor is relinearized,
+/// i.e. has size 2
+inline bool all_ciphertexts_relinearized(
+    const ngraph::runtime::Tensor& tensor) {
+  const auto& he_tensor = dynamic_cast<const ngraph::he::HETensor&>(tensor);
+  for (const auto& he_type : he_tensor.data()) {
+    if (he_type.is_ciphertext() && he_type.get_ciphertext()->size() != 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace he
 }  // namespace test
 }  // namespace ngraph